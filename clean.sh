@@ -20,4 +20,7 @@ fi
 # Remove object files
 find src -name "*.o" -delete 2>/dev/null || true
 
+# Remove mesh caches and baked textures (regenerated on the next run)
+rm -f modelos/*.mesh texturas/*.ktx
+
 echo -e "${GREEN}Clean complete!${NC}"
@@ -0,0 +1,42 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <exception>
+
+// ============================================================================
+// CARREGAMENTO PARALELO DE RECURSOS
+// ============================================================================
+// Cada recurso é uma tarefa em duas partes: 'work' (decodificar a imagem,
+// ler o .obj ou o seu cache...) roda num pool de threads e não pode chamar
+// o OpenGL; 'upload' roda na thread que chamou run(), dona do contexto GL,
+// na ordem em que as partes 'work' terminam. Com núcleos suficientes, o
+// tempo total fica perto do recurso mais caro em vez da soma de todos.
+//
+// Uma exceção lançada em 'work' cancela só o upload daquela tarefa; run()
+// a relança depois que todas as outras terminaram.
+// ============================================================================
+class AssetLoader
+{
+public:
+    void add(const std::string& name, const std::function<void()>& work, const std::function<void()>& upload);
+
+    // Bloqueia até todas as tarefas terminarem; threads < 1 usa uma só
+    void run(int threads);
+
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> work;
+        std::function<void()> upload;
+        std::exception_ptr error;
+        double workMs;
+    };
+
+    std::vector<Task> m_tasks;
+};
+
+#endif
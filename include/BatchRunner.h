@@ -0,0 +1,31 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <cstdint>
+
+// Executa várias arenas headless independentes (cada uma um Game com seu
+// próprio Player, EnemyManager, ProjectileManager e dragão) em paralelo,
+// em um pool de threads, e mede a vazão agregada em ticks/segundo.
+class BatchRunner
+{
+public:
+    // A arena i usa a semente baseSeed + i
+    BatchRunner(int arenas, long long ticksPerArena, int difficulty, float tickRate, uint64_t baseSeed);
+
+    // Roda o lote com 1, 2, 4, ... até maxThreads threads e imprime
+    // ticks/segundo, speedup e eficiência de cada configuração
+    void run(int maxThreads);
+
+private:
+    // Retorna o tempo de parede (segundos) para simular todas as arenas e,
+    // em stateHash, a combinação dos hashes de estado de todas elas
+    double runWithThreads(int threads, uint64_t& stateHash);
+
+    int m_arenas;
+    long long m_ticksPerArena;
+    int m_difficulty;
+    float m_tickRate;
+    uint64_t m_baseSeed;
+};
+
+#endif
@@ -2,18 +2,21 @@
 #define ENEMY_H
 
 #include <vector>
+#include <cstdint>
 #include <glm/vec4.hpp>
 
 class Player;
+class Random;
+class Sfx;
 
+// Entidade isolada e parada (o dragão): posição, vida e orientação.
+// Os inimigos comuns ficam no EnemyManager, em estrutura de arrays.
 class Enemy
 {
 public:
     Enemy(float x, float z, int vida = 100);
     ~Enemy();
 
-    void update(float deltaTime, const Player& player);
-
     float lookAt(const glm::vec4& targetPosition) const;
 
     void takeDamage(int damage);
@@ -23,71 +26,143 @@ public:
     float getZ() const { return m_z; }
     int getVida() const { return m_vida; }
     glm::vec4 getPosition() const { return glm::vec4(m_x, 0.101f, m_z, 1.0f); }
+    // Posição interpolada entre o tick anterior e o atual (alpha em [0,1])
+    glm::vec4 getInterpolatedPosition(float alpha) const;
+    void storePreviousState() { m_previousX = m_x; m_previousZ = m_z; }
     void setPosition(float x, float z) { m_x = x; m_z = z; }
-    void applyKnockback(float dirX, float dirZ, float force);
-
-    // chama apos a colisão para recalcular a curva de bezier 
-    void onObstacleCollision();
-
-    bool isDying() const { return m_dying; }
-    float getDeathProgress() const;
-    float getDeathScale() const;
-    void startDying();
-    bool isReadyForRemoval() const;
+    void setSfx(Sfx* sfx) { m_sfx = sfx; }
 
 private:
     float m_x;
     float m_z;
+    float m_previousX;
+    float m_previousZ;
     int m_vida;
-    float m_enemySpeed;
-    float m_knockbackVelX;
-    float m_knockbackVelZ;
-
-    glm::vec4 m_bezierP0;       
-    glm::vec4 m_bezierP1;      
-    glm::vec4 m_bezierP2;      
-    glm::vec4 m_bezierP3;       
-    float m_bezierT;             
-    float m_curveRecalcTimer;    
-    bool m_curveInitialized;
-    void recalculateCurve(const glm::vec4& playerPos);
-    glm::vec4 evaluateBezier(float t) const;
-    glm::vec4 evaluateBezierDerivative(float t) const;
-
-    bool m_dying;
-    float m_deathTimer;
-    static constexpr float DEATH_ANIM_DURATION = 0.35f;
+
+    Sfx* m_sfx;
+};
+
+// Referência estável a um inimigo do EnemyManager. O índice de um inimigo
+// muda quando outro é removido; o handle não. Quando o inimigo é removido a
+// geração do slot avança, e handles antigos passam a não resolver mais.
+struct EnemyHandle
+{
+    uint32_t slot;
+    uint32_t generation; // 0 nunca é uma geração válida
+
+    EnemyHandle() : slot(0), generation(0) {}
+    EnemyHandle(uint32_t s, uint32_t g) : slot(s), generation(g) {}
 };
 
+// ============================================================================
+// INIMIGOS EM ESTRUTURA DE ARRAYS (SoA)
+// ============================================================================
+// Cada campo de inimigo fica num array próprio, indexado pelo inimigo:
+// posição x/z, pontos de controle P0..P3 (componentes x e z), t da curva,
+// velocidade, vida etc. O passo mais caro do update, avaliar a Bézier de
+// todos os inimigos, percorre só os arrays de que precisa, em sequência, e é
+// feito de 4 em 4 (SSE2) ou 8 em 8 (AVX) inimigos.
+//
+// O acesso de fora é pelo índice do inimigo, em [0, getEnemyCount()). Os
+// arrays são densos: removeDeadEnemies() troca o inimigo removido pelo
+// último (O(1)), então índices só valem dentro de um tick. Para guardar
+// uma referência entre ticks usa-se um EnemyHandle (getHandle / findEnemy).
+// ============================================================================
 class EnemyManager
 {
 public:
     EnemyManager();
     ~EnemyManager();
 
-    void update(float deltaTime, const Player& player);
+    void update(float deltaTime, const Player& player, Random& random);
+    void storePreviousState();
 
-    void spawnEnemy(const glm::vec4& playerPosition);
-    void trySpawnEnemy(int currentSecond, const glm::vec4& playerPosition);
+    void spawnEnemy(const glm::vec4& playerPosition, Random& random);
+    void trySpawnEnemy(int currentSecond, const glm::vec4& playerPosition, Random& random);
 
     void removeDeadEnemies();
 
-    const std::vector<Enemy>& getEnemies() const { return m_enemies; }
-    size_t getEnemyCount() const { return m_enemies.size(); }
+    size_t getEnemyCount() const { return m_x.size(); }
+
+    EnemyHandle getHandle(size_t i) const;
+    // Índice atual do inimigo, ou -1 se ele já foi removido
+    int findEnemy(EnemyHandle handle) const;
+
+    float getX(size_t i) const { return m_x[i]; }
+    float getZ(size_t i) const { return m_z[i]; }
+    int getVida(size_t i) const { return m_vida[i]; }
+    glm::vec4 getPosition(size_t i) const { return glm::vec4(m_x[i], 0.101f, m_z[i], 1.0f); }
+    glm::vec4 getInterpolatedPosition(size_t i, float alpha) const;
+    float lookAt(size_t i, const glm::vec4& targetPosition) const;
+
+    bool isDead(size_t i) const { return m_vida[i] <= 0; }
+    bool isDying(size_t i) const { return m_dying[i] != 0; }
+    float getDeathProgress(size_t i) const;
+    float getDeathScale(size_t i) const;
+
+    void setPosition(size_t i, float x, float z) { m_x[i] = x; m_z[i] = z; }
+    void takeDamage(size_t i, int damage);
+    void applyKnockback(size_t i, float dirX, float dirZ, float force);
+    // chama apos a colisão para recalcular a curva de bezier
+    void onObstacleCollision(size_t i);
 
     void setEnemySpeed(float speed) { m_enemySpeed = speed; }
     void setMaxEnemies(int maxEnemies) { m_maxEnemies = maxEnemies; }
-    void clearEnemies() { m_enemies.clear(); m_previousSecond = -1; }
+    void clearEnemies();
     void setDifficulty(int difficulty) { m_difficulty = difficulty; }
-    int getRandomEnemyHP();
+    void setSfx(Sfx* sfx) { m_sfx = sfx; }
+    int getRandomEnemyHP(Random& random);
 
 private:
-    std::vector<Enemy> m_enemies;
+    void addEnemy(float x, float z, int vida);
+    void removeEnemy(size_t i);
+    void moveEnemy(size_t from, size_t to);
+    void startDying(size_t i);
+    void recalculateCurve(size_t i, const glm::vec4& playerPos, Random& random);
+    void evaluateBezierDerivative(size_t i, float t, float& dx, float& dz) const;
+
+    // Posição atual e do tick anterior (interpolação na renderização)
+    std::vector<float> m_x;
+    std::vector<float> m_z;
+    std::vector<float> m_previousX;
+    std::vector<float> m_previousZ;
+
+    // Curva de Bézier atual: pontos de controle (plano XZ) e parâmetro t
+    std::vector<float> m_p0x, m_p0z;
+    std::vector<float> m_p1x, m_p1z;
+    std::vector<float> m_p2x, m_p2z;
+    std::vector<float> m_p3x, m_p3z;
+    std::vector<float> m_bezierT;
+    std::vector<float> m_speed;
+    std::vector<float> m_curveRecalcTimer;
+    std::vector<unsigned char> m_curveInitialized;
+    // -1 (todos os bits) se o inimigo segue a curva neste tick, 0 se não;
+    // máscara usada pelo kernel SIMD para decidir quais posições escrever
+    std::vector<int32_t> m_followsCurve;
+
+    std::vector<float> m_knockbackVelX;
+    std::vector<float> m_knockbackVelZ;
+
+    std::vector<int> m_vida;
+    std::vector<unsigned char> m_dying;
+    std::vector<float> m_deathTimer;
+
+    // Handles: slot de cada índice denso, e para cada slot o índice denso
+    // atual e a geração. Slots livres são reaproveitados (pilha)
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<uint32_t> m_slotToDense;
+    std::vector<uint32_t> m_slotGeneration;
+    std::vector<uint32_t> m_freeSlots;
+
+    static constexpr float ENEMY_SPEED = 0.4f;
+    static constexpr float DEATH_ANIM_DURATION = 0.35f;
+
     int m_previousSecond;
     int m_maxEnemies;
     int m_spawnInterval;
     float m_enemySpeed;
     int m_difficulty;
+    Sfx* m_sfx;
 };
 
 #endif 
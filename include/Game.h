@@ -5,10 +5,16 @@
 #include <GLFW/glfw3.h>
 #include <glm/vec3.hpp>
 #include <vector>
+#include <cstdint>
 #include "Player.h"
 #include "Enemy.h"
 #include "Renderer.h"
 #include "Projectile.h"
+#include "Input.h"
+#include "InputRecorder.h"
+#include "Random.h"
+#include "SpatialGrid.h"
+#include "TimingStats.h"
 #include "sfx.h"
 struct HealthPickup
 {
@@ -55,6 +61,49 @@ public:
 
     void run();
 
+    // Modo headless: simula partidas sem janela, contexto OpenGL, Renderer
+    // ou áudio, o mais rápido possível, com o jogador controlado pelo
+    // piloto automático. Ao final imprime o desempenho em ticks/segundo.
+    bool initHeadless();
+    void runHeadless(int matches, long long maxTicksPerMatch);
+    bool isHeadless() const { return m_headless; }
+
+    // Passos de uma arena headless, usados pelo BatchRunner: avança
+    // 'ticks' ticks, reiniciando a partida sempre que ela termina
+    void startHeadlessMatch();
+    void stepHeadless(long long ticks);
+    bool isMatchOver() const { return m_gameState == GameState::GAME_OVER || m_gameState == GameState::WIN; }
+
+    // Semente do gerador aleatório deste mundo. Mesma semente + mesmas
+    // entradas reproduzem a mesma sessão, tick a tick
+    void setRandomSeed(uint64_t seed) { m_seed = seed; m_random.seed(seed); }
+    uint64_t getRandomSeed() const { return m_seed; }
+
+    // Hash (FNV-1a) do estado da simulação, para comparar execuções
+    uint64_t computeStateHash() const;
+
+    // Gravação e replay de sessões (ver InputRecorder). loadReplay deve ser
+    // chamado antes de init/initHeadless: aplica a semente, a taxa de ticks e
+    // a dificuldade gravadas. Ao final do replay, run/runReplayHeadless
+    // imprimem os tempos de tick e de frame e conferem o hash final.
+    bool startRecording(const char* path);
+    bool loadReplay(const char* path);
+    bool isReplaying() const { return m_replay.isOpen(); }
+    void runReplayHeadless();
+
+    // Taxa da simulação em passo fixo (ticks por segundo) e limite de
+    // sub-passos por frame, para evitar a "espiral da morte" em frames longos
+    void setTickRate(float ticksPerSecond);
+    float getTickRate() const { return m_tickRate; }
+    void setMaxSubSteps(int maxSubSteps);
+
+    // Máximo de projéteis simultâneos (pool do ProjectileManager)
+    void setProjectileCapacity(size_t capacity) { m_projectileManager.setCapacity(capacity); }
+
+    // Imprime, uma vez por segundo, os contadores da fila de renderização
+    // do último quadro (pacotes, draws, chamadas GL)
+    void setRenderStatsEnabled(bool enabled) { m_renderStatsEnabled = enabled; }
+
     void cleanup();
 
     GLFWwindow* getWindow() { return m_window; }
@@ -87,12 +136,22 @@ public:
 private:
     void update(float deltaTime);
 
-    void render(float deltaTime);
+    void render(float deltaTime, float alpha);
+    void flushScene(float deltaTime);
+
+    void storePreviousState();
+
+    PlayerInput readPlayerInput() const;
+    void updateAutopilot(float deltaTime, InputFrame& frame);
+    void applyInputCommands(const InputFrame& frame);
+    void printReplayReport();
+    void setCursorMode(int mode);
 
     void handleCollisions();
     void handleEnemyEnvironmentCollisions();
+    void rebuildEnemyGrid();
 
-    void handleShooting();
+    void handleShooting(bool shootRequested);
 
     void handleDebugKillKey();
 
@@ -105,12 +164,30 @@ private:
     Player m_player;
     EnemyManager m_enemyManager;
     Renderer m_renderer;
+    Input m_input;
+    Sfx m_sfx;
+    Random m_random;
+    uint64_t m_seed;
+    InputRecorder m_recorder;
+    InputReplay m_replay;
+    bool m_replayFinished;
+    TimingStats m_tickTimes;
+    TimingStats m_frameTimes;
+    bool m_renderStatsEnabled;
+    float m_renderStatsTimer;
     Enemy m_dragonBoss;
     bool m_dragonBossAlive;
 
     GLFWwindow* m_window;
+    bool m_headless;
 
     double m_lastFrameTime;
+    double m_accumulator;
+    float m_tickRate;
+    float m_fixedDeltaTime;
+    int m_maxSubSteps;
+    static constexpr float DEFAULT_TICK_RATE = 120.0f;
+    static constexpr int DEFAULT_MAX_SUBSTEPS = 8;
     int m_segundoAnterior;
 
     GameState m_gameState;
@@ -136,6 +213,16 @@ private:
     bool menu_music;
     std::vector<Pillar> m_pillars;
 
+    // Broad phase das colisões: grade dos inimigos (refeita antes de cada
+    // passada de colisão) e dos pilares (estáticos, montada no construtor)
+    SpatialGrid m_enemyGrid;
+    SpatialGrid m_pillarGrid;
+    std::vector<int> m_collisionCandidates;
+    static constexpr float COLLISION_GRID_CELL_SIZE = 0.5f;
+    // Folga das consultas em que o objeto é empurrado durante a passada
+    // (jogador x inimigos, inimigo x pilares)
+    static constexpr float COLLISION_PUSH_MARGIN = 0.25f;
+
     std::vector<Torch> m_torches;
     float m_gameTime;
     float m_baseEnemySpeed;
@@ -145,7 +232,17 @@ private:
     float m_pauseCameraDistance;
     glm::vec4 m_pauseCameraTarget;
     PauseFocusTarget m_pauseFocusTarget;
-    int m_pauseFocusEnemyIndex;  
+    EnemyHandle m_pauseFocusEnemy;
+
+    // Estado do piloto automático (modo headless)
+    float m_autopilotShotTimer;
+    float m_autopilotStrafeTimer;
+    bool m_autopilotStrafeRight;
+    static constexpr float AUTOPILOT_FIRE_INTERVAL = 0.2f;
+    static constexpr float AUTOPILOT_STRAFE_INTERVAL = 1.5f;
+    static constexpr float AUTOPILOT_AIM_TOLERANCE = 0.05f;
+    static constexpr float AUTOPILOT_TURN_SPEED = 6.0f;
+    static constexpr float AUTOPILOT_SAFE_DISTANCE = 0.8f;
 };
 
 #endif
@@ -3,14 +3,49 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "Player.h"
 
-class Player;
 class Game;
 
+// Entradas de um tick da simulação. Os eventos do GLFW que alteram o jogo
+// (teclas de estado, tiro, movimento do mouse) são acumulados entre ticks e
+// consumidos de uma vez por Game::update; assim uma sessão pode ser gravada
+// e reproduzida tick a tick (ver InputRecorder).
+struct InputFrame
+{
+    PlayerInput movement;     // WASD
+    float lookDx;             // deltas do mouse para a câmera do jogador
+    float lookDy;
+    bool jump;
+    bool shoot;
+    bool toggleCamera;
+    bool togglePause;
+    bool restart;
+    bool returnToMenu;
+    int startDifficulty;      // -1: nenhum; 0..2: inicia a partida (menu)
+
+    InputFrame()
+        : lookDx(0.0f)
+        , lookDy(0.0f)
+        , jump(false)
+        , shoot(false)
+        , toggleCamera(false)
+        , togglePause(false)
+        , restart(false)
+        , returnToMenu(false)
+        , startDifficulty(-1)
+    {
+    }
+};
+
 class Input
 {
 public:
-    static void init(Player* player, Game* game);
+    Input();
+
+    // Associa esta instância à janela (glfwSetWindowUserPointer) e registra
+    // os callbacks. Cada Game tem o seu Input, sem estado global.
+    void init(GLFWwindow* window, Player* player, Game* game);
 
     static void framebufferSizeCallback(GLFWwindow* window, int width, int height);
     static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
@@ -19,19 +54,30 @@ public:
     static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mod);
     static void errorCallback(int error, const char* description);
 
-    static float getScreenRatio() { return s_screenRatio; }
-    static bool isLeftMouseButtonPressed() { return s_leftMouseButtonPressed; }
-    static bool isShootingRequested();
+    float getScreenRatio() const { return m_screenRatio; }
+    bool isLeftMouseButtonPressed() const { return m_leftMouseButtonPressed; }
+
+    // Retorna os eventos acumulados desde o último tick e limpa o acúmulo
+    InputFrame consumeFrame();
 
 private:
-    static Player* s_player;
-    static Game* s_game;
-
-    static float s_screenRatio;
-    static bool s_leftMouseButtonPressed;
-    static bool s_shootRequested;
-    static double s_lastCursorPosX;
-    static double s_lastCursorPosY;
+    static Input* fromWindow(GLFWwindow* window);
+
+    void onFramebufferSize(int width, int height);
+    void onMouseButton(GLFWwindow* window, int button, int action);
+    void onCursorPos(double xpos, double ypos);
+    void onScroll(double yoffset);
+    void onKey(GLFWwindow* window, int key, int action);
+
+    Player* m_player;
+    Game* m_game;
+
+    float m_screenRatio;
+    bool m_leftMouseButtonPressed;
+    InputFrame m_pendingFrame;
+    double m_lastCursorPosX;
+    double m_lastCursorPosY;
+    int m_cursorLogCount;
 };
 
-#endif 
+#endif 
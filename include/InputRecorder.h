@@ -0,0 +1,100 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+#include "Input.h"
+
+// ============================================================================
+// GRAVAÇÃO E REPLAY DE ENTRADAS
+// ============================================================================
+// Formato do arquivo (little-endian):
+//
+//   Cabeçalho (36 bytes)
+//     char[4]  "FGCR"
+//     uint16   versão
+//     uint16   reservado
+//     uint64   semente do gerador aleatório
+//     int32    dificuldade inicial
+//     float    taxa de ticks (Hz)
+//     uint32   número de ticks gravados
+//     uint64   hash do estado ao final da gravação (Game::computeStateHash)
+//
+//   Um registro por tick
+//     uint16   flags (WASD, pulo, tiro, câmera, pausa, menu...)
+//     int8     dificuldade            se FLAG_START_GAME
+//     float x2 deltas do mouse        se FLAG_LOOK
+//
+// Como a simulação é determinística (passo fixo + Random com semente),
+// reaplicar os mesmos registros a partir da mesma semente reproduz a
+// sessão exatamente; o hash final permite conferir isso.
+//
+// A gravação vai para "<arquivo>.tmp", com o cabeçalho provisório (0 ticks,
+// hash 0) e os registros descarregados em disco a cada segundo de jogo. Ao
+// fechar, o cabeçalho é completado e o .tmp substitui o arquivo; se a sessão
+// cair antes, o arquivo anterior fica intacto e o .tmp pode ser reproduzido
+// até o último registro completo (sem conferir o hash).
+// ============================================================================
+struct ReplayHeader
+{
+    uint64_t seed;
+    int difficulty;
+    float tickRate;
+    uint32_t frameCount;
+    uint64_t finalStateHash;
+};
+
+class InputRecorder
+{
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const char* path, uint64_t seed, int difficulty, float tickRate);
+    void write(const InputFrame& frame);
+    // Completa o cabeçalho e troca o arquivo pelo .tmp
+    bool close(uint64_t finalStateHash);
+
+    bool isOpen() const { return m_file != NULL; }
+    uint32_t getFrameCount() const { return m_header.frameCount; }
+
+private:
+    InputRecorder(const InputRecorder&);
+    InputRecorder& operator=(const InputRecorder&);
+
+    bool flush();
+
+    FILE* m_file;
+    bool m_failed;
+    std::vector<char> m_path;
+    std::vector<char> m_tempPath;
+    ReplayHeader m_header;
+    uint32_t m_flushInterval;      // ticks entre descargas em disco
+    std::vector<unsigned char> m_data; // registros ainda não escritos
+};
+
+class InputReplay
+{
+public:
+    InputReplay();
+
+    // Carrega o arquivo inteiro em memória
+    bool open(const char* path);
+    // Próximo tick; retorna false quando a gravação termina
+    bool next(InputFrame& frame);
+
+    bool isOpen() const { return m_open; }
+    const ReplayHeader& getHeader() const { return m_header; }
+    uint32_t getFramesPlayed() const { return m_framesPlayed; }
+
+private:
+    bool m_open;
+    ReplayHeader m_header;
+    std::vector<unsigned char> m_data;
+    size_t m_offset;
+    uint32_t m_framesPlayed;
+};
+
+#endif
@@ -7,6 +7,8 @@ class Logger {
 public:
     template<typename... Args>
     static void logEvent(const char* eventKind, const char* format, Args... args) {
+        if (!isEnabled())
+            return;
         char buffer[2048];
         snprintf(buffer, sizeof(buffer), format, args...);
         printf("{\"eventKind\":\"%s\", \"data\":%s}\n", eventKind, buffer);
@@ -14,9 +16,30 @@ public:
     }
 
     static void logEvent(const char* eventKind, const char* jsonData) {
+        if (!isEnabled())
+            return;
         printf("{\"eventKind\":\"%s\", \"data\":%s}\n", eventKind, jsonData);
         fflush(stdout);
     }
+
+    // Mensagens de depuração da simulação (dano, tiros, spawns...)
+    template<typename... Args>
+    static void print(const char* format, Args... args) {
+        if (!isEnabled())
+            return;
+        printf(format, args...);
+    }
+
+    // O modo headless desliga os logs: imprimir a cada tick domina o tempo
+    // de execução quando a simulação roda sem limite de velocidade
+    static void setEnabled(bool enabled) { enabledFlag() = enabled; }
+    static bool isEnabled() { return enabledFlag(); }
+
+private:
+    static bool& enabledFlag() {
+        static bool enabled = true;
+        return enabled;
+    }
 };
 
 #endif
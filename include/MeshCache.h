@@ -0,0 +1,115 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// ============================================================================
+// CACHE BINÁRIO DE MALHAS
+// ============================================================================
+// Na primeira execução cada .obj é lido pelo tinyobjloader, processado
+// (normais, solda, níveis de detalhe, ordem para o cache de vértices) e o
+// resultado é gravado ao lado do original, em "<arquivo>.mesh". Nas
+// execuções seguintes o .mesh é mapeado em memória e os buffers vão direto
+// para o GL, sem parsing.
+//
+// Formato do arquivo (nativo da plataforma, little-endian no x86; o cache é
+// descartado e regerado se o cabeçalho não bater ou se algum LOD, nome ou
+// índice estiver fora dos limites):
+//
+//   Cabeçalho (32 bytes)
+//     char[4]  "FGCM"
+//     uint16   versão (MESH_CACHE_VERSION)
+//     uint16   bytes por índice (2 ou 4)
+//     uint64   hash (FNV-1a) do .obj de origem
+//     uint32   número de submalhas
+//     uint32   número de vértices
+//     uint32   número de índices
+//     uint32   reservado
+//
+//   MeshSubmesh x submalhas   (nome, trechos de índices por LOD, AABB)
+//   MeshVertex  x vértices    (posição, normal, textura intercaladas)
+//   índices de 16 ou 32 bits
+//
+// MESH_CACHE_VERSION deve subir sempre que o processamento da malha mudar,
+// para os caches antigos serem regerados.
+// ============================================================================
+static const uint16_t MESH_CACHE_VERSION = 1;
+static const int MESH_CACHE_MAX_LODS = 4;
+static const size_t MESH_CACHE_NAME_SIZE = 64;
+
+struct MeshVertex
+{
+    float position[3];
+    float normal[3];
+    float texcoord[2];
+};
+
+struct MeshSubmesh
+{
+    char     name[MESH_CACHE_NAME_SIZE];
+    uint32_t numLods;
+    uint32_t lodFirstIndex[MESH_CACHE_MAX_LODS];
+    uint32_t lodNumIndices[MESH_CACHE_MAX_LODS];
+    float    bboxMin[3];
+    float    bboxMax[3];
+};
+
+// Malha processada, montada em memória a partir do .obj
+struct MeshData
+{
+    std::vector<MeshSubmesh>   submeshes;
+    std::vector<MeshVertex>    vertices;
+    std::vector<uint32_t>      indices;
+};
+
+// Ponteiros para uma malha pronta para o upload: apontam para o arquivo
+// mapeado ou para um MeshData (ver ViewMeshData)
+struct MeshView
+{
+    const MeshSubmesh* submeshes;
+    uint32_t           submeshCount;
+    const MeshVertex*  vertices;
+    uint32_t           vertexCount;
+    const void*        indices;
+    uint32_t           indexCount;
+    uint32_t           indexSize;    // 2 ou 4 bytes
+};
+
+// Arquivo mapeado em memória (somente leitura)
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const char* path);
+    void close();
+
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+};
+
+uint64_t HashBytes(const unsigned char* data, size_t size);
+
+// O MeshView aponta para dentro do arquivo, que precisa continuar aberto
+bool ReadMeshCache(const MappedFile& file, uint64_t sourceHash, MeshView& view);
+bool WriteMeshCache(const char* path, uint64_t sourceHash, const MeshData& mesh);
+
+// Índices de 16 bits quando todos os vértices cabem neles; 'packed' guarda
+// os índices no tamanho escolhido e precisa viver enquanto a view for usada
+void ViewMeshData(const MeshData& mesh, std::vector<unsigned char>& packed, MeshView& view);
+
+#endif
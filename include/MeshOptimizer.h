@@ -0,0 +1,33 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <cstddef>
+
+// ============================================================================
+// OTIMIZAÇÃO DE MALHAS INDEXADAS
+// ============================================================================
+// Depois da solda dos vértices (ver buildTrianglesFromObj), a ordem dos
+// triângulos e dos vértices decide quanto a GPU reaproveita:
+//
+//   - OptimizeVertexCache reordena os triângulos para o cache pós-transformação
+//     (algoritmo de Forsyth, "Linear-Speed Vertex Cache Optimisation", 2006):
+//     triângulos que usam vértices recém-transformados saem primeiro.
+//   - OptimizeVertexFetch renumera os vértices na ordem do primeiro uso, para
+//     as leituras do VBO andarem para a frente na memória.
+//   - ComputeACMR mede o resultado: vértices transformados por triângulo num
+//     cache FIFO de cacheSize entradas (3.0 sem reaproveitamento algum; o
+//     mínimo prático para malhas fechadas fica perto de 0.5).
+//
+// Os índices são locais (0..vertexCount-1), 3 por triângulo.
+// ============================================================================
+void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+// remap[v] é o novo número do vértice v; os índices são reescritos.
+// Vértices que nenhum triângulo usa vão para o fim.
+void OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount,
+                         std::vector<unsigned int>& remap);
+
+float ComputeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize = 16);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include <glm/vec3.hpp>
+
+// ============================================================================
+// SIMPLIFICAÇÃO DE MALHAS (NÍVEIS DE DETALHE)
+// ============================================================================
+// Gera versões com menos triângulos de uma malha por colapso de arestas
+// guiado por quádricas de erro (Garland e Heckbert, 1997). Os colapsos são
+// de meia-aresta: o vértice v é levado para a posição de um vizinho u, que
+// já existe. Assim os níveis simplificados são só listas de índices sobre
+// os vértices originais e cabem no mesmo VBO, como trechos extras do
+// buffer de índices.
+//
+// A malha de entrada tem T triângulos e 3T "cantos" (o canto 3t+k é o
+// k-ésimo vértice do triângulo t, com normal e coordenada de textura
+// próprias). cornerPosition[c] diz qual posição soldada o canto c usa; a
+// topologia vem dessas posições.
+//
+// Posições travadas (lockedPositions) nunca são removidas: o chamador
+// trava as costuras de textura/normal, e as bordas abertas da malha são
+// travadas aqui, para a silhueta não encolher.
+//
+// Para cada alvo em targetTriangles (decrescente), lods recebe a lista de
+// cantos (3 por triângulo) do nível, já com os triângulos degenerados
+// removidos. Se a malha não puder ser reduzida até o alvo, o nível sai com
+// o que foi possível.
+// ============================================================================
+void SimplifyMesh(const std::vector<glm::vec3>& positions,
+                  const std::vector<int>& cornerPosition,
+                  const std::vector<bool>& lockedPositions,
+                  const std::vector<size_t>& targetTriangles,
+                  std::vector< std::vector<unsigned int> >& lods);
+
+#endif
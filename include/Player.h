@@ -1,25 +1,47 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include <glad/glad.h>
-#include <GLFW/glfw3.h>
 #include <glm/mat4x4.hpp>
 #include <glm/vec4.hpp>
 
+class Sfx;
+
+// Comandos de movimento do jogador em um tick da simulação. Preenchido a
+// partir do teclado (Game::readPlayerInput) ou pelo piloto automático do
+// modo headless, de modo que Player não depende da janela GLFW.
+struct PlayerInput
+{
+    bool forward;
+    bool backward;
+    bool left;
+    bool right;
+
+    PlayerInput()
+        : forward(false)
+        , backward(false)
+        , left(false)
+        , right(false)
+    {
+    }
+};
+
 class Player
 {
 public:
     Player();
     ~Player();
 
-    void update(GLFWwindow* window, float deltaTime);
+    void update(const PlayerInput& input, float deltaTime);
 
-    glm::mat4 getCameraView() const;
+    glm::mat4 getCameraView(float alpha = 1.0f) const;
     void toggleCamera();
     void handleMouseMove(float dx, float dy);
     void handleScroll(float offset);
 
     glm::vec4 getPosition() const { return m_position; }
+    // Posição interpolada entre o tick anterior e o atual (alpha em [0,1])
+    glm::vec4 getInterpolatedPosition(float alpha) const { return m_previousPosition + (m_position - m_previousPosition) * alpha; }
+    void storePreviousState() { m_previousPosition = m_position; }
     bool isFirstPerson() const { return m_firstPerson; }
     glm::vec4 getCameraDirection() const;
     glm::vec4 getCameraPosition() const;
@@ -37,9 +59,11 @@ public:
     void setVida(int vida, int maxVida);
     void reset();
     void jump();
+    void setSfx(Sfx* sfx) { m_sfx = sfx; }
 
 private:
     glm::vec4 m_position;
+    glm::vec4 m_previousPosition;
 
     float m_velocityY;
     float m_gravity;
@@ -65,6 +89,13 @@ private:
     int m_maxVida;
     float m_damageCooldown;
     float m_damageCooldownTimer;
+
+    Sfx* m_sfx;
+
+    // Contadores que limitam a frequência dos logs de depuração
+    int m_updateLogCount;
+    mutable int m_viewLogCount;
+    int m_mouseLogCount;
 };
 
 #endif 
@@ -2,35 +2,38 @@
 #define PROJECTILE_H
 
 #include <vector>
+#include <cstdint>
 #include <glm/vec3.hpp>
 
-struct Projectile
-{
-    glm::vec3 position;
-    glm::vec3 velocity;
-    float lifetime;
-    bool active;
-    bool isEnemyProjectile;
-
-    static const int TRAIL_LENGTH = 6;
-    glm::vec3 trailPositions[TRAIL_LENGTH];
-    int trailIndex;
-    float trailTimer;
-
-    Projectile()
-        : position(0.0f)
-        , velocity(0.0f)
-        , lifetime(0.0f)
-        , active(false)
-        , isEnemyProjectile(false)
-        , trailIndex(0)
-        , trailTimer(0.0f)
-    {
-        for (int i = 0; i < TRAIL_LENGTH; i++)
-            trailPositions[i] = glm::vec3(0.0f);
-    }
-};
+class Sfx;
 
+// ============================================================================
+// POOL DE PROJÉTEIS
+// ============================================================================
+// Os projéteis vivem em slots de índice estável, até uma capacidade
+// configurável, e cada campo é um array paralelo indexado pelo slot:
+//
+//   quentes: posição, velocidade, tempo de vida e flag de ativo, lidos e
+//            escritos a cada tick por update() e pelas colisões; o passo
+//            de integração/tempo de vida/limites da arena roda em SSE2
+//   frios:   o rastro, que só o Renderer consome: TRAIL_LENGTH amostras
+//            das posições de todos os projéteis, gravadas juntas a cada
+//            m_trailUpdateInterval segundos em um buffer circular
+//
+// Todos os arrays têm a capacidade inteira desde setCapacity(). Slots livres
+// formam uma lista encadeada (m_nextFree) e os ativos ficam numa lista densa
+// de índices:
+//
+//   spawn:    tira um slot da lista livre e o acrescenta ao fim da
+//             lista densa                                           O(1)
+//   despawn:  o projétil é marcado inativo (colisão, tempo de vida) e
+//             removeInactive() o troca pelo último da lista densa e
+//             devolve o slot à lista livre, sem tocar no rastro     O(1)
+//
+// O passo por tick percorre os slots [0, m_slotsUsed) de forma contínua;
+// slots livres estão inativos e são integrados sem efeito. O acesso de fora
+// é pela posição na lista densa, em [0, getProjectileCount()).
+// ============================================================================
 class ProjectileManager
 {
 public:
@@ -39,20 +42,74 @@ public:
 
     void spawnProjectile(const glm::vec3& origin, const glm::vec3& direction, bool isEnemy = false);
     void update(float deltaTime);
+    void storePreviousState();
     void removeInactive();
     void clear();
+    void setSfx(Sfx* sfx) { m_sfx = sfx; }
 
-    const std::vector<Projectile>& getProjectiles() const { return m_projectiles; }
-    std::vector<Projectile>& getProjectiles() { return m_projectiles; }
+    // Sem janela o rastro não é desenhado, então não precisa ser gravado
+    void setTrailsEnabled(bool enabled) { m_trailsEnabled = enabled; }
+
+    // Número máximo de projéteis simultâneos; disparos além dele são
+    // ignorados. A memória de todos eles é reservada aqui
+    void setCapacity(size_t capacity);
+    size_t getCapacity() const { return m_capacity; }
+
+    // Acesso pela posição na lista densa, em [0, getProjectileCount())
+    size_t getProjectileCount() const { return m_live.size(); }
+    glm::vec3 getPosition(size_t i) const { return slotPosition(m_live[i]); }
+    glm::vec3 getInterpolatedPosition(size_t i, float alpha) const;
+    bool isActive(size_t i) const { return m_active[m_live[i]] != 0; }
+    bool isEnemyProjectile(size_t i) const { return m_isEnemy[m_live[i]] != 0; }
+    void deactivate(size_t i) { m_active[m_live[i]] = 0; }
+
+    // Posição do projétil i na amostra 'age' do rastro (0 = a mais recente)
+    glm::vec3 getTrailPosition(size_t i, int age) const;
+
+    static const int TRAIL_LENGTH = 6;
+    static const size_t DEFAULT_CAPACITY = 16384;
+    static const size_t MAX_CAPACITY = 1 << 20;
 
 private:
-    std::vector<Projectile> m_projectiles;
+    void updateTrails(float deltaTime);
+    void allocateSlots();
+    glm::vec3 slotPosition(int slot) const { return glm::vec3(m_x[slot], m_y[slot], m_z[slot]); }
+
+    // Campos quentes, por slot
+    std::vector<float> m_x, m_y, m_z;
+    std::vector<float> m_velocityX, m_velocityY, m_velocityZ;
+    std::vector<float> m_lifetime;
+    std::vector<int32_t> m_active; // -1 (ativo) ou 0, máscara para o SIMD
+    std::vector<uint8_t> m_isEnemy;
+
+    // Próximo slot livre (lista livre intrusiva); -1 se for o último
+    std::vector<int> m_nextFree;
+    int m_freeHead;
+
+    // Slots dos projéteis vivos, densos; e quantos slots já foram usados
+    // desde o último clear(), o intervalo percorrido por tick
+    std::vector<int> m_live;
+    size_t m_slotsUsed;
+
+    // Posição no início do tick, para interpolar no render
+    std::vector<float> m_previousX, m_previousY, m_previousZ;
+
+    // Campos frios: uma amostra do rastro por plano, m_trailHead é o
+    // próximo plano a ser escrito
+    std::vector<float> m_trailX[TRAIL_LENGTH];
+    std::vector<float> m_trailY[TRAIL_LENGTH];
+    std::vector<float> m_trailZ[TRAIL_LENGTH];
+    int m_trailHead;
+    float m_trailTimer;
+    bool m_trailsEnabled;
+
+    size_t m_capacity;
 
     float m_projectileSpeed;
     float m_enemyProjectileSpeed;
     float m_maxLifetime;
     float m_trailUpdateInterval;
-    size_t m_maxProjectiles;
+    Sfx* m_sfx;
 };
 
 #endif
@@ -0,0 +1,24 @@
+#ifndef PROJECTILE_BENCH_H
+#define PROJECTILE_BENCH_H
+
+#include <cstdint>
+
+// Mede o tick de projéteis (ProjectileManager::update) com muitos projéteis
+// vivos e o compara com o layout anterior, em que cada projétil era uma
+// struct com o rastro junto dos campos da simulação.
+class ProjectileBench
+{
+public:
+    ProjectileBench(int projectiles, int rounds, float tickRate, uint64_t seed);
+
+    // Imprime o tempo médio por tick de cada versão e o speedup
+    void run();
+
+private:
+    int m_projectiles;
+    int m_rounds;
+    float m_tickRate;
+    uint64_t m_seed;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// ============================================================================
+// GERADOR DE NÚMEROS ALEATÓRIOS (PCG32)
+// ============================================================================
+// Cada mundo (Game) tem o seu gerador, passado explicitamente a quem sorteia
+// valores (spawn e HP de inimigos, curvas de Bézier, power-ups de vida).
+// Ao contrário de rand(), não há estado global nem trava, e a sequência
+// depende só da semente: mesma semente + mesmas entradas = mesma partida,
+// bit a bit, em qualquer plataforma (não usamos as distribuições de
+// <random>, cuja implementação varia entre bibliotecas padrão).
+//
+// Algoritmo PCG32 (XSH-RR), de M. E. O'Neill: estado de 64 bits, saída de
+// 32 bits. O incremento fixo seleciona a sequência.
+// ============================================================================
+class Random
+{
+public:
+    explicit Random(uint64_t seed = DEFAULT_SEED) { this->seed(seed); }
+
+    void seed(uint64_t seed)
+    {
+        m_state = 0;
+        nextUInt();
+        m_state += seed;
+        nextUInt();
+    }
+
+    uint32_t nextUInt()
+    {
+        uint64_t old = m_state;
+        m_state = old * 6364136223846793005ULL + INCREMENT;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Inteiro uniforme em [0, n)
+    int nextInt(int n)
+    {
+        return static_cast<int>((static_cast<uint64_t>(nextUInt()) * static_cast<uint32_t>(n)) >> 32);
+    }
+
+    // Float uniforme em [0, 1), com os 24 bits da mantissa
+    float nextFloat()
+    {
+        return (nextUInt() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // Semente sem --seed: as execuções padrão são determinísticas, mas a
+    // sequência não é a do rand() de antes do PCG32 (as partidas diferem)
+    static constexpr uint64_t DEFAULT_SEED = 1;
+
+private:
+    static constexpr uint64_t INCREMENT = 1442695040888963407ULL;
+
+    uint64_t m_state;
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+// ============================================================================
+// FILA DE RENDERIZAÇÃO
+// ============================================================================
+// As funções render* do Renderer não desenham mais na hora: cada uma monta
+// DrawPackets (modelo, programa do material, matriz, pass) e os empilha aqui.
+// No fim da cena o Renderer ordena a fila pela chave de 64 bits e emite os
+// pacotes em ordem, através do GLStateCache, que descarta as chamadas que
+// não mudam nada (mesmo programa, mesmo VAO, mesmo valor de uniform...).
+//
+// Chave (bits mais altos primeiro):
+//
+//   [63..61]  pass      opacos sem culling, opacos, aditivos
+//   [60..54]  programa
+//   [53..42]  VAO
+//   [41..40]  nível de detalhe da malha
+//   [39..16]  profundidade (opacos: frente para trás)
+//   [15.. 0]  ordem de chegada, para a ordenação ser estável
+//
+// O material não entra na chave: a textura é uma camada do array de
+// texturas, escolhida por instância. Pacotes vizinhos do mesmo programa,
+// VAO e intervalo de índices formam uma "corrida" que o Renderer desenha
+// com uma única chamada instanciada, mesmo com materiais diferentes.
+// ============================================================================
+
+// Passes, na ordem em que são desenhados
+enum RenderPass
+{
+    PASS_OPAQUE_NO_CULL = 0,  // arena e pilares: faces sem orientação consistente
+    PASS_OPAQUE         = 1,  // personagens, inimigos e power-ups
+    PASS_ADDITIVE       = 2   // projéteis, rastros e tochas: blend aditivo, sem escrita de profundidade
+};
+
+struct DrawPacket
+{
+    uint64_t  key;
+    GLuint    program;
+    GLuint    vao;
+    GLenum    mode;
+    GLsizei   count;         // número de índices (ou de vértices, se !indexed)
+    GLsizei   first;         // primeiro índice (ou vértice)
+    GLenum    indexType;     // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
+    bool      indexed;
+    bool      staticBatch;   // lote estático: posição já no mundo, sem matriz modelo
+    bool      instanceable;  // o VAO tem os atributos de instância
+    int       permutation;   // programa do material (ver ShaderPermutation)
+    float     layer;         // camada da textura no array dos materiais
+    glm::vec3 bboxMin;
+    glm::vec3 bboxMax;
+    glm::mat4 model;
+};
+
+// Contadores de um quadro, para medir o efeito da fila
+struct RenderStats
+{
+    unsigned packets;         // pacotes submetidos
+    unsigned drawCalls;       // glDraw* emitidos
+    unsigned instancedDraws;  // dos quais instanciados
+    unsigned glCalls;         // todas as chamadas GL emitidas pela fila
+    unsigned redundantCalls;  // chamadas descartadas pelo cache de estado
+    unsigned visibleObjects;  // objetos que passaram no frustum culling
+    unsigned culledObjects;   // objetos descartados (fora do frustum)
+    unsigned triangles;       // triângulos enviados à GPU (todas as instâncias)
+};
+
+// ============================================================================
+// CACHE DE ESTADO GL
+// ============================================================================
+// Guarda o último valor de cada estado que a fila altera e só chama o GL
+// quando o valor muda. Código que mexe no GL por fora (texto, HUD) deixa o
+// cache desatualizado: invalidate() no início de cada flush.
+// ============================================================================
+class GLStateCache
+{
+public:
+    // Uniforms acompanhados pelo cache, no programa em uso (trocar de
+    // programa descarta os valores guardados)
+    enum UniformSlot
+    {
+        UNIFORM_USE_INSTANCING = 0,
+        UNIFORM_BBOX_MIN,
+        UNIFORM_BBOX_MAX,
+        UNIFORM_MATERIAL_LAYER,
+        UNIFORM_SLOT_COUNT
+    };
+
+    GLStateCache();
+
+    void invalidate();
+    void setStats(RenderStats* stats) { m_stats = stats; }
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindArrayBuffer(GLuint buffer);
+    void setCullFace(bool enabled);
+    void setBlend(bool enabled);
+    void setBlendFunc(GLenum source, GLenum destination);
+    void setDepthMask(bool enabled);
+
+    void setUniform1i(UniformSlot slot, GLint location, int value);
+    void setUniform1f(UniformSlot slot, GLint location, float value);
+    void setUniform4f(UniformSlot slot, GLint location, float x, float y, float z, float w);
+
+    // Chamadas GL emitidas fora do cache (draws, matrizes, ponteiros de
+    // atributo), só para as estatísticas
+    void countCall(unsigned calls = 1) { if (m_stats) m_stats->glCalls += calls; }
+
+private:
+    void issue();  // conta uma chamada emitida
+    void skip();   // conta uma chamada redundante
+
+    // Estado desconhecido (após invalidate): a próxima chamada sempre passa
+    static const GLint UNKNOWN = -1;
+
+    GLint  m_program;
+    GLint  m_vao;
+    GLint  m_arrayBuffer;
+    GLint  m_cullFace;
+    GLint  m_blend;
+    GLint  m_blendSource;
+    GLint  m_blendDestination;
+    GLint  m_depthMask;
+
+    bool   m_uniformValid[UNIFORM_SLOT_COUNT];
+    float  m_uniformValue[UNIFORM_SLOT_COUNT][4];
+
+    RenderStats* m_stats;
+};
+
+class RenderQueue
+{
+public:
+    RenderQueue();
+
+    // Monta a chave de ordenação. 'depth' é a distância até a câmera em
+    // unidades do mundo; nos pacotes aditivos ela é ignorada (o blend
+    // aditivo é comutativo e não escreve profundidade)
+    static uint64_t makeKey(RenderPass pass, GLuint program, GLuint vao, int lod, float depth);
+    static RenderPass passOf(uint64_t key) { return (RenderPass)(key >> 61); }
+
+    void submit(DrawPacket packet);
+    void sort();
+    void clear();
+
+    bool empty() const { return m_packets.empty(); }
+    size_t size() const { return m_order.size(); }
+    // i-ésimo pacote na ordem da chave (depois de sort())
+    const DrawPacket& operator[](size_t i) const { return m_packets[m_order[i].second]; }
+
+private:
+    std::vector<DrawPacket> m_packets;
+    std::vector< std::pair<uint64_t, uint32_t> > m_order;  // (chave, índice em m_packets)
+};
+
+#endif
@@ -9,13 +9,19 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 #include <tiny_obj_loader.h>
 #include "Projectile.h"
+#include "RenderQueue.h"
 
 struct HealthPickup;
 struct Pillar;
 struct Torch;
+struct MeshData;
+struct MeshView;
+struct MeshLoad;
+struct TextureImage;
 
 struct ObjModel
 {
@@ -26,15 +32,117 @@ struct ObjModel
     ObjModel(const char* filename, const char* basepath = NULL, bool triangulate = true);
 };
 
+const int MAX_MESH_LODS = 4;
+
 struct SceneObject
 {
     std::string  name;
     size_t       first_index;
     size_t       num_indices;
     GLenum       rendering_mode;
+    GLenum       index_type;       // GL_UNSIGNED_SHORT ou GL_UNSIGNED_INT
     GLuint       vertex_array_object_id;
     glm::vec3    bbox_min;
     glm::vec3    bbox_max;
+
+    // Níveis de detalhe: o nível 0 é a malha completa (first_index,
+    // num_indices); os demais são trechos simplificados no mesmo buffer
+    // de índices (ver buildMeshLods em Renderer.cpp)
+    int          num_lods;
+    size_t       lod_first_index[MAX_MESH_LODS];
+    size_t       lod_num_indices[MAX_MESH_LODS];
+};
+
+// Índice de um SceneObject em Renderer::m_meshes. Os nomes dos modelos são
+// resolvidos uma única vez, no carregamento; o caminho de desenho só usa
+// o índice (sem std::string, hash ou comparação por quadro).
+typedef int MeshHandle;
+const MeshHandle INVALID_MESH = -1;
+
+// Dados por instância das corridas instanciadas da fila de renderização,
+// enviados ao VBO de instâncias (atributos 3..7 e 10..12 do vertex shader)
+struct InstanceData
+{
+    glm::mat4 model;
+    glm::mat3 normalMatrix;  // inverse(transpose(model)), para as normais
+    float     layer;         // camada da textura do material
+};
+
+// ============================================================================
+// PERMUTAÇÕES DE SHADER
+// ============================================================================
+// Os shaders são compilados uma vez por material (object_id), com os
+// #defines do material inseridos após o #version (ver MATERIAL_PERMUTATIONS
+// em Renderer.cpp). Materiais com os mesmos #defines compartilham o
+// programa, mesmo com texturas diferentes: a textura é uma camada do array
+// de texturas dos materiais. Cada pacote da fila leva o índice da sua
+// permutação, e o flush usa os uniforms do programa correspondente.
+// ============================================================================
+const int MAX_MATERIALS = 32;  // object_ids válidos: [0, MAX_MATERIALS)
+
+struct ShaderPermutation
+{
+    std::string defines;
+    GLuint      program;
+    GLint       modelUniform;
+    GLint       normalMatrixUniform;
+    GLint       bboxMinUniform;
+    GLint       bboxMaxUniform;
+    GLint       useInstancingUniform;
+    GLint       materialLayerUniform;
+};
+
+// Um objeto do lote estático (quadrilátero da arena, pilar ou tocha)
+struct StaticBatchRange
+{
+    int       permutation;
+    GLsizei   first;
+    GLsizei   count;
+    glm::vec3 bboxMin;  // AABB do objeto, no mundo (para o frustum culling)
+    glm::vec3 bboxMax;
+};
+
+// ============================================================================
+// UNIFORMS POR QUADRO (blocos std140)
+// ============================================================================
+// Câmera e tochas mudam uma vez por quadro e são as mesmas para qualquer
+// programa. Ficam em dois uniform blocks, nos binding points abaixo, num
+// único buffer (m_frameUBO) escrito com um glBufferSubData por quadro.
+// Os structs espelham o layout std140 das declarações nos shaders:
+//
+//   layout(std140) uniform CameraBlock   { mat4 view; mat4 projection; vec4 camera_position; };
+//   layout(std140) uniform TorchBlock    { vec4 torch_positions[8]; vec4 torch_colors[8];
+//                                          int num_torches; float torch_flicker; };
+//
+// torch_positions[i].w guarda a intensidade da tocha i.
+// ============================================================================
+const GLuint CAMERA_BLOCK_BINDING = 0;
+const GLuint TORCH_BLOCK_BINDING  = 1;
+const int    MAX_TORCH_LIGHTS     = 8;
+
+struct CameraUniforms
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 cameraPosition;
+};
+
+struct TorchUniforms
+{
+    glm::vec4 positions[MAX_TORCH_LIGHTS];  // xyz = posição, w = intensidade
+    glm::vec4 colors[MAX_TORCH_LIGHTS];
+    GLint     count;
+    GLfloat   flicker;
+    GLfloat   padding[2];
+};
+
+// Trecho [begin, end) da fila ordenada desenhado de uma vez
+struct RenderRun
+{
+    size_t begin;
+    size_t end;
+    bool   instanced;
+    size_t firstInstance;  // em m_instances, se instanced
 };
 
 class Player;
@@ -48,6 +156,10 @@ public:
     ~Renderer();
 
     bool init(GLFWwindow* window);
+    // Pré-processa todas as texturas em .ktx (ver TextureBaker.h), sem GL
+    static bool bakeTextures();
+    // Monta o lote estático da arena (chão, paredes, teto, pilares e tochas)
+    void buildStaticBatch(const std::vector<Pillar>& pillars, const std::vector<Torch>& torches);
 
     void renderScene(const Player& player, const EnemyManager& enemyManager, const Enemy& dragonBoss, bool dragonBossAlive, float deltaTime, const ProjectileManager* projectileManager = nullptr);
     void renderScenePaused(const Player& player, const EnemyManager& enemyManager, const Enemy& dragonBoss, bool dragonBossAlive, const glm::vec4& cameraPosition, float deltaTime, const ProjectileManager* projectileManager = nullptr);
@@ -60,7 +172,6 @@ public:
     void renderEnemiesLookingAt(const EnemyManager& enemyManager, const glm::vec4& cameraPosition);
     void renderDragonBoss(const Enemy& dragon, bool isAlive, const glm::vec4& playerPosition);
     void renderDragonBossLookingAt(const Enemy& dragon, bool isAlive, const glm::vec4& cameraPosition);
-    void renderPillars(const std::vector<Pillar>& pillars);
     void renderHealthPickups(const std::vector<HealthPickup>& pickups, float deltaTime);
     void renderTorches(const std::vector<Torch>& torches, float deltaTime);
     void updateTorchLights(const std::vector<Torch>& torches, float flicker);
@@ -77,8 +188,18 @@ public:
 
     void setProjection(const glm::mat4& projection);
     void setView(const glm::mat4& view);
+    // Fração do tick atual já decorrida; entidades são desenhadas na posição
+    // interpolada entre o tick anterior e o atual
+    void setInterpolationAlpha(float alpha) { m_interpolationAlpha = alpha; }
+
+    // Ordena e desenha tudo o que os render* da cena submeteram. Chamado
+    // depois do último render* 3D do quadro e antes do texto/HUD
+    void flushRenderQueue();
+    const RenderStats& getFrameStats() const { return m_frameStats; }
+    // Desenha numa única chamada o texto de todos os render* de HUD, menus
+    // e overlays do quadro. Chamado uma vez, no fim do quadro
+    void flushText();
 
-    GLuint getGpuProgramID() const { return m_gpuProgramID; }
     float getScreenRatio() const { return m_screenRatio; }
     void setScreenRatio(float ratio) { m_screenRatio = ratio; }
 
@@ -86,39 +207,111 @@ private:
     GLuint buildGeometry();
 
     void computeNormals(ObjModel* model);
-    void buildTrianglesFromObj(ObjModel* model);
-    void drawVirtualObject(const std::string& object_name);
+    // Lê o .obj (ou o seu cache binário); roda num worker do AssetLoader
+    void prepareObjModel(MeshLoad& load);
+    void buildTrianglesFromObj(ObjModel* model, MeshData& mesh);
+    void uploadMesh(const MeshView& mesh);
+    MeshHandle addMesh(const std::string& key, const SceneObject& object);
+    MeshHandle findMesh(const std::string& key) const;
+    void resolveMeshHandles();
+    // Altura da base do modelo (bbox_min.y), 0 se o modelo não foi carregado
+    float meshBottom(MeshHandle mesh) const { return mesh != INVALID_MESH ? m_meshes[mesh].bbox_min.y : 0.0f; }
+
+    void submitMesh(RenderPass pass, MeshHandle mesh, int objectId, const glm::mat4& model);
+    void submitCube(RenderPass pass, int objectId, const glm::mat4& model);
+    void submitStaticBatch(RenderPass pass, const std::vector<StaticBatchRange>& ranges);
+    void submitStaticRange(RenderPass pass, const StaticBatchRange& range);
+    void submitEnemy(const EnemyManager& enemyManager, size_t i, float groundOffset, float rotationAngle);
+    float distanceToCamera(const glm::mat4& model) const;
+
+    // Frustum culling: os submit* descartam o que está fora do frustum de
+    // m_currentProjection * m_currentView, recalculado em setView/setProjection
+    void updateFrustum();
+    bool isVisible(const glm::vec3& worldMin, const glm::vec3& worldMax);
+    // Nível de detalhe de um objeto com a AABB dada (no mundo)
+    int selectLod(const SceneObject& object, const glm::vec3& worldMin, const glm::vec3& worldMax) const;
+
+    void initFrameUniforms();
+    void uploadFrameUniforms();
+
+    void initInstancing();
+    void enableInstanceAttributes();
+    void pointInstanceAttributes(size_t firstInstance);
 
     void loadShadersFromFiles();
-    void LoadTextureImage(const char* filename);
-    GLuint loadShader_Vertex(const char* filename);
-    GLuint loadShader_Fragment(const char* filename);
-    void loadShader(const char* filename, GLuint shader_id);
+    void createMaterialTextures(GLsizei layers);
+    void uploadTextureImage(TextureImage& image, GLint layer);
+    GLuint loadShader_Vertex(const char* filename, const std::string& defines);
+    GLuint loadShader_Fragment(const char* filename, const std::string& defines);
+    void loadShader(const char* filename, GLuint shader_id, const std::string& defines);
     GLuint createGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id);
+    // Permutação do material 'objectId', -1 se o material não existe
+    int permutationOf(int objectId) const;
 
     GLuint m_vertexArrayObjectID;
-    GLuint m_gpuProgramID;
 
-    GLint m_modelUniform;
-    GLint m_viewUniform;
-    GLint m_projectionUniform;
-    GLint m_renderAsBlackUniform;
-    GLint m_objectIdUniform;
-    GLint m_bbox_min_uniform;
-    GLint m_bbox_max_uniform;
+    // Um programa por permutação; m_materialPermutation[object_id] é o
+    // índice da permutação do material em m_permutations, e
+    // m_materialLayer[object_id] a camada da sua textura
+    std::vector<ShaderPermutation> m_permutations;
+    int m_materialPermutation[MAX_MATERIALS];
+    float m_materialLayer[MAX_MATERIALS];
 
-    GLint m_torchPositionsUniform;
-    GLint m_torchColorsUniform;
-    GLint m_torchIntensitiesUniform;
-    GLint m_numTorchesUniform;
+    // Fila de renderização do quadro, corridas e instâncias do flush e o
+    // VBO (de fluxo) que recebe as instâncias
+    RenderQueue m_renderQueue;
+    GLStateCache m_stateCache;
+    RenderStats m_frameStats;
+    std::vector<RenderRun> m_renderRuns;
+    std::vector<InstanceData> m_instances;
+    GLuint m_instanceVBO;
+    size_t m_instanceCapacity;
+
+    // Lote estático: opacos em [0, m_staticOpaqueCount), tochas em seguida;
+    // um trecho por objeto, na ordem do VBO
+    GLuint m_staticBatchVAO;
+    GLuint m_staticBatchVBO;
+    GLsizei m_staticOpaqueCount;
+    std::vector<StaticBatchRange> m_staticOpaqueRanges;
+    std::vector<StaticBatchRange> m_staticTorchRanges;
 
     GLuint m_NumLoadedTextures = 0;
-    std::map<std::string, SceneObject> m_virtualScene;
+    // GL_TEXTURE_2D_ARRAY com uma camada por textura de material
+    GLuint m_materialTextures;
+    // Texturas em BC1 (o contexto tem S3TC) e bytes que ocupam na GPU
+    bool m_textureCompression;
+    size_t m_textureBytes;
+    size_t m_uncompressedTextureBytes;
+    // Modelos carregados, indexados por MeshHandle; o mapa de nomes só é
+    // consultado no carregamento
+    std::vector<SceneObject> m_meshes;
+    std::map<std::string, MeshHandle> m_meshByName;
+
+    MeshHandle m_meshMonster;     // "turle"
+    MeshHandle m_meshArcher;      // "Arqueira"
+    MeshHandle m_meshWand;        // "Varinha"
+    MeshHandle m_meshDragon;      // "Mesh1.001"
+    MeshHandle m_meshHealth;      // "vida"
+    MeshHandle m_meshProjectile;  // "Sphere"
 
     glm::mat4 m_currentView;
     glm::mat4 m_currentProjection;
 
+    // Planos do frustum (normais para dentro) e contadores do culling desde
+    // o último flush
+    glm::vec4 m_frustumPlanes[6];
+    unsigned m_visibleObjects;
+    unsigned m_culledObjects;
+
+    // Uniforms por quadro (ver CameraUniforms) e o buffer que os recebe
+    CameraUniforms m_cameraUniforms;
+    TorchUniforms m_torchUniforms;
+    GLuint m_frameUBO;
+    GLintptr m_torchBlockOffset;
+    std::vector<unsigned char> m_frameUniformData;
+
     float m_screenRatio;
+    float m_interpolationAlpha;
 
     GLFWwindow* m_window;
 };
@@ -0,0 +1,63 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <vector>
+#include <utility>
+
+// ============================================================================
+// GRADE UNIFORME (BROAD PHASE)
+// ============================================================================
+// Divide o plano XZ da arena em células quadradas de mesmo tamanho. Cada
+// objeto é registrado (por um id inteiro, p.ex. o índice do inimigo) nas
+// células que a sua caixa XZ cobre; uma consulta retorna só os ids das
+// células que a caixa consultada cobre, sem repetição e em ordem qualquer
+// (quem precisa da ordem dos índices ordena o resultado, que é pequeno).
+//
+// Uso por tick:
+//     grid.clear();
+//     grid.insert(id, minX, minZ, maxX, maxZ);   // para cada objeto
+//     grid.build();
+//     grid.query(minX, minZ, maxX, maxZ, candidatos);
+//
+// build() agrupa os registros por célula com counting sort, em O(n). Objetos
+// fora dos limites da grade ficam nas células da borda, então a consulta
+// continua correta (só menos seletiva) fora da arena.
+// ============================================================================
+class SpatialGrid
+{
+public:
+    SpatialGrid();
+
+    void init(float minX, float minZ, float maxX, float maxZ, float cellSize);
+
+    void clear();
+    void insert(int id, float minX, float minZ, float maxX, float maxZ);
+    void insertPoint(int id, float x, float z) { insert(id, x, z, x, z); }
+    void build();
+
+    // Ids com alguma célula em comum com a caixa
+    void query(float minX, float minZ, float maxX, float maxZ, std::vector<int>& out) const;
+
+private:
+    int cellX(float x) const;
+    int cellZ(float z) const;
+
+    float m_minX;
+    float m_minZ;
+    float m_inverseCellSize;
+    int m_cellsX;
+    int m_cellsZ;
+    // Algum objeto ocupa mais de uma célula (a consulta precisa remover
+    // ids repetidos)
+    bool m_hasMultiCellObjects;
+
+    // (célula, id) inseridos desde o último clear()
+    std::vector<std::pair<int, int> > m_pending;
+    // Ids agrupados por célula: os da célula c estão em
+    // m_cellEntries[m_cellStart[c] .. m_cellStart[c + 1])
+    std::vector<int> m_cellStart;
+    std::vector<int> m_cellEntries;
+    std::vector<int> m_cursor;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef TEXTURE_BAKER_H
+#define TEXTURE_BAKER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "MeshCache.h"
+
+// ============================================================================
+// TEXTURAS PRÉ-PROCESSADAS (KTX + BC1)
+// ============================================================================
+// O JPG/PNG original é convertido uma vez em "<arquivo>.ktx": um KTX 1.1
+// comum (legível por ferramentas como o PVRTexTool), com a cadeia de mipmaps
+// completa já calculada e comprimida em BC1 (DXT1, 8 bytes por bloco de
+// 4x4 pixels: 0,5 byte por pixel, contra 3-4 do GL_SRGB8).
+//
+//   - Tamanho: a imagem é redimensionada para size x size, o tamanho das
+//     camadas do array de texturas dos materiais (ver Renderer::init).
+//     Filtro triangular em espaço linear, com repetição nas bordas.
+//   - Mipmaps: média 2x2 em espaço linear (as texturas são sRGB), até 1x1.
+//   - BC1: extremos pelo eixo principal das cores do bloco, refinados por
+//     mínimos quadrados com os índices escolhidos.
+//   - Metadados (pares chave/valor do KTX): hash FNV-1a do arquivo de origem
+//     e versão do baker, para o .ktx ser refeito quando algum dos dois muda.
+//
+// Sem suporte a S3TC no contexto, os níveis são descomprimidos na CPU
+// (DecodeBC1) e enviados como GL_SRGB8: ainda sem glGenerateMipmap.
+// ============================================================================
+static const uint32_t TEXTURE_BAKE_VERSION = 1;
+
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+
+struct BakedLevel
+{
+    int                  width;
+    int                  height;
+    const unsigned char* data;    // blocos BC1, linha a linha
+    size_t               size;
+};
+
+// Níveis de uma textura size x size, até 1x1
+int TextureLevelCount(int size);
+
+// Os níveis apontam para dentro do arquivo mapeado. Falha também se o .ktx
+// não tem size x size com todos os níveis
+bool ReadBakedTexture(const MappedFile& file, uint64_t sourceHash, int size, std::vector<BakedLevel>& levels);
+
+// Lê a imagem de origem com o stb_image (sem inverter as linhas: quem chama
+// define stbi_set_flip_vertically_on_load), redimensiona e gera os blocos
+// BC1 de cada nível
+bool BakeTextureLevels(const char* sourcePath, int size, std::vector< std::vector<unsigned char> >& levels);
+bool WriteBakedTexture(const char* bakedPath, uint64_t sourceHash, int size, const std::vector< std::vector<unsigned char> >& levels);
+
+// BakeTextureLevels + WriteBakedTexture
+bool BakeTexture(const char* sourcePath, const char* bakedPath, uint64_t sourceHash, int size);
+
+// Blocos BC1 de uma imagem width x height para RGB de 8 bits
+void DecodeBC1(const unsigned char* blocks, int width, int height, unsigned char* rgb);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef TIMING_STATS_H
+#define TIMING_STATS_H
+
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+// Amostras de tempo (em milissegundos) e resumo da distribuição, usado para
+// comparar tempos de tick e de frame entre builds ao reproduzir um replay
+class TimingStats
+{
+public:
+    void reserve(size_t count) { m_samples.reserve(count); }
+    void add(double milliseconds) { m_samples.push_back(milliseconds); }
+    void clear() { m_samples.clear(); }
+    size_t count() const { return m_samples.size(); }
+
+    // Imprime média, mínimo, percentis 50/90/99/99.9 e máximo
+    void print(const char* label) const
+    {
+        if (m_samples.empty())
+        {
+            printf("%s: no samples\n", label);
+            return;
+        }
+
+        std::vector<double> sorted(m_samples);
+        std::sort(sorted.begin(), sorted.end());
+
+        double sum = 0.0;
+        for (size_t i = 0; i < sorted.size(); i++)
+            sum += sorted[i];
+
+        printf("%s: n=%zu mean=%.4f min=%.4f p50=%.4f p90=%.4f p99=%.4f p99.9=%.4f max=%.4f (ms)\n",
+               label, sorted.size(), sum / sorted.size(), sorted.front(),
+               percentile(sorted, 0.50), percentile(sorted, 0.90),
+               percentile(sorted, 0.99), percentile(sorted, 0.999), sorted.back());
+    }
+
+private:
+    static double percentile(const std::vector<double>& sorted, double p)
+    {
+        size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+    std::vector<double> m_samples;
+};
+
+#endif
@@ -23,4 +23,11 @@ bool testBezierAABB(const glm::vec4& p0, const glm::vec4& p1,
 bool testPointExpandedAABB(const glm::vec3& point, float radius,
                            const glm::vec3& boxMin, const glm::vec3& boxMax);
 
+void transformAABB(const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax,
+                   glm::vec3& worldMin, glm::vec3& worldMax);
+
+void extractFrustumPlanes(const glm::mat4& clip, glm::vec4 planes[6]);
+
+bool testAABBFrustum(const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::vec4 planes[6]);
+
 #endif
@@ -16,11 +16,13 @@ public:
     void vitoria();
     void musicaPrincipalStart(const char* filename, bool loop);
     void musicaPrincipalStop();
+    // Silencia todos os sons (modo headless, sem dispositivo de áudio)
+    void setMuted(bool m) { muted = m; }
 private:
     ma_engine engine;
     ma_sound musica_principal;
     bool initialized = false;
     bool musicLoaded = false;
+    bool muted = false;
 };
-extern Sfx sfx;
 #endif // SFX_H
@@ -0,0 +1,121 @@
+// ============================================================================
+// ASSETLOADER.CPP - Carregamento Paralelo de Recursos
+// ============================================================================
+//
+// Mesmo esquema do BatchRunner: os workers pegam a próxima tarefa de um
+// contador atômico. Cada tarefa concluída entra numa fila protegida por
+// mutex, e a thread do GL dorme numa variável de condição até haver algo
+// para enviar à GPU.
+//
+// ============================================================================
+
+#include "AssetLoader.h"
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+
+void AssetLoader::add(const std::string& name, const std::function<void()>& work, const std::function<void()>& upload)
+{
+    Task task;
+    task.name = name;
+    task.work = work;
+    task.upload = upload;
+    task.workMs = 0.0;
+    m_tasks.push_back(task);
+}
+
+void AssetLoader::run(int threads)
+{
+    if (m_tasks.empty())
+        return;
+    if (threads < 1)
+        threads = 1;
+    if (threads > (int)m_tasks.size())
+        threads = (int)m_tasks.size();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::atomic<size_t> nextTask(0);
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::deque<size_t> completed;
+    std::vector<Task>& tasks = m_tasks;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.push_back(std::thread([&tasks, &nextTask, &mutex, &finished, &completed]()
+        {
+            for (;;)
+            {
+                size_t index = nextTask.fetch_add(1);
+                if (index >= tasks.size())
+                    break;
+
+                Task& task = tasks[index];
+                std::chrono::steady_clock::time_point taskStart = std::chrono::steady_clock::now();
+                try {
+                    task.work();
+                } catch (...) {
+                    task.error = std::current_exception();
+                }
+                task.workMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - taskStart).count();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(index);
+                finished.notify_one();
+            }
+        }));
+    }
+
+    // Uploads na thread do GL, na ordem de conclusão
+    std::exception_ptr firstError;
+    for (size_t uploaded = 0; uploaded < tasks.size(); uploaded++)
+    {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (completed.empty())
+                finished.wait(lock);
+            index = completed.front();
+            completed.pop_front();
+        }
+
+        Task& task = tasks[index];
+        if (task.error)
+        {
+            if (!firstError)
+                firstError = task.error;
+            continue;
+        }
+        try {
+            task.upload();
+        } catch (...) {
+            if (!firstError)
+                firstError = std::current_exception();
+        }
+    }
+
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    double sum = 0.0;
+    size_t slowest = 0;
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        sum += tasks[i].workMs;
+        if (tasks[i].workMs > tasks[slowest].workMs)
+            slowest = i;
+    }
+    printf("[Assets] %zu assets on %d thread(s) in %.1f ms (work sum %.1f ms, slowest \"%s\" %.1f ms)\n",
+           tasks.size(), threads, elapsed, sum, tasks[slowest].name.c_str(), tasks[slowest].workMs);
+
+    m_tasks.clear();
+    if (firstError)
+        std::rethrow_exception(firstError);
+}
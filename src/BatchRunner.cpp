@@ -0,0 +1,119 @@
+// ============================================================================
+// BATCHRUNNER.CPP - Várias Arenas Headless em Paralelo
+// ============================================================================
+//
+// Cada arena é um Game inicializado com initHeadless(): não há estado
+// compartilhado entre elas (áudio, entrada e gerador aleatório pertencem a
+// cada Game), então podem ser simuladas em threads diferentes sem travas.
+//
+// O pool de threads distribui as arenas dinamicamente: cada worker pega o
+// próximo índice livre de um contador atômico e simula aquela arena por
+// m_ticksPerArena ticks. Como as arenas não se comunicam, a vazão cresce
+// linearmente com o número de núcleos enquanto houver arenas suficientes.
+//
+// Cada arena tem semente própria (baseSeed + i), então o resultado não
+// depende de qual thread simulou qual arena: o hash de estado impresso
+// deve ser o mesmo para qualquer número de threads.
+//
+// ============================================================================
+
+#include "BatchRunner.h"
+#include "Game.h"
+#include <cstdio>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+BatchRunner::BatchRunner(int arenas, long long ticksPerArena, int difficulty, float tickRate, uint64_t baseSeed)
+    : m_arenas(arenas < 1 ? 1 : arenas)
+    , m_ticksPerArena(ticksPerArena < 1 ? 1 : ticksPerArena)
+    , m_difficulty(difficulty)
+    , m_tickRate(tickRate)
+    , m_baseSeed(baseSeed)
+{
+}
+
+void BatchRunner::run(int maxThreads)
+{
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    printf("[Batch] %d arenas x %lld ticks, difficulty %d, %.0f Hz, seeds %llu..%llu, up to %d threads\n",
+           m_arenas, m_ticksPerArena, m_difficulty, m_tickRate,
+           (unsigned long long)m_baseSeed, (unsigned long long)(m_baseSeed + m_arenas - 1), maxThreads);
+
+    // 1, 2, 4, ... e por fim maxThreads, se não for potência de 2
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    long long totalTicks = m_ticksPerArena * m_arenas;
+    double baseTicksPerSecond = 0.0;
+
+    for (size_t i = 0; i < threadCounts.size(); i++)
+    {
+        int threads = threadCounts[i];
+        uint64_t stateHash = 0;
+        double elapsed = runWithThreads(threads, stateHash);
+        double ticksPerSecond = elapsed > 0.0 ? totalTicks / elapsed : 0.0;
+        if (i == 0)
+            baseTicksPerSecond = ticksPerSecond;
+
+        double speedup = baseTicksPerSecond > 0.0 ? ticksPerSecond / baseTicksPerSecond : 0.0;
+        printf("[Batch] %2d thread(s): %lld ticks in %.3f s: %.0f ticks/s (speedup %.2fx, efficiency %.0f%%), state %016llx\n",
+               threads, totalTicks, elapsed, ticksPerSecond, speedup, 100.0 * speedup / threads,
+               (unsigned long long)stateHash);
+    }
+}
+
+double BatchRunner::runWithThreads(int threads, uint64_t& stateHash)
+{
+    // As arenas são criadas na thread principal: initHeadless() também
+    // desliga o Logger, que é global, antes de qualquer worker começar
+    std::vector<std::unique_ptr<Game> > games;
+    games.reserve(m_arenas);
+    for (int i = 0; i < m_arenas; i++)
+    {
+        std::unique_ptr<Game> game(new Game());
+        game->setTickRate(m_tickRate);
+        game->setDifficulty(m_difficulty);
+        game->setRandomSeed(m_baseSeed + i);
+        game->initHeadless();
+        games.push_back(std::move(game));
+    }
+
+    std::atomic<int> nextArena(0);
+    long long ticksPerArena = m_ticksPerArena;
+    int arenas = m_arenas;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.push_back(std::thread([&games, &nextArena, ticksPerArena, arenas]()
+        {
+            for (;;)
+            {
+                int arena = nextArena.fetch_add(1);
+                if (arena >= arenas)
+                    break;
+                games[arena]->stepHeadless(ticksPerArena);
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    stateHash = 0;
+    for (int i = 0; i < m_arenas; i++)
+        stateHash = stateHash * 31 + games[i]->computeStateHash();
+
+    return std::chrono::duration<double>(end - start).count();
+}
@@ -7,6 +7,7 @@
 // - Conversão de curvas Hermite para Bézier
 // - Continuidade C1 entre curvas consecutivas
 // - Sistema de knockback e recálculo de trajetória
+// - Avaliação da curva em lote (SSE2/AVX) sobre os arrays do EnemyManager
 //
 // REQUISITOS IMPLEMENTADOS:
 // - REQUISITO 4: Instâncias de objetos (EnemyManager gerencia múltiplos inimigos)
@@ -33,26 +34,43 @@
 #include "Enemy.h"
 #include "Player.h"
 #include "matrices.h"
+#include "Random.h"
 #include "sfx.h"
 #include <cmath>
-#include <cstdlib>
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ENEMY_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENEMY_SIMD_SSE2
+#endif
+
+// Ângulo em Y para um objeto em 'position' olhar para 'targetPosition'
+static float yawTowards(const glm::vec4& position, const glm::vec4& targetPosition)
+{
+    glm::vec4 vetor_front = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
+    glm::vec4 olha_target = targetPosition - position;
+
+    if (norm(vetor_front) == 0 || norm(olha_target) == 0)
+        return 0.0f;
+
+    float angulo = acos(dotproduct(olha_target, vetor_front) / (norm(vetor_front) * norm(olha_target)));
+
+    if (olha_target.x * vetor_front.z - olha_target.z * vetor_front.x < 0)
+        angulo = -angulo;
+
+    return angulo;
+}
 
 Enemy::Enemy(float x, float z, int vida)
     : m_x(x)
     , m_z(z)
+    , m_previousX(x)
+    , m_previousZ(z)
     , m_vida(vida)
-    , m_enemySpeed(0.4f)
-    , m_knockbackVelX(0.0f)
-    , m_knockbackVelZ(0.0f)
-    , m_bezierP0(x, 0.0f, z, 1.0f)
-    , m_bezierP1(x, 0.0f, z, 1.0f)
-    , m_bezierP2(x, 0.0f, z, 1.0f)
-    , m_bezierP3(x, 0.0f, z, 1.0f)
-    , m_bezierT(0.0f)
-    , m_curveRecalcTimer(0.0f)
-    , m_curveInitialized(false)
-    , m_dying(false)
-    , m_deathTimer(0.0f)
+    , m_sfx(nullptr)
 {
 }
 
@@ -60,86 +78,261 @@ Enemy::~Enemy()
 {
 }
 
+glm::vec4 Enemy::getInterpolatedPosition(float alpha) const
+{
+    float x = m_previousX + (m_x - m_previousX) * alpha;
+    float z = m_previousZ + (m_z - m_previousZ) * alpha;
+    return glm::vec4(x, 0.101f, z, 1.0f);
+}
+
+float Enemy::lookAt(const glm::vec4& targetPosition) const
+{
+    return yawTowards(getPosition(), targetPosition);
+}
+
+void Enemy::takeDamage(int damage)
+{
+    m_vida -= damage;
+    if (m_vida < 0)
+        m_vida = 0;
+    else if (m_sfx){
+        m_sfx->hit_monstro();
+    }
+}
+
+// ============================================================================
+// AVALIAÇÃO DA CURVA DE BÉZIER CÚBICA EM LOTE
+// ============================================================================
+// Avalia uma coordenada (x ou z) da curva de 'count' inimigos:
+//     c(t) = (1-t)³P0 + 3(1-t)²tP1 + 3(1-t)t²P2 + t³P3
+//
+// Só escreve out[i] onde mask[i] != 0 (inimigos seguindo a curva); os
+// demais (em knockback ou morrendo) mantêm a posição atual. A versão AVX
+// processa 8 inimigos por iteração, a SSE2 4, e o restante é escalar.
+// As operações seguem a mesma ordem nas três versões, de modo que o
+// resultado não depende do caminho usado.
+// ============================================================================
+static inline float evaluateBezier(float t, float p0, float p1, float p2, float p3)
+{
+    float u = 1.0f - t;
+    float u2 = u * u;
+    float u3 = u2 * u;
+    float t2 = t * t;
+    float t3 = t2 * t;
+
+    return u3 * p0
+         + 3.0f * u2 * t * p1
+         + 3.0f * u * t2 * p2
+         + t3 * p3;
+}
+
+static void evaluateBezierBatch(const float* t,
+                                const float* p0, const float* p1,
+                                const float* p2, const float* p3,
+                                const int32_t* mask, float* out, size_t count)
+{
+    size_t i = 0;
+
+#if defined(ENEMY_SIMD_AVX)
+    const __m256 one8 = _mm256_set1_ps(1.0f);
+    const __m256 three8 = _mm256_set1_ps(3.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vt = _mm256_loadu_ps(t + i);
+        __m256 u = _mm256_sub_ps(one8, vt);
+        __m256 u2 = _mm256_mul_ps(u, u);
+        __m256 u3 = _mm256_mul_ps(u2, u);
+        __m256 t2 = _mm256_mul_ps(vt, vt);
+        __m256 t3 = _mm256_mul_ps(t2, vt);
+        __m256 b1 = _mm256_mul_ps(_mm256_mul_ps(three8, u2), vt);
+        __m256 b2 = _mm256_mul_ps(_mm256_mul_ps(three8, u), t2);
+
+        __m256 c = _mm256_mul_ps(u3, _mm256_loadu_ps(p0 + i));
+        c = _mm256_add_ps(c, _mm256_mul_ps(b1, _mm256_loadu_ps(p1 + i)));
+        c = _mm256_add_ps(c, _mm256_mul_ps(b2, _mm256_loadu_ps(p2 + i)));
+        c = _mm256_add_ps(c, _mm256_mul_ps(t3, _mm256_loadu_ps(p3 + i)));
+
+        __m256 m = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i)));
+        _mm256_storeu_ps(out + i, _mm256_blendv_ps(_mm256_loadu_ps(out + i), c, m));
+    }
+#endif
+
+#if defined(ENEMY_SIMD_AVX) || defined(ENEMY_SIMD_SSE2)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 three = _mm_set1_ps(3.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vt = _mm_loadu_ps(t + i);
+        __m128 u = _mm_sub_ps(one, vt);
+        __m128 u2 = _mm_mul_ps(u, u);
+        __m128 u3 = _mm_mul_ps(u2, u);
+        __m128 t2 = _mm_mul_ps(vt, vt);
+        __m128 t3 = _mm_mul_ps(t2, vt);
+        __m128 b1 = _mm_mul_ps(_mm_mul_ps(three, u2), vt);
+        __m128 b2 = _mm_mul_ps(_mm_mul_ps(three, u), t2);
+
+        __m128 c = _mm_mul_ps(u3, _mm_loadu_ps(p0 + i));
+        c = _mm_add_ps(c, _mm_mul_ps(b1, _mm_loadu_ps(p1 + i)));
+        c = _mm_add_ps(c, _mm_mul_ps(b2, _mm_loadu_ps(p2 + i)));
+        c = _mm_add_ps(c, _mm_mul_ps(t3, _mm_loadu_ps(p3 + i)));
+
+        // out = mask ? c : out
+        __m128 m = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i)));
+        __m128 old = _mm_loadu_ps(out + i);
+        _mm_storeu_ps(out + i, _mm_or_ps(_mm_and_ps(m, c), _mm_andnot_ps(m, old)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (mask[i])
+            out[i] = evaluateBezier(t[i], p0[i], p1[i], p2[i], p3[i]);
+    }
+}
+
+EnemyManager::EnemyManager()
+    : m_previousSecond(-1)
+    , m_maxEnemies(2)
+    , m_spawnInterval(5)
+    , m_enemySpeed(0.4f)
+    , m_difficulty(1)
+    , m_sfx(nullptr)
+{
+}
+
+EnemyManager::~EnemyManager()
+{
+}
+
+int EnemyManager::getRandomEnemyHP(Random& random)
+{
+    int roll = random.nextInt(100);
+    int easyChance, mediumChance;
+
+    switch (m_difficulty) {
+        case 0: easyChance = 70; mediumChance = 95; break;
+        case 1: easyChance = 33; mediumChance = 67; break;
+        case 2: easyChance = 5;  mediumChance = 30; break;
+        default: easyChance = 33; mediumChance = 67; break;
+    }
+
+    if (roll < easyChance) {
+        return 200 + random.nextInt(101);  // 200-300 HP
+    } else if (roll < mediumChance) {
+        return 400 + random.nextInt(101);  // 400-500 HP
+    } else {
+        return 600 + random.nextInt(101);  // 600-700 HP
+    }
+}
+
 // ============================================================================
-// ATUALIZAÇÃO DO INIMIGO
+// ATUALIZAÇÃO DOS INIMIGOS
 // ============================================================================
 // REQUISITO 9: Movimentação com curva de Bézier cúbica
 // REQUISITO 10: Animações baseadas no tempo
 //
-// O inimigo se move ao longo de uma curva de Bézier em direção ao jogador.
-// O parâmetro t da curva é incrementado baseado no tempo:
+// Cada inimigo se move ao longo de uma curva de Bézier em direção ao
+// jogador. O parâmetro t da curva é incrementado baseado no tempo:
 //     t += (velocidade * deltaTime) / distância
 //
 // Quando t >= 1 ou o timer expira, uma nova curva é calculada
 // para perseguir a nova posição do jogador.
+//
+// O update é feito em três passadas sobre os arrays:
+//   1. Escalar: animação de morte, knockback, avanço de t e recálculo das
+//      curvas (que sorteia valores, então segue a ordem dos inimigos)
+//   2. SIMD: avaliação da Bézier de todos os inimigos que seguem a curva
+//   3. Escalar: limites da arena
 // ============================================================================
-void Enemy::update(float deltaTime, const Player& player)
+void EnemyManager::update(float deltaTime, const Player& player, Random& random)
 {
-    // Animação de morte: apenas incrementa o timer
-    if (m_dying)
-    {
-        m_deathTimer += deltaTime;
+    const size_t count = m_x.size();
+    if (count == 0)
         return;
-    }
 
     glm::vec4 playerPos = player.getPosition();
 
-    // Verifica se o inimigo está em knockback (foi empurrado pelo jogador)
-    bool inKnockback = (m_knockbackVelX != 0.0f || m_knockbackVelZ != 0.0f);
+    for (size_t i = 0; i < count; i++)
+    {
+        m_followsCurve[i] = 0;
+
+        // Animação de morte: apenas incrementa o timer
+        if (m_dying[i])
+        {
+            m_deathTimer[i] += deltaTime;
+            continue;
+        }
 
-    if (inKnockback) {
-        m_x += m_knockbackVelX * deltaTime;
-        m_z += m_knockbackVelZ * deltaTime;
+        // Verifica se o inimigo está em knockback (foi empurrado pelo jogador)
+        if (m_knockbackVelX[i] != 0.0f || m_knockbackVelZ[i] != 0.0f)
+        {
+            m_x[i] += m_knockbackVelX[i] * deltaTime;
+            m_z[i] += m_knockbackVelZ[i] * deltaTime;
 
-        float decay = 8.0f * deltaTime;
-        m_knockbackVelX *= std::max(0.0f, 1.0f - decay);
-        m_knockbackVelZ *= std::max(0.0f, 1.0f - decay);
+            float decay = 8.0f * deltaTime;
+            m_knockbackVelX[i] *= std::max(0.0f, 1.0f - decay);
+            m_knockbackVelZ[i] *= std::max(0.0f, 1.0f - decay);
 
-        if (std::abs(m_knockbackVelX) < 0.05f && std::abs(m_knockbackVelZ) < 0.05f) {
-            m_knockbackVelX = 0.0f;
-            m_knockbackVelZ = 0.0f;
-            m_bezierP0 = glm::vec4(m_x, 0.0f, m_z, 1.0f);
-            m_bezierT = 0.0f;
-            m_curveRecalcTimer = 0.0f;
-            m_curveInitialized = false;
-        }
-    } else {
-        if (!m_curveInitialized) {
-            recalculateCurve(playerPos);
-            m_curveInitialized = true;
+            if (std::abs(m_knockbackVelX[i]) < 0.05f && std::abs(m_knockbackVelZ[i]) < 0.05f)
+            {
+                m_knockbackVelX[i] = 0.0f;
+                m_knockbackVelZ[i] = 0.0f;
+                m_p0x[i] = m_x[i];
+                m_p0z[i] = m_z[i];
+                m_bezierT[i] = 0.0f;
+                m_curveRecalcTimer[i] = 0.0f;
+                m_curveInitialized[i] = 0;
+            }
+            continue;
         }
 
-        m_curveRecalcTimer -= deltaTime;
+        m_followsCurve[i] = -1;
 
-        float distance = norm(m_bezierP3 - m_bezierP0);
-        if (distance > 0.001f) {
-            m_bezierT += (m_enemySpeed * deltaTime) / distance;
+        if (!m_curveInitialized[i])
+        {
+            recalculateCurve(i, playerPos, random);
+            m_curveInitialized[i] = 1;
         }
 
-        if (m_bezierT >= 1.0f || m_curveRecalcTimer <= 0.0f) {
-            m_bezierT = std::min(m_bezierT, 1.0f);
-            recalculateCurve(playerPos);
-        }
+        m_curveRecalcTimer[i] -= deltaTime;
+
+        float dx = m_p3x[i] - m_p0x[i];
+        float dz = m_p3z[i] - m_p0z[i];
+        float distance = std::sqrt(dx * dx + dz * dz);
+        if (distance > 0.001f)
+            m_bezierT[i] += (m_speed[i] * deltaTime) / distance;
 
-        glm::vec4 newPos = evaluateBezier(m_bezierT);
-        m_x = newPos.x;
-        m_z = newPos.z;
+        if (m_bezierT[i] >= 1.0f || m_curveRecalcTimer[i] <= 0.0f)
+        {
+            m_bezierT[i] = std::min(m_bezierT[i], 1.0f);
+            recalculateCurve(i, playerPos, random);
+        }
     }
 
+    evaluateBezierBatch(&m_bezierT[0], &m_p0x[0], &m_p1x[0], &m_p2x[0], &m_p3x[0],
+                        &m_followsCurve[0], &m_x[0], count);
+    evaluateBezierBatch(&m_bezierT[0], &m_p0z[0], &m_p1z[0], &m_p2z[0], &m_p3z[0],
+                        &m_followsCurve[0], &m_z[0], count);
+
     const float arenaMinX = -4.2f;
     const float arenaMaxX = 4.2f;
     const float arenaMinZ = -1.2f;
     const float arenaMaxZ = 1.2f;
 
-    bool hitWall = false;
-    if (m_x < arenaMinX) { m_x = arenaMinX; hitWall = true; }
-    if (m_x > arenaMaxX) { m_x = arenaMaxX; hitWall = true; }
-    if (m_z < arenaMinZ) { m_z = arenaMinZ; hitWall = true; }
-    if (m_z > arenaMaxZ) { m_z = arenaMaxZ; hitWall = true; }
-
-    // recalcula a curva se bate numa parede
-    if (hitWall && !inKnockback) {
-        onObstacleCollision();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (m_dying[i])
+            continue;
+
+        bool hitWall = false;
+        if (m_x[i] < arenaMinX) { m_x[i] = arenaMinX; hitWall = true; }
+        if (m_x[i] > arenaMaxX) { m_x[i] = arenaMaxX; hitWall = true; }
+        if (m_z[i] < arenaMinZ) { m_z[i] = arenaMinZ; hitWall = true; }
+        if (m_z[i] > arenaMaxZ) { m_z[i] = arenaMaxZ; hitWall = true; }
+
+        // recalcula a curva se bate numa parede
+        if (hitWall && m_followsCurve[i])
+            onObstacleCollision(i);
     }
 }
 
@@ -158,22 +351,27 @@ void Enemy::update(float deltaTime, const Player& player)
 // CATMULL-ROM (para curva inicial):
 //    Quando não há curva anterior, usamos a fórmula de Catmull-Rom:
 // ============================================================================
-void Enemy::recalculateCurve(const glm::vec4& playerPos)
+void EnemyManager::recalculateCurve(size_t i, const glm::vec4& playerPos, Random& random)
 {
     // P0: posição atual do inimigo (início da curva)
-    m_bezierP0 = glm::vec4(m_x, 0.0f, m_z, 1.0f);
+    glm::vec4 p0(m_x[i], 0.0f, m_z[i], 1.0f);
+    m_p0x[i] = p0.x;
+    m_p0z[i] = p0.z;
 
     // P3: posição do jogador (fim da curva)
-    m_bezierP3 = glm::vec4(playerPos.x, 0.0f, playerPos.z, 1.0f);
+    glm::vec4 p3(playerPos.x, 0.0f, playerPos.z, 1.0f);
+    m_p3x[i] = p3.x;
+    m_p3z[i] = p3.z;
 
     // Vetor direção e distância até o alvo
-    glm::vec4 toTarget = m_bezierP3 - m_bezierP0;
+    glm::vec4 toTarget = p3 - p0;
     float distance = norm(toTarget);
 
+    glm::vec4 p1, p2;
     if (distance < 0.01f) {
         // Muito perto do alvo: curva degenerada (linha reta)
-        m_bezierP1 = m_bezierP0;
-        m_bezierP2 = m_bezierP3;
+        p1 = p0;
+        p2 = p3;
     } else {
         // Direção normalizada e vetor perpendicular (para variação)
         glm::vec4 dir = toTarget / distance;
@@ -185,9 +383,11 @@ void Enemy::recalculateCurve(const glm::vec4& playerPos)
         // Se já existe uma curva, usa a derivada atual para manter
         // a velocidade contínua (sem "saltos" na direção do movimento)
         glm::vec4 v0;
-        if (m_curveInitialized && m_bezierT > 0.001f) {
+        if (m_curveInitialized[i] && m_bezierT[i] > 0.001f) {
             // Continuidade C1: v0 = derivada da curva anterior no ponto atual
-            v0 = evaluateBezierDerivative(m_bezierT);
+            float dx, dz;
+            evaluateBezierDerivative(i, m_bezierT[i], dx, dz);
+            v0 = glm::vec4(dx, 0.0f, dz, 0.0f);
         } else {
             // Sem curva anterior: usa fórmula de Catmull-Rom 
             v0 = toTarget * 0.5f;
@@ -198,8 +398,8 @@ void Enemy::recalculateCurve(const glm::vec4& playerPos)
         // ================================================================
         // Direção base para o alvo com offset perpendicular aleatório
         // Isso cria trajetórias mais interessantes (curvas S ou C)
-        float side = (rand() % 2 == 0) ? 1.0f : -1.0f;
-        float perpOffset = ((float)rand() / RAND_MAX) * 0.3f;
+        float side = (random.nextInt(2) == 0) ? 1.0f : -1.0f;
+        float perpOffset = random.nextFloat() * 0.3f;
         glm::vec4 approachDir = dir + perp * (side * perpOffset);
         float approachMag = norm(approachDir);
         if (approachMag > 0.001f) {
@@ -214,8 +414,8 @@ void Enemy::recalculateCurve(const glm::vec4& playerPos)
         // Das notas de aula:
         //   P1 = P0 + v0/3  (ponto de controle inicial)
         //   P2 = P3 - v1/3  (ponto de controle final)
-        m_bezierP1 = m_bezierP0 + v0 * (1.0f / 3.0f);
-        m_bezierP2 = m_bezierP3 - v1 * (1.0f / 3.0f);
+        p1 = p0 + v0 * (1.0f / 3.0f);
+        p2 = p3 - v1 * (1.0f / 3.0f);
 
         // Restringe pontos de controle aos limites da arena
         // (evita trajetórias que saem muito da área de jogo)
@@ -224,38 +424,19 @@ void Enemy::recalculateCurve(const glm::vec4& playerPos)
         const float arenaMinZ = -1.1f;
         const float arenaMaxZ = 1.1f;
 
-        m_bezierP1.x = std::max(arenaMinX, std::min(m_bezierP1.x, arenaMaxX));
-        m_bezierP1.z = std::max(arenaMinZ, std::min(m_bezierP1.z, arenaMaxZ));
-        m_bezierP2.x = std::max(arenaMinX, std::min(m_bezierP2.x, arenaMaxX));
-        m_bezierP2.z = std::max(arenaMinZ, std::min(m_bezierP2.z, arenaMaxZ));
+        p1.x = std::max(arenaMinX, std::min(p1.x, arenaMaxX));
+        p1.z = std::max(arenaMinZ, std::min(p1.z, arenaMaxZ));
+        p2.x = std::max(arenaMinX, std::min(p2.x, arenaMaxX));
+        p2.z = std::max(arenaMinZ, std::min(p2.z, arenaMaxZ));
     }
 
+    m_p1x[i] = p1.x; m_p1z[i] = p1.z;
+    m_p2x[i] = p2.x; m_p2z[i] = p2.z;
+
     // Reinicia o parâmetro t para o início da nova curva
-    m_bezierT = 0.0f;
+    m_bezierT[i] = 0.0f;
     // Timer para recalcular a curva periodicamente (2-3 segundos)
-    m_curveRecalcTimer = 2.0f + ((float)rand() / RAND_MAX) * 1.0f;
-}
-
-// ============================================================================
-// AVALIAÇÃO DA CURVA DE BÉZIER CÚBICA
-// ============================================================================
-// ============================================================================
-glm::vec4 Enemy::evaluateBezier(float t) const
-{
-    // Calcula (1-t) e suas potências
-    float u = 1.0f - t;      // u = (1-t)
-    float u2 = u * u;        // u² = (1-t)²
-    float u3 = u2 * u;       // u³ = (1-t)³
-
-    // Calcula t e suas potências
-    float t2 = t * t;        // t²
-    float t3 = t2 * t;       // t³
-
-    // Avalia a curva usando polinômios de Bernstein:
-    return u3 * m_bezierP0              // b₀,₃(t)·P0
-         + 3.0f * u2 * t * m_bezierP1   // b₁,₃(t)·P1
-         + 3.0f * u * t2 * m_bezierP2   // b₂,₃(t)·P2
-         + t3 * m_bezierP3;             // b₃,₃(t)·P3
+    m_curveRecalcTimer[i] = 2.0f + random.nextFloat() * 1.0f;
 }
 
 // ============================================================================
@@ -268,180 +449,284 @@ glm::vec4 Enemy::evaluateBezier(float t) const
 // Esta função é usada para obter a velocidade atual do inimigo
 // e garantir transições suaves entre curvas consecutivas.
 // ============================================================================
-glm::vec4 Enemy::evaluateBezierDerivative(float t) const
+void EnemyManager::evaluateBezierDerivative(size_t i, float t, float& dx, float& dz) const
 {
     float u = 1.0f - t;  // u = (1-t)
 
     // Derivada: c'(t) = 3(1-t)²(P1-P0) + 6(1-t)t(P2-P1) + 3t²(P3-P2)
-    return 3.0f * u * u * (m_bezierP1 - m_bezierP0)      // 3(1-t)²(P1-P0)
-         + 6.0f * u * t * (m_bezierP2 - m_bezierP1)      // 6(1-t)t(P2-P1)
-         + 3.0f * t * t * (m_bezierP3 - m_bezierP2);     // 3t²(P3-P2)
+    dx = 3.0f * u * u * (m_p1x[i] - m_p0x[i])
+       + 6.0f * u * t * (m_p2x[i] - m_p1x[i])
+       + 3.0f * t * t * (m_p3x[i] - m_p2x[i]);
+    dz = 3.0f * u * u * (m_p1z[i] - m_p0z[i])
+       + 6.0f * u * t * (m_p2z[i] - m_p1z[i])
+       + 3.0f * t * t * (m_p3z[i] - m_p2z[i]);
 }
 
-float Enemy::lookAt(const glm::vec4& targetPosition) const
+glm::vec4 EnemyManager::getInterpolatedPosition(size_t i, float alpha) const
 {
-    glm::vec4 vetor_front = glm::vec4(0.0f, 0.0f, 1.0f, 0.0f);
-    glm::vec4 olha_target = targetPosition - getPosition();
-
-    if (norm(vetor_front) == 0 || norm(olha_target) == 0)
-        return 0.0f;
-
-    float angulo = acos(dotproduct(olha_target, vetor_front) / (norm(vetor_front) * norm(olha_target)));
-
-    if (olha_target.x * vetor_front.z - olha_target.z * vetor_front.x < 0)
-        angulo = -angulo;
+    float x = m_previousX[i] + (m_x[i] - m_previousX[i]) * alpha;
+    float z = m_previousZ[i] + (m_z[i] - m_previousZ[i]) * alpha;
+    return glm::vec4(x, 0.101f, z, 1.0f);
+}
 
-    return angulo;
+float EnemyManager::lookAt(size_t i, const glm::vec4& targetPosition) const
+{
+    return yawTowards(getPosition(i), targetPosition);
 }
 
-void Enemy::takeDamage(int damage)
+void EnemyManager::takeDamage(size_t i, int damage)
 {
-    m_vida -= damage;
-    if (m_vida < 0)
-        m_vida = 0;
-    else{
-        sfx.hit_monstro();
+    m_vida[i] -= damage;
+    if (m_vida[i] < 0)
+        m_vida[i] = 0;
+    else if (m_sfx){
+        m_sfx->hit_monstro();
     }
 }
 
-void Enemy::applyKnockback(float dirX, float dirZ, float force)
+void EnemyManager::applyKnockback(size_t i, float dirX, float dirZ, float force)
 {
-    m_knockbackVelX = dirX * force;
-    m_knockbackVelZ = dirZ * force;
+    m_knockbackVelX[i] = dirX * force;
+    m_knockbackVelZ[i] = dirZ * force;
 }
 
-void Enemy::onObstacleCollision()
+void EnemyManager::onObstacleCollision(size_t i)
 {
-    m_bezierP0 = glm::vec4(m_x, 0.0f, m_z, 1.0f);
-    m_bezierT = 0.0f;
-    m_curveRecalcTimer = 0.0f; 
-    m_curveInitialized = false;
+    m_p0x[i] = m_x[i];
+    m_p0z[i] = m_z[i];
+    m_bezierT[i] = 0.0f;
+    m_curveRecalcTimer[i] = 0.0f;
+    m_curveInitialized[i] = 0;
 }
 
-void Enemy::startDying()
+void EnemyManager::startDying(size_t i)
 {
-    if (!m_dying)
+    if (!m_dying[i])
     {
-        m_dying = true;
-        m_deathTimer = 0.0f;
-        sfx.morte_monstro();
+        m_dying[i] = 1;
+        m_deathTimer[i] = 0.0f;
+        if (m_sfx)
+            m_sfx->morte_monstro();
     }
 }
 
-float Enemy::getDeathProgress() const
+float EnemyManager::getDeathProgress(size_t i) const
 {
-    if (!m_dying) return 0.0f;
-    return std::min(m_deathTimer / DEATH_ANIM_DURATION, 1.0f);
+    if (!m_dying[i]) return 0.0f;
+    return std::min(m_deathTimer[i] / DEATH_ANIM_DURATION, 1.0f);
 }
 
-float Enemy::getDeathScale() const
+float EnemyManager::getDeathScale(size_t i) const
 {
-    if (!m_dying) return 1.0f;
-    float t = getDeathProgress();
+    if (!m_dying[i]) return 1.0f;
+    float t = getDeathProgress(i);
     return 1.0f + t * (2.0f - t);
 }
 
-bool Enemy::isReadyForRemoval() const
+void EnemyManager::storePreviousState()
 {
-    return m_dying && m_deathTimer >= DEATH_ANIM_DURATION;
+    m_previousX = m_x;
+    m_previousZ = m_z;
 }
 
-EnemyManager::EnemyManager()
-    : m_previousSecond(-1)
-    , m_maxEnemies(2)
-    , m_spawnInterval(5)
-    , m_enemySpeed(0.4f)
-    , m_difficulty(1)
+void EnemyManager::addEnemy(float x, float z, int vida)
 {
+    m_x.push_back(x);
+    m_z.push_back(z);
+    m_previousX.push_back(x);
+    m_previousZ.push_back(z);
+
+    m_p0x.push_back(x); m_p0z.push_back(z);
+    m_p1x.push_back(x); m_p1z.push_back(z);
+    m_p2x.push_back(x); m_p2z.push_back(z);
+    m_p3x.push_back(x); m_p3z.push_back(z);
+    m_bezierT.push_back(0.0f);
+    m_speed.push_back(static_cast<float>(ENEMY_SPEED));
+    m_curveRecalcTimer.push_back(0.0f);
+    m_curveInitialized.push_back(0);
+    m_followsCurve.push_back(0);
+
+    m_knockbackVelX.push_back(0.0f);
+    m_knockbackVelZ.push_back(0.0f);
+
+    m_vida.push_back(vida);
+    m_dying.push_back(0);
+    m_deathTimer.push_back(0.0f);
+
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)m_slotGeneration.size();
+        m_slotGeneration.push_back(1);
+        m_slotToDense.push_back(0);
+    }
+    m_slotToDense[slot] = (uint32_t)(m_x.size() - 1);
+    m_denseToSlot.push_back(slot);
 }
 
-int EnemyManager::getRandomEnemyHP()
+EnemyHandle EnemyManager::getHandle(size_t i) const
 {
-    int roll = rand() % 100;
-    int easyChance, mediumChance;
-
-    switch (m_difficulty) {
-        case 0: easyChance = 70; mediumChance = 95; break;
-        case 1: easyChance = 33; mediumChance = 67; break;
-        case 2: easyChance = 5;  mediumChance = 30; break;
-        default: easyChance = 33; mediumChance = 67; break;
-    }
-
-    if (roll < easyChance) {
-        return 200 + rand() % 101;  // 200-300 HP
-    } else if (roll < mediumChance) {
-        return 400 + rand() % 101;  // 400-500 HP
-    } else {
-        return 600 + rand() % 101;  // 600-700 HP
-    }
+    uint32_t slot = m_denseToSlot[i];
+    return EnemyHandle(slot, m_slotGeneration[slot]);
 }
 
-EnemyManager::~EnemyManager()
+int EnemyManager::findEnemy(EnemyHandle handle) const
 {
+    if (handle.slot >= m_slotGeneration.size() ||
+        m_slotGeneration[handle.slot] != handle.generation)
+        return -1;
+
+    return (int)m_slotToDense[handle.slot];
 }
 
-void EnemyManager::update(float deltaTime, const Player& player)
+void EnemyManager::clearEnemies()
 {
-    for (size_t i = 0; i < m_enemies.size(); i++)
+    m_x.clear();
+    m_z.clear();
+    m_previousX.clear();
+    m_previousZ.clear();
+    m_p0x.clear(); m_p0z.clear();
+    m_p1x.clear(); m_p1z.clear();
+    m_p2x.clear(); m_p2z.clear();
+    m_p3x.clear(); m_p3z.clear();
+    m_bezierT.clear();
+    m_speed.clear();
+    m_curveRecalcTimer.clear();
+    m_curveInitialized.clear();
+    m_followsCurve.clear();
+    m_knockbackVelX.clear();
+    m_knockbackVelZ.clear();
+    m_vida.clear();
+    m_dying.clear();
+    m_deathTimer.clear();
+
+    // Todos os slots são liberados, com a geração avançada: handles
+    // guardados antes de limpar deixam de resolver
+    m_denseToSlot.clear();
+    m_freeSlots.clear();
+    for (size_t slot = 0; slot < m_slotGeneration.size(); slot++)
     {
-        m_enemies[i].update(deltaTime, player);
+        m_slotGeneration[slot]++;
+        m_freeSlots.push_back((uint32_t)(m_slotGeneration.size() - 1 - slot));
     }
+
+    m_previousSecond = -1;
 }
 
-void EnemyManager::spawnEnemy(const glm::vec4& playerPosition)
+void EnemyManager::spawnEnemy(const glm::vec4& playerPosition, Random& random)
 {
-    float x_aleatorio = 5.5f * rand() / (static_cast<float>(RAND_MAX)) - 3.5f;
-    float z_aleatorio = 2.0f * rand() / (static_cast<float>(RAND_MAX)) - 1.0f;
+    float x_aleatorio = 5.5f * random.nextFloat() - 3.5f;
+    float z_aleatorio = 2.0f * random.nextFloat() - 1.0f;
 
     while ((x_aleatorio - playerPosition.x) * (x_aleatorio - playerPosition.x) +
            (z_aleatorio - playerPosition.z) * (z_aleatorio - playerPosition.z) < 1.0f)
     {
-        x_aleatorio = 5.5f * rand() / (static_cast<float>(RAND_MAX)) - 3.5f;
-        z_aleatorio = 2.0f * rand() / (static_cast<float>(RAND_MAX)) - 1.0f;
+        x_aleatorio = 5.5f * random.nextFloat() - 3.5f;
+        z_aleatorio = 2.0f * random.nextFloat() - 1.0f;
     }
 
-    int enemyHP = getRandomEnemyHP();
-    Enemy novo_inimigo(x_aleatorio, z_aleatorio, enemyHP);
-    m_enemies.push_back(novo_inimigo);
+    int enemyHP = getRandomEnemyHP(random);
+    addEnemy(x_aleatorio, z_aleatorio, enemyHP);
 }
 
-void EnemyManager::trySpawnEnemy(int currentSecond, const glm::vec4& playerPosition)
+void EnemyManager::trySpawnEnemy(int currentSecond, const glm::vec4& playerPosition, Random& random)
 {
     if (currentSecond % m_spawnInterval == 0 &&
-        m_enemies.size() < static_cast<size_t>(m_maxEnemies) &&
+        getEnemyCount() < static_cast<size_t>(m_maxEnemies) &&
         m_previousSecond != currentSecond)
     {
-        spawnEnemy(playerPosition);
+        spawnEnemy(playerPosition, random);
     }
 
     m_previousSecond = currentSecond;
 }
 
+// Copia o inimigo do índice 'from' para 'to', em todos os arrays
+void EnemyManager::moveEnemy(size_t from, size_t to)
+{
+    m_x[to] = m_x[from];
+    m_z[to] = m_z[from];
+    m_previousX[to] = m_previousX[from];
+    m_previousZ[to] = m_previousZ[from];
+    m_p0x[to] = m_p0x[from]; m_p0z[to] = m_p0z[from];
+    m_p1x[to] = m_p1x[from]; m_p1z[to] = m_p1z[from];
+    m_p2x[to] = m_p2x[from]; m_p2z[to] = m_p2z[from];
+    m_p3x[to] = m_p3x[from]; m_p3z[to] = m_p3z[from];
+    m_bezierT[to] = m_bezierT[from];
+    m_speed[to] = m_speed[from];
+    m_curveRecalcTimer[to] = m_curveRecalcTimer[from];
+    m_curveInitialized[to] = m_curveInitialized[from];
+    m_followsCurve[to] = m_followsCurve[from];
+    m_knockbackVelX[to] = m_knockbackVelX[from];
+    m_knockbackVelZ[to] = m_knockbackVelZ[from];
+    m_vida[to] = m_vida[from];
+    m_dying[to] = m_dying[from];
+    m_deathTimer[to] = m_deathTimer[from];
+
+    m_denseToSlot[to] = m_denseToSlot[from];
+    m_slotToDense[m_denseToSlot[to]] = (uint32_t)to;
+}
+
+// Remove o inimigo i em O(1): o último inimigo ocupa o lugar dele, e o slot
+// volta para a lista livre com a geração avançada
+void EnemyManager::removeEnemy(size_t i)
+{
+    uint32_t slot = m_denseToSlot[i];
+    m_slotGeneration[slot]++;
+    m_freeSlots.push_back(slot);
+
+    size_t last = getEnemyCount() - 1;
+    if (i != last)
+        moveEnemy(last, i);
+
+    m_x.pop_back();
+    m_z.pop_back();
+    m_previousX.pop_back();
+    m_previousZ.pop_back();
+    m_p0x.pop_back(); m_p0z.pop_back();
+    m_p1x.pop_back(); m_p1z.pop_back();
+    m_p2x.pop_back(); m_p2z.pop_back();
+    m_p3x.pop_back(); m_p3z.pop_back();
+    m_bezierT.pop_back();
+    m_speed.pop_back();
+    m_curveRecalcTimer.pop_back();
+    m_curveInitialized.pop_back();
+    m_followsCurve.pop_back();
+    m_knockbackVelX.pop_back();
+    m_knockbackVelZ.pop_back();
+    m_vida.pop_back();
+    m_dying.pop_back();
+    m_deathTimer.pop_back();
+    m_denseToSlot.pop_back();
+}
+
+// Inicia a animação de morte dos inimigos sem vida e remove os que já a
+// terminaram. Quem ocupa o lugar de um removido é verificado em seguida,
+// no mesmo índice.
 void EnemyManager::removeDeadEnemies()
 {
-    for (size_t i = 0; i < m_enemies.size(); )
+    for (size_t i = 0; i < getEnemyCount(); )
     {
-        if (m_enemies[i].isDead())
+        if (!isDead(i))
         {
-            if (!m_enemies[i].isDying())
-            {
-                m_enemies[i].startDying();
-                i++;
-            }
-            else if (m_enemies[i].isReadyForRemoval())
-            {
-                m_enemies.erase(m_enemies.begin() + i);
-            }
-            else
-            {
-                i++;
-            }
+            i++;
+            continue;
+        }
+
+        if (!m_dying[i])
+        {
+            startDying(i);
         }
-        else
+        else if (m_deathTimer[i] >= DEATH_ANIM_DURATION)
         {
-            i++;
+            removeEnemy(i);
+            continue;
         }
+        i++;
     }
 }
-
-
@@ -19,17 +19,29 @@
 #include "matrices.h"
 #include "collisions.h"
 #include "sfx.h"
+#include "Logger.h"
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include <chrono>
 #include <glm/gtc/type_ptr.hpp>
 
 Game::Game()
-    : m_dragonBoss(-3.5f, 0.0f, 5000)
+    : m_seed(Random::DEFAULT_SEED)
+    , m_replayFinished(false)
+    , m_renderStatsEnabled(false)
+    , m_renderStatsTimer(0.0f)
+    , m_dragonBoss(-3.5f, 0.0f, 5000)
     , m_dragonBossAlive(true)
     , m_window(nullptr)
+    , m_headless(false)
     , m_lastFrameTime(0.0)
+    , m_accumulator(0.0)
+    , m_tickRate(DEFAULT_TICK_RATE)
+    , m_fixedDeltaTime(1.0f / DEFAULT_TICK_RATE)
+    , m_maxSubSteps(DEFAULT_MAX_SUBSTEPS)
     , m_segundoAnterior(0)
     , m_gameState(GameState::MENU)
     , m_difficulty(1)
@@ -47,7 +59,10 @@ Game::Game()
     , m_pauseCameraDistance(2.0f)
     , m_pauseCameraTarget(0.0f, 0.5f, 0.0f, 1.0f)
     , m_pauseFocusTarget(PauseFocusTarget::PLAYER)
-    , m_pauseFocusEnemyIndex(0)
+    , m_pauseFocusEnemy()
+    , m_autopilotShotTimer(0.0f)
+    , m_autopilotStrafeTimer(0.0f)
+    , m_autopilotStrafeRight(true)
 {
     m_pillars.push_back({glm::vec3(-3.0f, 0.0f, 1.2f), 0.5f, 3.0f});
     m_pillars.push_back({glm::vec3(-1.5f, 0.0f, 1.2f), 0.5f, 3.0f});
@@ -70,6 +85,23 @@ Game::Game()
     m_torches.push_back({glm::vec3(-0.75f, 1.5f, -1.3f), true});
     m_torches.push_back({glm::vec3(0.75f, 1.5f, -1.3f), true});
     m_torches.push_back({glm::vec3(2.25f, 1.5f, -1.3f), true});
+
+    // Grades da broad phase cobrindo a arena (limites do jogador)
+    m_enemyGrid.init(-4.3f, -1.3f, 4.3f, 1.3f, COLLISION_GRID_CELL_SIZE);
+    m_pillarGrid.init(-4.3f, -1.3f, 4.3f, 1.3f, COLLISION_GRID_CELL_SIZE);
+    for (size_t i = 0; i < m_pillars.size(); i++)
+    {
+        const Pillar& pillar = m_pillars[i];
+        float half = pillar.sizeXZ * 0.5f;
+        m_pillarGrid.insert((int)i, pillar.position.x - half, pillar.position.z - half,
+                                    pillar.position.x + half, pillar.position.z + half);
+    }
+    m_pillarGrid.build();
+
+    m_player.setSfx(&m_sfx);
+    m_enemyManager.setSfx(&m_sfx);
+    m_dragonBoss.setSfx(&m_sfx);
+    m_projectileManager.setSfx(&m_sfx);
 }
 
 Game::~Game()
@@ -102,26 +134,23 @@ bool Game::init()
         return false;
     }
 
-    glfwSetKeyCallback(m_window, Input::keyCallback);
-    glfwSetMouseButtonCallback(m_window, Input::mouseButtonCallback);
-    glfwSetCursorPosCallback(m_window, Input::cursorPosCallback);
-    glfwSetScrollCallback(m_window, Input::scrollCallback);
-    glfwSetFramebufferSizeCallback(m_window, Input::framebufferSizeCallback);
+    m_input.init(m_window, &m_player, this);
 
     glfwSetWindowSize(m_window, 800, 600);
     glfwMakeContextCurrent(m_window);
 
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
-    Input::init(&m_player, this);
     if (!m_renderer.init(m_window))
     {
         fprintf(stderr, "ERROR: Renderer initialization failed.\n");
         return false;
     }
+    m_renderer.buildStaticBatch(m_pillars, m_torches);
 
     m_lastFrameTime = glfwGetTime();
-    sfx.start();
+    printf("[Game] Random seed: %llu\n", (unsigned long long)m_seed);
+    m_sfx.start();
     menu_music=true;
     return true;
 }
@@ -131,37 +160,517 @@ bool Game::init()
 // ============================================================================
 // REQUISITO 10: Animações baseadas no tempo
 //
-// O loop principal usa deltaTime para garantir que o jogo rode na mesma
-// velocidade independente da taxa de frames. Isso é calculado como:
+// A simulação roda em PASSO FIXO (m_fixedDeltaTime, por padrão 1/120 s),
+// desacoplada da taxa de frames. O tempo real decorrido é acumulado e
+// consumido em ticks de tamanho constante:
 //
-//     deltaTime = tempoAtual - tempoUltimoFrame
+//     acumulador += tempoAtual - tempoUltimoFrame
+//     enquanto acumulador >= dt:  update(dt); acumulador -= dt
 //
-// Todas as animações e movimentos usam essa variável para interpolar
-// posições de forma suave e consistente.
+// Assim física, curvas de Bézier, projéteis e colisões evoluem igual em
+// qualquer máquina. O número de sub-passos por frame é limitado por
+// m_maxSubSteps: um frame muito longo (compilação de shader, carga de
+// música) descarta o excesso em vez de produzir um passo gigante.
+//
+// A renderização interpola entre o estado do tick anterior e o atual
+// usando alpha = acumulador / dt, de modo que o movimento continua suave
+// mesmo quando a taxa de frames e a taxa de ticks são diferentes.
 // ============================================================================
 void Game::run()
 {
-    while (!glfwWindowShouldClose(m_window))
+    while (!glfwWindowShouldClose(m_window) && !m_replayFinished)
     {
-        // Calcula o tempo decorrido desde o último frame
-        // Isso garante movimento suave independente do FPS
+        std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+        // Tempo real decorrido desde o último frame
         double currentTime = glfwGetTime();
-        float deltaTime = static_cast<float>(currentTime - m_lastFrameTime);
+        double frameTime = currentTime - m_lastFrameTime;
         m_lastFrameTime = currentTime;
 
-        // Atualiza a lógica do jogo (física, colisões, IA)
-        update(deltaTime);
+        m_accumulator += frameTime;
+
+        // Atualiza a lógica do jogo (física, colisões, IA) em passos fixos
+        int subSteps = 0;
+        while (m_accumulator >= m_fixedDeltaTime && subSteps < m_maxSubSteps)
+        {
+            if (m_replay.isOpen())
+            {
+                std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+                update(m_fixedDeltaTime);
+                if (!m_replayFinished)
+                    m_tickTimes.add(std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - tickStart).count());
+            }
+            else
+            {
+                update(m_fixedDeltaTime);
+            }
+            m_accumulator -= m_fixedDeltaTime;
+            subSteps++;
+        }
+
+        // Limite de sub-passos atingido: descarta os ticks atrasados
+        if (m_accumulator >= m_fixedDeltaTime)
+            m_accumulator = fmod(m_accumulator, (double)m_fixedDeltaTime);
+
+        // Fração do próximo tick já decorrida, usada na interpolação
+        float alpha = static_cast<float>(m_accumulator / m_fixedDeltaTime);
+
         // Renderiza a cena atual
-        render(deltaTime);
+        render(static_cast<float>(frameTime), alpha);
 
         // Troca os buffers (double buffering) e processa eventos
         glfwSwapBuffers(m_window);
         glfwPollEvents();
+
+        if (m_replay.isOpen())
+            m_frameTimes.add(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - frameStart).count());
+    }
+
+    if (m_replay.isOpen())
+        printReplayReport();
+}
+
+void Game::setTickRate(float ticksPerSecond)
+{
+    if (ticksPerSecond <= 0.0f)
+        return;
+
+    m_tickRate = ticksPerSecond;
+    m_fixedDeltaTime = 1.0f / ticksPerSecond;
+}
+
+void Game::setMaxSubSteps(int maxSubSteps)
+{
+    if (maxSubSteps < 1)
+        maxSubSteps = 1;
+
+    m_maxSubSteps = maxSubSteps;
+}
+
+// ============================================================================
+// MODO HEADLESS
+// ============================================================================
+// Roda a simulação sem GLFW, contexto OpenGL, Renderer ou áudio. Apenas
+// Player, EnemyManager, ProjectileManager, o dragão e as colisões são
+// atualizados, em ticks fixos de m_fixedDeltaTime avançados por um relógio
+// virtual: não há espera pelo tempo real, então a simulação roda tão rápido
+// quanto a CPU permite.
+//
+// Cada partida termina em vitória, derrota ou ao atingir maxTicksPerMatch.
+// No final é impresso o total de ticks e a vazão em ticks/segundo.
+// ============================================================================
+bool Game::initHeadless()
+{
+    m_headless = true;
+    m_window = nullptr;
+
+    m_sfx.setMuted(true);
+    m_projectileManager.setTrailsEnabled(false);
+    Logger::setEnabled(false);
+    return true;
+}
+
+void Game::runHeadless(int matches, long long maxTicksPerMatch)
+{
+    if (matches < 1)
+        matches = 1;
+    if (maxTicksPerMatch < 1)
+        maxTicksPerMatch = 1;
+
+    printf("[Headless] Running %d match(es), difficulty %d, %.0f Hz, seed %llu, up to %lld ticks each\n",
+           matches, m_difficulty, m_tickRate, (unsigned long long)m_seed, maxTicksPerMatch);
+
+    long long totalTicks = 0;
+    int wins = 0;
+    int losses = 0;
+    int timeouts = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int match = 0; match < matches; match++)
+    {
+        startHeadlessMatch();
+
+        long long ticks = 0;
+        while (ticks < maxTicksPerMatch && !isMatchOver())
+        {
+            update(m_fixedDeltaTime);
+            ticks++;
+        }
+        totalTicks += ticks;
+
+        const char* result;
+        if (m_gameState == GameState::WIN)
+        {
+            result = "WIN";
+            wins++;
+        }
+        else if (m_gameState == GameState::GAME_OVER)
+        {
+            result = "GAME OVER";
+            losses++;
+        }
+        else
+        {
+            result = "TIMEOUT";
+            timeouts++;
+        }
+
+        printf("[Headless] Match %d: %s after %lld ticks (%.1f s simulated), player HP %d/%d, dragon HP %d, state %016llx\n",
+               match + 1, result, ticks, ticks * (double)m_fixedDeltaTime,
+               m_player.getVida(), m_player.getMaxVida(), m_dragonBoss.getVida(),
+               (unsigned long long)computeStateHash());
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    double ticksPerSecond = elapsed > 0.0 ? totalTicks / elapsed : 0.0;
+
+    printf("[Headless] %lld ticks in %.3f s: %.0f ticks/s (%.1fx real time)\n",
+           totalTicks, elapsed, ticksPerSecond, ticksPerSecond / m_tickRate);
+    printf("[Headless] Wins: %d, losses: %d, timeouts: %d\n", wins, losses, timeouts);
+}
+
+// FNV-1a sobre os bytes de um valor
+template<typename T>
+static void hashValue(uint64_t& hash, const T& value)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+// Resume o estado do mundo em 64 bits. Duas execuções com a mesma semente
+// e as mesmas entradas devem produzir o mesmo hash a cada tick.
+uint64_t Game::computeStateHash() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    hashValue(hash, m_gameTime);
+    hashValue(hash, m_player.getPosition());
+    hashValue(hash, m_player.getVida());
+
+    for (size_t i = 0; i < m_enemyManager.getEnemyCount(); i++)
+    {
+        hashValue(hash, m_enemyManager.getX(i));
+        hashValue(hash, m_enemyManager.getZ(i));
+        hashValue(hash, m_enemyManager.getVida(i));
+    }
+
+    hashValue(hash, m_dragonBoss.getVida());
+
+    // A ordem dos projéteis no pool muda com as remoções (troca com o
+    // último), então cada um entra no hash por uma soma, que não depende
+    // da ordem
+    uint64_t projectileSum = 0;
+    for (size_t i = 0; i < m_projectileManager.getProjectileCount(); i++)
+    {
+        uint64_t projectileHash = 14695981039346656037ULL;
+        hashValue(projectileHash, m_projectileManager.getPosition(i));
+        projectileSum += projectileHash;
+    }
+    hashValue(hash, projectileSum);
+
+    for (const HealthPickup& pickup : m_healthPickups)
+        hashValue(hash, pickup.position);
+
+    return hash;
+}
+
+// ============================================================================
+// GRAVAÇÃO E REPLAY
+// ============================================================================
+// Toda entrada que altera a simulação passa por um InputFrame por tick
+// (Game::update). Gravando esses frames junto com a semente, a sessão pode
+// ser reproduzida depois, com ou sem janela, e o hash do estado no último
+// tick confirma que o replay chegou ao mesmo resultado.
+// ============================================================================
+bool Game::startRecording(const char* path)
+{
+    if (!m_recorder.open(path, m_seed, m_difficulty, m_tickRate))
+        return false;
+
+    printf("[Replay] Recording input to %s\n", path);
+    return true;
+}
+
+bool Game::loadReplay(const char* path)
+{
+    if (!m_replay.open(path))
+        return false;
+
+    const ReplayHeader& header = m_replay.getHeader();
+    setTickRate(header.tickRate);
+    setRandomSeed(header.seed);
+    setDifficulty(header.difficulty);
+    m_replayFinished = false;
+    m_tickTimes.clear();
+    m_tickTimes.reserve(header.frameCount);
+    m_frameTimes.clear();
+
+    printf("[Replay] Loaded %s: %u ticks at %.0f Hz, seed %llu, difficulty %d\n",
+           path, header.frameCount, header.tickRate,
+           (unsigned long long)header.seed, header.difficulty);
+    return true;
+}
+
+void Game::runReplayHeadless()
+{
+    while (!m_replayFinished)
+    {
+        std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now();
+        update(m_fixedDeltaTime);
+        if (!m_replayFinished)
+            m_tickTimes.add(std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - tickStart).count());
+    }
+
+    printReplayReport();
+}
+
+void Game::printReplayReport()
+{
+    const ReplayHeader& header = m_replay.getHeader();
+
+    printf("[Replay] Played %u of %u ticks\n", m_replay.getFramesPlayed(), header.frameCount);
+    m_tickTimes.print("[Replay] Tick time");
+    if (m_frameTimes.count() > 0)
+        m_frameTimes.print("[Replay] Frame time");
+
+    if (m_replay.getFramesPlayed() < header.frameCount)
+    {
+        printf("[Replay] Stopped before the end of the recording; state hash not compared\n");
+        return;
+    }
+
+    uint64_t hash = computeStateHash();
+    if (header.finalStateHash == 0)
+        printf("[Replay] Final state %016llx (recording has no reference hash)\n",
+               (unsigned long long)hash);
+    else if (hash == header.finalStateHash)
+        printf("[Replay] Final state %016llx: MATCH\n", (unsigned long long)hash);
+    else
+        printf("[Replay] Final state %016llx: MISMATCH (recorded %016llx)\n",
+               (unsigned long long)hash, (unsigned long long)header.finalStateHash);
+}
+
+void Game::startHeadlessMatch()
+{
+    resetGame();
+    m_autopilotShotTimer = 0.0f;
+    m_autopilotStrafeTimer = 0.0f;
+    m_autopilotStrafeRight = true;
+}
+
+void Game::stepHeadless(long long ticks)
+{
+    for (long long i = 0; i < ticks; i++)
+    {
+        if (m_gameState == GameState::MENU || isMatchOver())
+            startHeadlessMatch();
+
+        update(m_fixedDeltaTime);
+    }
+}
+
+// Guarda o estado do tick atual como "anterior" antes de avançar a simulação;
+// o renderer interpola entre esse estado e o resultado do novo tick.
+void Game::storePreviousState()
+{
+    m_player.storePreviousState();
+    m_enemyManager.storePreviousState();
+    m_dragonBoss.storePreviousState();
+    m_projectileManager.storePreviousState();
+}
+
+// Lê as teclas de movimento (WASD) da janela para o tick atual
+PlayerInput Game::readPlayerInput() const
+{
+    PlayerInput input;
+    input.forward  = glfwGetKey(m_window, GLFW_KEY_W) == GLFW_PRESS;
+    input.backward = glfwGetKey(m_window, GLFW_KEY_S) == GLFW_PRESS;
+    input.left     = glfwGetKey(m_window, GLFW_KEY_A) == GLFW_PRESS;
+    input.right    = glfwGetKey(m_window, GLFW_KEY_D) == GLFW_PRESS;
+    return input;
+}
+
+// Modo do cursor só existe com janela; no modo headless é ignorado
+void Game::setCursorMode(int mode)
+{
+    if (m_window)
+        glfwSetInputMode(m_window, GLFW_CURSOR, mode);
+}
+
+// ============================================================================
+// PILOTO AUTOMÁTICO (MODO HEADLESS)
+// ============================================================================
+// Sem teclado e mouse, o jogador é controlado por uma heurística simples,
+// que preenche o InputFrame do tick como o jogador faria:
+// - Mira no inimigo vivo mais próximo (ou no dragão, se não houver
+//   inimigos), girando a câmera com deltas de mouse
+// - Atira quando a mira está alinhada, respeitando um intervalo entre tiros
+// - Recua quando um inimigo chega perto; senão anda de lado, alternando
+//   a direção periodicamente para desviar das bolas de fogo
+// ============================================================================
+void Game::updateAutopilot(float deltaTime, InputFrame& frame)
+{
+    PlayerInput& input = frame.movement;
+
+    if (m_autopilotShotTimer > 0.0f)
+        m_autopilotShotTimer -= deltaTime;
+
+    m_autopilotStrafeTimer += deltaTime;
+    if (m_autopilotStrafeTimer >= AUTOPILOT_STRAFE_INTERVAL)
+    {
+        m_autopilotStrafeTimer = 0.0f;
+        m_autopilotStrafeRight = !m_autopilotStrafeRight;
+    }
+
+    glm::vec4 playerPos = m_player.getPosition();
+
+    // Alvo: inimigo vivo mais próximo, senão o dragão
+    bool hasTarget = false;
+    glm::vec4 target(0.0f);
+    float nearestEnemyDistance = std::numeric_limits<float>::max();
+
+    for (size_t i = 0; i < m_enemyManager.getEnemyCount(); i++)
+    {
+        if (m_enemyManager.isDead(i))
+            continue;
+
+        glm::vec4 enemyPos = m_enemyManager.getPosition(i);
+        float dx = enemyPos.x - playerPos.x;
+        float dz = enemyPos.z - playerPos.z;
+        float distance = sqrt(dx * dx + dz * dz);
+        if (distance < nearestEnemyDistance)
+        {
+            nearestEnemyDistance = distance;
+            target = enemyPos;
+            hasTarget = true;
+        }
+    }
+
+    if (!hasTarget && m_dragonBossAlive)
+    {
+        target = m_dragonBoss.getPosition();
+        target.y += 0.15f;
+        hasTarget = true;
+    }
+
+    if (nearestEnemyDistance < AUTOPILOT_SAFE_DISTANCE)
+        input.backward = true;
+    else if (m_autopilotStrafeRight)
+        input.right = true;
+    else
+        input.left = true;
+
+    if (!hasTarget || !m_player.isFirstPerson())
+        return;
+
+    // Ângulos desejados, na mesma parametrização da câmera livre:
+    //     view = (cos(pitch)*sin(yaw), sin(pitch), cos(pitch)*cos(yaw))
+    glm::vec4 toTarget = target - m_player.getCameraPosition();
+    float horizontal = sqrt(toTarget.x * toTarget.x + toTarget.z * toTarget.z);
+    float desiredYaw = atan2(toTarget.x, toTarget.z);
+    float desiredPitch = atan2(toTarget.y, horizontal);
+
+    glm::vec4 dir = m_player.getCameraDirection();
+    float currentYaw = atan2(dir.x, dir.z);
+    float currentPitch = asin(std::max(-1.0f, std::min(dir.y, 1.0f)));
+
+    float yawError = desiredYaw - currentYaw;
+    while (yawError > 3.141592f)
+        yawError -= 2.0f * 3.141592f;
+    while (yawError < -3.141592f)
+        yawError += 2.0f * 3.141592f;
+    float pitchError = desiredPitch - currentPitch;
+
+    // Limita a velocidade de giro, como faria um jogador com o mouse
+    float maxTurn = AUTOPILOT_TURN_SPEED * deltaTime;
+    float yawStep = std::max(-maxTurn, std::min(yawError, maxTurn));
+    float pitchStep = std::max(-maxTurn, std::min(pitchError, maxTurn));
+
+    // Player::handleMouseMove: yaw -= sensibilidade*dx, pitch += sensibilidade*dy
+    const float sensitivity = 0.001f;
+    frame.lookDx = -yawStep / sensitivity;
+    frame.lookDy = pitchStep / sensitivity;
+
+    if (fabs(yawError - yawStep) < AUTOPILOT_AIM_TOLERANCE && m_autopilotShotTimer <= 0.0f)
+    {
+        frame.shoot = true;
+        m_autopilotShotTimer = AUTOPILOT_FIRE_INTERVAL;
+    }
+}
+
+// Aplica os comandos de estado do tick (menu, pausa, reinício) e o
+// movimento do mouse, na ordem em que os callbacks os aplicavam
+void Game::applyInputCommands(const InputFrame& frame)
+{
+    if (frame.startDifficulty >= 0 && m_gameState == GameState::MENU)
+    {
+        setDifficulty(frame.startDifficulty);
+        startGame();
+    }
+
+    if (frame.restart && (m_gameState == GameState::GAME_OVER || m_gameState == GameState::WIN))
+        resetGame();
+
+    if (frame.returnToMenu && (m_gameState == GameState::PLAYING ||
+                               m_gameState == GameState::GAME_OVER ||
+                               m_gameState == GameState::WIN))
+        returnToMenu();
+
+    if (frame.togglePause && (m_gameState == GameState::PLAYING || m_gameState == GameState::PAUSED))
+        togglePause();
+
+    if ((frame.lookDx != 0.0f || frame.lookDy != 0.0f) && m_gameState != GameState::PAUSED)
+        m_player.handleMouseMove(frame.lookDx, frame.lookDy);
+
+    if (m_gameState == GameState::PLAYING)
+    {
+        if (frame.toggleCamera)
+            m_player.toggleCamera();
+        if (frame.jump)
+            m_player.jump();
     }
 }
 
 void Game::update(float deltaTime)
 {
+    storePreviousState();
+
+    // Entradas do tick: do replay, do piloto automático ou da janela
+    InputFrame frame;
+    if (m_replay.isOpen())
+    {
+        m_input.consumeFrame();
+        if (!m_replay.next(frame))
+        {
+            m_replayFinished = true;
+            return;
+        }
+    }
+    else if (m_headless)
+    {
+        if (m_gameState == GameState::PLAYING)
+            updateAutopilot(deltaTime, frame);
+    }
+    else
+    {
+        frame = m_input.consumeFrame();
+        frame.movement = readPlayerInput();
+    }
+
+    if (m_recorder.isOpen())
+        m_recorder.write(frame);
+
+    applyInputCommands(frame);
+
     if (m_gameState == GameState::COUNTDOWN)
     {
         m_countdownTimer -= deltaTime;
@@ -170,7 +679,7 @@ void Game::update(float deltaTime)
             m_gameState = GameState::PLAYING;
             if (!m_player.isFirstPerson())
                 m_player.toggleCamera();
-            glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+            setCursorMode(GLFW_CURSOR_DISABLED);
         }
         return;
     }
@@ -178,17 +687,19 @@ void Game::update(float deltaTime)
     if (m_gameState != GameState::PLAYING)
         return;
 
-    int segundos = (int)glfwGetTime();
+    // O spawn usa o relógio da simulação (e não glfwGetTime), para que a
+    // partida evolua igual com ou sem janela
+    int segundos = (int)m_gameTime;
 
     m_gameTime += deltaTime;
     updateEnemySpeed(deltaTime);
 
-    m_enemyManager.trySpawnEnemy(segundos, m_player.getPosition());
-    m_player.update(m_window, deltaTime);
-    m_enemyManager.update(deltaTime, m_player);
+    m_enemyManager.trySpawnEnemy(segundos, m_player.getPosition(), m_random);
+    m_player.update(frame.movement, deltaTime);
+    m_enemyManager.update(deltaTime, m_player, m_random);
     handleEnemyEnvironmentCollisions();
     handleCollisions();
-    handleShooting();
+    handleShooting(frame.shoot);
     handleDebugKillKey();
     m_enemyManager.removeDeadEnemies();
 
@@ -208,9 +719,9 @@ void Game::update(float deltaTime)
     if (m_player.isDead())
     {
         m_gameState = GameState::GAME_OVER;
-        glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        setCursorMode(GLFW_CURSOR_NORMAL);
         if (result_sfx){
-            sfx.game_over();
+            m_sfx.game_over();
             result_sfx=false;
         }
     }
@@ -218,21 +729,23 @@ void Game::update(float deltaTime)
     if (!m_dragonBossAlive)
     {
         m_gameState = GameState::WIN;
-        glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        setCursorMode(GLFW_CURSOR_NORMAL);
         if (result_sfx){
-            sfx.vitoria();
+            m_sfx.vitoria();
             result_sfx=false;
         }
     }
 }
 
-void Game::render(float deltaTime)
+void Game::render(float deltaTime, float alpha)
 {
+    m_renderer.setInterpolationAlpha(alpha);
+
     switch (m_gameState)
     {
     case GameState::MENU:
         if(menu_music){
-            sfx.musicaPrincipalStart("sfx/menu.mp3", true);
+            m_sfx.musicaPrincipalStart("sfx/menu.mp3", true);
             menu_music=false;
         }
         m_renderer.renderMenu(m_difficulty);
@@ -240,7 +753,8 @@ void Game::render(float deltaTime)
 
     case GameState::COUNTDOWN:
         {
-            float progress = (4.0f - m_countdownTimer) / 4.0f;
+            float countdownTimer = m_countdownTimer - alpha * m_fixedDeltaTime;
+            float progress = (4.0f - countdownTimer) / 4.0f;
             float camHeight = 2.5f;
             float camX = -3.5f + progress * 7.0f;
             glm::vec4 camera_position = glm::vec4(
@@ -257,34 +771,34 @@ void Game::render(float deltaTime)
             float nearplane = -0.1f;
             float farplane = -5000.0f;
             float field_of_view = 3.141592f / 3.0f;
-            glm::mat4 projection = Matrix_Perspective(field_of_view, Input::getScreenRatio(), nearplane, farplane);
+            glm::mat4 projection = Matrix_Perspective(field_of_view, m_input.getScreenRatio(), nearplane, farplane);
 
             m_renderer.setView(view);
             m_renderer.setProjection(projection);
             m_renderer.renderScene(m_player, m_enemyManager, m_dragonBoss, m_dragonBossAlive, deltaTime);
-            m_renderer.renderPillars(m_pillars);
             m_renderer.renderTorches(m_torches, deltaTime);
+            flushScene(deltaTime);
 
-            int countdownNum = (int)ceilf(m_countdownTimer);
+            int countdownNum = (int)ceilf(countdownTimer);
             m_renderer.renderCountdown(countdownNum);
         }
         break;
 
     case GameState::PLAYING:
         {
-            glm::mat4 view = m_player.getCameraView();
+            glm::mat4 view = m_player.getCameraView(alpha);
 
             float nearplane = -0.1f;
             float farplane  = -5000.0f;
             float field_of_view = 3.141592f / 3.0f;
-            glm::mat4 projection = Matrix_Perspective(field_of_view, Input::getScreenRatio(), nearplane, farplane);
+            glm::mat4 projection = Matrix_Perspective(field_of_view, m_input.getScreenRatio(), nearplane, farplane);
 
             m_renderer.setView(view);
             m_renderer.setProjection(projection);
             m_renderer.renderScene(m_player, m_enemyManager, m_dragonBoss, m_dragonBossAlive, deltaTime, &m_projectileManager);
-            m_renderer.renderPillars(m_pillars);
             m_renderer.renderTorches(m_torches, deltaTime);
             m_renderer.renderHealthPickups(m_healthPickups, deltaTime);
+            flushScene(deltaTime);
             m_renderer.renderHUD(m_player, m_enemyManager, m_dragonBoss, m_dragonBossAlive);
             m_renderer.renderCrosshair(m_player.isFirstPerson());
 
@@ -322,27 +836,48 @@ void Game::render(float deltaTime)
             float nearplane = -0.1f;
             float farplane = -5000.0f;
             float field_of_view = 3.141592f / 3.0f;
-            glm::mat4 projection = Matrix_Perspective(field_of_view, Input::getScreenRatio(), nearplane, farplane);
+            glm::mat4 projection = Matrix_Perspective(field_of_view, m_input.getScreenRatio(), nearplane, farplane);
 
             m_renderer.setView(view);
             m_renderer.setProjection(projection);
             m_renderer.renderScenePaused(m_player, m_enemyManager, m_dragonBoss, m_dragonBossAlive, camera_position, deltaTime, &m_projectileManager);
-            m_renderer.renderPillars(m_pillars);
             m_renderer.renderTorches(m_torches, deltaTime);
             m_renderer.renderHealthPickups(m_healthPickups, deltaTime);
+            flushScene(deltaTime);
         }
         break;
 
     case GameState::GAME_OVER:
         m_renderer.renderGameOver();
-        sfx.musicaPrincipalStop();
+        m_sfx.musicaPrincipalStop();
         break;
 
     case GameState::WIN:
         m_renderer.renderWin();
-        sfx.musicaPrincipalStop();
+        m_sfx.musicaPrincipalStop();
         break;
     }
+
+    // Texto do quadro inteiro numa chamada, por cima da cena
+    m_renderer.flushText();
+}
+
+// Desenha a cena 3D submetida no quadro (ver Renderer::flushRenderQueue)
+void Game::flushScene(float deltaTime)
+{
+    m_renderer.flushRenderQueue();
+
+    if (!m_renderStatsEnabled)
+        return;
+
+    m_renderStatsTimer += deltaTime;
+    if (m_renderStatsTimer < 1.0f)
+        return;
+    m_renderStatsTimer = 0.0f;
+
+    const RenderStats& stats = m_renderer.getFrameStats();
+    printf("[Render] %u objects drawn, %u culled, %u triangles, %u packets, %u draw calls (%u instanced), %u GL calls, %u redundant calls skipped\n",
+           stats.visibleObjects, stats.culledObjects, stats.triangles, stats.packets, stats.drawCalls, stats.instancedDraws, stats.glCalls, stats.redundantCalls);
 }
 
 // ============================================================================
@@ -428,16 +963,24 @@ void Game::handleCollisions()
     // Testa colisão entre jogador e cada inimigo
     // Se houver colisão: jogador toma dano, é empurrado para fora,
     // e o inimigo recebe knockback na direção oposta
-    std::vector<Enemy>& enemies = const_cast<std::vector<Enemy>&>(m_enemyManager.getEnemies());
     float enemyRadius = 0.10f;
     glm::vec3 enemyExtents(enemyRadius, enemyRadius, enemyRadius);
 
     glm::vec3 playerMin = player_pos_3d - player_extents;
     glm::vec3 playerMax = player_pos_3d + player_extents;
 
-    for (Enemy& enemy : enemies)
+    // Broad phase: só os inimigos nas células ao redor do jogador
+    rebuildEnemyGrid();
+    float reach = enemyRadius + COLLISION_PUSH_MARGIN;
+    m_enemyGrid.query(playerMin.x - reach, playerMin.z - reach,
+                      playerMax.x + reach, playerMax.z + reach, m_collisionCandidates);
+    // Cada colisão empurra o jogador: testa na ordem dos índices
+    std::sort(m_collisionCandidates.begin(), m_collisionCandidates.end());
+
+    for (size_t c = 0; c < m_collisionCandidates.size(); c++)
     {
-        glm::vec4 enemyPos4 = enemy.getPosition();
+        size_t i = m_collisionCandidates[c];
+        glm::vec4 enemyPos4 = m_enemyManager.getPosition(i);
         glm::vec3 enemyPos(enemyPos4.x, enemyPos4.y, enemyPos4.z);
 
         glm::vec3 enemyMin = enemyPos - enemyExtents;
@@ -469,7 +1012,7 @@ void Game::handleCollisions()
 
             // Knockback no enemy
             glm::vec3 pushDir = (enemyPos - player_pos_3d)/norm(enemyPos - player_pos_3d);
-            enemy.applyKnockback(pushDir.x, pushDir.z, 6.0f);
+            m_enemyManager.applyKnockback(i, pushDir.x, pushDir.z, 6.0f);
 
             m_player.updatePositionAfterCollision(player_pos_3d);
         }
@@ -509,14 +1052,22 @@ void Game::handleCollisions()
     }
 }
 
+// Registra a posição atual de cada inimigo na grade da broad phase
+void Game::rebuildEnemyGrid()
+{
+    m_enemyGrid.clear();
+    for (size_t i = 0; i < m_enemyManager.getEnemyCount(); i++)
+        m_enemyGrid.insertPoint((int)i, m_enemyManager.getX(i), m_enemyManager.getZ(i));
+    m_enemyGrid.build();
+}
+
 void Game::handleEnemyEnvironmentCollisions()
 {
-    std::vector<Enemy>& enemies = const_cast<std::vector<Enemy>&>(m_enemyManager.getEnemies());
     float enemyRadius = 0.15f;
 
-    for (Enemy& enemy : enemies)
+    for (size_t i = 0; i < m_enemyManager.getEnemyCount(); i++)
     {
-        glm::vec4 enemyPos4 = enemy.getPosition();
+        glm::vec4 enemyPos4 = m_enemyManager.getPosition(i);
         glm::vec3 enemyPos(enemyPos4.x, enemyPos4.y, enemyPos4.z);
 
         glm::vec3 enemyExtents(enemyRadius, enemyRadius, enemyRadius);
@@ -526,8 +1077,15 @@ void Game::handleEnemyEnvironmentCollisions()
 
         bool positionChanged = false;
 
-        for (const Pillar& pillar : m_pillars)
+        // Broad phase: só os pilares nas células ao redor do inimigo
+        float reach = COLLISION_PUSH_MARGIN;
+        m_pillarGrid.query(enemyMin.x - reach, enemyMin.z - reach,
+                           enemyMax.x + reach, enemyMax.z + reach, m_collisionCandidates);
+        std::sort(m_collisionCandidates.begin(), m_collisionCandidates.end());
+
+        for (size_t c = 0; c < m_collisionCandidates.size(); c++)
         {
+            const Pillar& pillar = m_pillars[m_collisionCandidates[c]];
             glm::vec3 pillarExtents(pillar.sizeXZ * 0.5f, pillar.height * 0.5f, pillar.sizeXZ * 0.5f);
             glm::vec3 pillarCenter(pillar.position.x,
                                    pillar.position.y + pillarExtents.y,
@@ -562,15 +1120,15 @@ void Game::handleEnemyEnvironmentCollisions()
 
     if (positionChanged)
     {
-        enemy.setPosition(enemyPos.x, enemyPos.z);
-        enemy.onObstacleCollision();  // recalcula o caminho, usando curva de bezier
+        m_enemyManager.setPosition(i, enemyPos.x, enemyPos.z);
+        m_enemyManager.onObstacleCollision(i);  // recalcula o caminho, usando curva de bezier
     }
     }
 }
 
-void Game::handleShooting()
+void Game::handleShooting(bool shootRequested)
 {
-    if (!Input::isShootingRequested())
+    if (!shootRequested)
         return;
 
     if (!m_player.isFirstPerson())
@@ -593,7 +1151,7 @@ void Game::handleShooting()
 
     m_muzzleFlashTimer = MUZZLE_FLASH_DURATION;
 
-    printf("Projectile spawned at (%.2f, %.2f, %.2f)\n", spawnPos.x, spawnPos.y, spawnPos.z);
+    Logger::print("Projectile spawned at (%.2f, %.2f, %.2f)\n", spawnPos.x, spawnPos.y, spawnPos.z);
 }
 
 // ============================================================================
@@ -611,9 +1169,6 @@ void Game::handleShooting()
 // ============================================================================
 void Game::handleProjectileCollisions()
 {
-    std::vector<Projectile>& projectiles = m_projectileManager.getProjectiles();
-    std::vector<Enemy>& enemies = const_cast<std::vector<Enemy>&>(m_enemyManager.getEnemies());
-
     // Raios das esferas de colisão para cada tipo de entidade
     float enemyRadius = 0.10f;
     float bossRadius = 0.45f;
@@ -623,24 +1178,27 @@ void Game::handleProjectileCollisions()
     glm::vec4 playerPos4 = m_player.getPosition();
     glm::vec3 playerPos(playerPos4.x, playerPos4.y + 0.1f, playerPos4.z);
 
-    for (Projectile& proj : projectiles)
+    rebuildEnemyGrid();
+    float hitReach = enemyRadius + projectileRadius;
+
+    for (size_t p = 0; p < m_projectileManager.getProjectileCount(); p++)
     {
-        if (!proj.active)
+        if (!m_projectileManager.isActive(p))
             continue;
 
-        glm::vec3 projPos = proj.position;
+        glm::vec3 projPos = m_projectileManager.getPosition(p);
 
         // ─────────────────────────────────────────────
         // Projetil inimigo → Colisão com Player
         // ─────────────────────────────────────────────
-        if (proj.isEnemyProjectile)
+        if (m_projectileManager.isEnemyProjectile(p))
         {
             if (testPointSphere(projPos, playerPos, playerRadius + projectileRadius))
             {
                 m_player.takeDamage(15);
-                proj.active = false;
+                m_projectileManager.deactivate(p);
 
-                printf("Player hit by fireball! HP: %d/%d\n",
+                Logger::print("Player hit by fireball! HP: %d/%d\n",
                     m_player.getVida(), m_player.getMaxVida());
             }
             continue; // Enemy projectiles don't hit enemies
@@ -649,23 +1207,36 @@ void Game::handleProjectileCollisions()
         // ─────────────────────────────────────────────
         // Projetil do Jogador → Colisão com Inimigos
         // ─────────────────────────────────────────────
-        for (Enemy& enemy : enemies)
+        // Broad phase: inimigos nas células ao redor do projétil. O projétil
+        // acerta o inimigo de menor índice que ele toca, como no teste contra
+        // todos os inimigos em ordem
+        m_enemyGrid.query(projPos.x - hitReach, projPos.z - hitReach,
+                          projPos.x + hitReach, projPos.z + hitReach, m_collisionCandidates);
+
+        int hitEnemy = -1;
+        for (size_t c = 0; c < m_collisionCandidates.size(); c++)
         {
-            glm::vec4 epos4 = enemy.getPosition();
+            int i = m_collisionCandidates[c];
+            if (hitEnemy >= 0 && i > hitEnemy)
+                continue;
+
+            glm::vec4 epos4 = m_enemyManager.getPosition(i);
             glm::vec3 enemyPos(epos4.x, epos4.y, epos4.z);
 
             if (testPointSphere(projPos, enemyPos, enemyRadius + projectileRadius))
-            {
-                enemy.takeDamage(100);
-                proj.active = false;
-                m_hitMarkerTimer = HIT_MARKER_DURATION;
+                hitEnemy = i;
+        }
 
-                printf("Projectile hit enemy! Enemy HP: %d\n", enemy.getVida());
-                break;
-            }
+        if (hitEnemy >= 0)
+        {
+            m_enemyManager.takeDamage(hitEnemy, 100);
+            m_projectileManager.deactivate(p);
+            m_hitMarkerTimer = HIT_MARKER_DURATION;
+
+            Logger::print("Projectile hit enemy! Enemy HP: %d\n", m_enemyManager.getVida(hitEnemy));
         }
 
-        if (!proj.active)
+        if (!m_projectileManager.isActive(p))
             continue;
 
         // ─────────────────────────────────────────────
@@ -679,15 +1250,15 @@ void Game::handleProjectileCollisions()
             if (testPointSphere(projPos, dragonPos, bossRadius + projectileRadius))
             {
                 m_dragonBoss.takeDamage(100);
-                proj.active = false;
+                m_projectileManager.deactivate(p);
                 m_hitMarkerTimer = HIT_MARKER_DURATION;
 
-                printf("Projectile hit Dragon Boss! HP: %d\n", m_dragonBoss.getVida());
+                Logger::print("Projectile hit Dragon Boss! HP: %d\n", m_dragonBoss.getVida());
 
                 if (m_dragonBoss.isDead())
                 {
                     m_dragonBossAlive = false;
-                    printf("*** DRAGON BOSS DEFEATED! ***\n");
+                    Logger::print("*** DRAGON BOSS DEFEATED! ***\n");
                 }
             }
         }
@@ -724,7 +1295,7 @@ void Game::handleDragonAttack(float deltaTime)
         }
 
         m_projectileManager.spawnProjectile(dragonPos, dir, true);
-        printf("Dragon fires at player!\n");
+        Logger::print("Dragon fires at player!\n");
     }
 }
 
@@ -760,7 +1331,7 @@ void Game::handleHealthPickups(float deltaTime)
         {
             m_player.heal(m_healthPickups[i].healAmount);
             m_healthPickups[i].active = false;
-            printf("Player picked up health! +%d HP\n", m_healthPickups[i].healAmount);
+            Logger::print("Player picked up health! +%d HP\n", m_healthPickups[i].healAmount);
         }
     }
 
@@ -775,8 +1346,8 @@ void Game::handleHealthPickups(float deltaTime)
 
 void Game::spawnHealthPickup()
 {
-    float x = ((float)rand() / RAND_MAX) * 6.0f - 3.0f;
-    float z = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    float x = m_random.nextFloat() * 6.0f - 3.0f;
+    float z = m_random.nextFloat() * 2.0f - 1.0f;
 
     HealthPickup pickup;
     pickup.position = glm::vec3(x, 0.05f, z);
@@ -784,7 +1355,7 @@ void Game::spawnHealthPickup()
     pickup.healAmount = 25;
 
     m_healthPickups.push_back(pickup);
-    printf("Health pickup spawned at (%.2f, %.2f)\n", x, z);
+    Logger::print("Health pickup spawned at (%.2f, %.2f)\n", x, z);
 }
 
 void Game::updateEnemySpeed(float deltaTime)
@@ -801,7 +1372,13 @@ void Game::updateEnemySpeed(float deltaTime)
 
 void Game::cleanup()
 {
-    sfx.stop();
+    if (m_recorder.isOpen())
+        m_recorder.close(computeStateHash());
+
+    if (m_headless)
+        return;
+
+    m_sfx.stop();
     glfwTerminate();
 }
 
@@ -848,11 +1425,10 @@ void Game::startGame()
 {
     result_sfx=true;
     menu_music=true;
-    sfx.musicaPrincipalStop();
-    sfx.musicaPrincipalStart("sfx/main.mp3", true);
+    m_sfx.musicaPrincipalStop();
+    m_sfx.musicaPrincipalStart("sfx/main.mp3", true);
     m_gameState = GameState::COUNTDOWN;
     m_countdownTimer = 4.0f;
-    m_lastFrameTime = glfwGetTime();
 
     if (m_player.isFirstPerson())
         m_player.toggleCamera();
@@ -865,6 +1441,7 @@ void Game::resetGame()
     m_projectileManager.clear();
     m_healthPickups.clear();
     m_dragonBoss = Enemy(-3.5f, 0.0f, 5000);
+    m_dragonBoss.setSfx(&m_sfx);
     m_dragonBossAlive = true;
     m_hitMarkerTimer = 0.0f;
     m_muzzleFlashTimer = 0.0f;
@@ -883,6 +1460,7 @@ void Game::returnToMenu()
     m_projectileManager.clear();
     m_healthPickups.clear();
     m_dragonBoss = Enemy(-3.5f, 0.0f, 5000);
+    m_dragonBoss.setSfx(&m_sfx);
     m_dragonBossAlive = true;
     m_hitMarkerTimer = 0.0f;
     m_muzzleFlashTimer = 0.0f;
@@ -896,10 +1474,10 @@ void Game::togglePause()
     if (m_gameState == GameState::PLAYING)
     {
         m_gameState = GameState::PAUSED;
-        glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+        setCursorMode(GLFW_CURSOR_NORMAL);
 
         m_pauseFocusTarget = PauseFocusTarget::PLAYER;
-        m_pauseFocusEnemyIndex = 0;
+        m_pauseFocusEnemy = EnemyHandle();
         glm::vec4 playerPos = m_player.getPosition();
         m_pauseCameraTarget = glm::vec4(playerPos.x, 0.3f, playerPos.z, 1.0f);
         m_pauseCameraTheta = 0.0f;
@@ -909,7 +1487,7 @@ void Game::togglePause()
     else if (m_gameState == GameState::PAUSED)
     {
         m_gameState = GameState::PLAYING;
-        glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        setCursorMode(GLFW_CURSOR_DISABLED);
     }
 }
 
@@ -943,17 +1521,21 @@ void Game::cyclePauseFocusTarget(bool forward)
     if (m_gameState != GameState::PAUSED)
         return;
 
-    const std::vector<Enemy>& enemies = m_enemyManager.getEnemies();
+    const int enemyCount = (int)m_enemyManager.getEnemyCount();
+
+    // Índice atual do inimigo em foco; se ele já foi removido, a troca
+    // continua a partir do começo (ou do fim, para trás)
+    int focusIndex = m_enemyManager.findEnemy(m_pauseFocusEnemy);
 
     if (forward)
     {
         switch (m_pauseFocusTarget)
         {
         case PauseFocusTarget::PLAYER:
-            if (!enemies.empty())
+            if (enemyCount > 0)
             {
                 m_pauseFocusTarget = PauseFocusTarget::ENEMY;
-                m_pauseFocusEnemyIndex = 0;
+                focusIndex = 0;
             }
             else if (m_dragonBossAlive)
             {
@@ -961,19 +1543,17 @@ void Game::cyclePauseFocusTarget(bool forward)
             }
             break;
         case PauseFocusTarget::ENEMY:
-            m_pauseFocusEnemyIndex++;
-            if (m_pauseFocusEnemyIndex >= (int)enemies.size())
+            focusIndex++;
+            if (focusIndex >= enemyCount)
             {
                 if (m_dragonBossAlive)
                     m_pauseFocusTarget = PauseFocusTarget::DRAGON;
                 else
                     m_pauseFocusTarget = PauseFocusTarget::PLAYER;
-                m_pauseFocusEnemyIndex = 0;
             }
             break;
         case PauseFocusTarget::DRAGON:
             m_pauseFocusTarget = PauseFocusTarget::PLAYER;
-            m_pauseFocusEnemyIndex = 0;
             break;
         }
     }
@@ -984,25 +1564,24 @@ void Game::cyclePauseFocusTarget(bool forward)
         case PauseFocusTarget::PLAYER:
             if (m_dragonBossAlive)
                 m_pauseFocusTarget = PauseFocusTarget::DRAGON;
-            else if (!enemies.empty())
+            else if (enemyCount > 0)
             {
                 m_pauseFocusTarget = PauseFocusTarget::ENEMY;
-                m_pauseFocusEnemyIndex = enemies.size() - 1;
+                focusIndex = enemyCount - 1;
             }
             break;
         case PauseFocusTarget::ENEMY:
-            m_pauseFocusEnemyIndex--;
-            if (m_pauseFocusEnemyIndex < 0)
-            {
+            if (focusIndex < 0)
+                focusIndex = enemyCount;
+            focusIndex--;
+            if (focusIndex < 0)
                 m_pauseFocusTarget = PauseFocusTarget::PLAYER;
-                m_pauseFocusEnemyIndex = 0;
-            }
             break;
         case PauseFocusTarget::DRAGON:
-            if (!enemies.empty())
+            if (enemyCount > 0)
             {
                 m_pauseFocusTarget = PauseFocusTarget::ENEMY;
-                m_pauseFocusEnemyIndex = enemies.size() - 1;
+                focusIndex = enemyCount - 1;
             }
             else
                 m_pauseFocusTarget = PauseFocusTarget::PLAYER;
@@ -1010,13 +1589,18 @@ void Game::cyclePauseFocusTarget(bool forward)
         }
     }
 
+    if (m_pauseFocusTarget == PauseFocusTarget::ENEMY)
+        m_pauseFocusEnemy = m_enemyManager.getHandle(focusIndex);
+    else
+        m_pauseFocusEnemy = EnemyHandle();
+
     setPauseFocusTarget(m_pauseFocusTarget);
 }
 
 void Game::setPauseFocusTarget(PauseFocusTarget target)
 {
     m_pauseFocusTarget = target;
-    const std::vector<Enemy>& enemies = m_enemyManager.getEnemies();
+    const int enemyCount = (int)m_enemyManager.getEnemyCount();
 
     switch (target)
     {
@@ -1027,11 +1611,16 @@ void Game::setPauseFocusTarget(PauseFocusTarget target)
         }
         break;
     case PauseFocusTarget::ENEMY:
-        if (!enemies.empty())
+        if (enemyCount > 0)
         {
-            if (m_pauseFocusEnemyIndex >= (int)enemies.size())
-                m_pauseFocusEnemyIndex = 0;
-            glm::vec4 pos = enemies[m_pauseFocusEnemyIndex].getPosition();
+            // Sem inimigo em foco (ou se ele foi removido), foca o primeiro
+            int focusIndex = m_enemyManager.findEnemy(m_pauseFocusEnemy);
+            if (focusIndex < 0)
+            {
+                focusIndex = 0;
+                m_pauseFocusEnemy = m_enemyManager.getHandle(0);
+            }
+            glm::vec4 pos = m_enemyManager.getPosition(focusIndex);
             m_pauseCameraTarget = glm::vec4(pos.x, 0.15f, pos.z, 1.0f);
         }
         break;
@@ -4,109 +4,166 @@
 #include "Logger.h"
 #include <cstdio>
 
-Player* Input::s_player = nullptr;
-Game* Input::s_game = nullptr;
-float Input::s_screenRatio = 1.0f;
-bool Input::s_leftMouseButtonPressed = false;
-bool Input::s_shootRequested = false;
-double Input::s_lastCursorPosX = 0.0;
-double Input::s_lastCursorPosY = 0.0;
-
-void Input::init(Player* player, Game* game)
+Input::Input()
+    : m_player(nullptr)
+    , m_game(nullptr)
+    , m_screenRatio(1.0f)
+    , m_leftMouseButtonPressed(false)
+    , m_lastCursorPosX(0.0)
+    , m_lastCursorPosY(0.0)
+    , m_cursorLogCount(0)
 {
-    s_player = player;
-    s_game = game;
+}
+
+void Input::init(GLFWwindow* window, Player* player, Game* game)
+{
+    m_player = player;
+    m_game = game;
+
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, Input::keyCallback);
+    glfwSetMouseButtonCallback(window, Input::mouseButtonCallback);
+    glfwSetCursorPosCallback(window, Input::cursorPosCallback);
+    glfwSetScrollCallback(window, Input::scrollCallback);
+    glfwSetFramebufferSizeCallback(window, Input::framebufferSizeCallback);
+}
+
+// ============================================================================
+// CALLBACKS DO GLFW
+// ============================================================================
+// O GLFW só aceita funções livres/estáticas como callback. Cada uma recupera
+// a instância de Input guardada no user pointer da janela e repassa o evento.
+// ============================================================================
+Input* Input::fromWindow(GLFWwindow* window)
+{
+    return static_cast<Input*>(glfwGetWindowUserPointer(window));
 }
 
 void Input::framebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
-    s_screenRatio = (float)width / height;
+    Input* input = fromWindow(window);
+    if (input != nullptr)
+        input->onFramebufferSize(width, height);
 }
 
 void Input::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+    Input* input = fromWindow(window);
+    if (input != nullptr)
+        input->onMouseButton(window, button, action);
+}
+
+void Input::cursorPosCallback(GLFWwindow* window, double xpos, double ypos)
+{
+    Input* input = fromWindow(window);
+    if (input != nullptr)
+        input->onCursorPos(xpos, ypos);
+}
+
+void Input::scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    Input* input = fromWindow(window);
+    if (input != nullptr)
+        input->onScroll(yoffset);
+}
+
+void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
+{
+    Input* input = fromWindow(window);
+    if (input != nullptr)
+        input->onKey(window, key, action);
+}
+
+void Input::onFramebufferSize(int width, int height)
+{
+    glViewport(0, 0, width, height);
+    m_screenRatio = (float)width / height;
+}
+
+void Input::onMouseButton(GLFWwindow* window, int button, int action)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
     {
-        glfwGetCursorPos(window, &s_lastCursorPosX, &s_lastCursorPosY);
-        s_leftMouseButtonPressed = true;
+        glfwGetCursorPos(window, &m_lastCursorPosX, &m_lastCursorPosY);
+        m_leftMouseButtonPressed = true;
 
-        if (s_player != nullptr && s_player->isFirstPerson() &&
-            s_game != nullptr && s_game->getGameState() == GameState::PLAYING)
-            s_shootRequested = true;
+        if (m_player != nullptr && m_player->isFirstPerson() &&
+            m_game != nullptr && m_game->getGameState() == GameState::PLAYING)
+            m_pendingFrame.shoot = true;
     }
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
     {
-        s_leftMouseButtonPressed = false;
+        m_leftMouseButtonPressed = false;
     }
 }
 
-void Input::cursorPosCallback(GLFWwindow* window, double xpos, double ypos)
+void Input::onCursorPos(double xpos, double ypos)
 {
-    static int callback_count = 0;
-    callback_count++;
-    bool should_log = (callback_count % 100 == 0);
+    m_cursorLogCount++;
+    bool should_log = (m_cursorLogCount % 100 == 0);
 
-    if (s_player == nullptr)
+    if (m_player == nullptr)
     {
         if (should_log)
-            Logger::logEvent("Input.cursorPosCallback.error", "{\"reason\":\"s_player is null\"}");
+            Logger::logEvent("Input.cursorPosCallback.error", "{\"reason\":\"m_player is null\"}");
         return;
     }
 
-    float dx = xpos - s_lastCursorPosX;
-    float dy = ypos - s_lastCursorPosY;
+    float dx = xpos - m_lastCursorPosX;
+    float dy = ypos - m_lastCursorPosY;
 
     if (should_log)
         Logger::logEvent("Input.cursorPosCallback",
             "{\"x\":%.1f,\"y\":%.1f,\"dx\":%.1f,\"dy\":%.1f,\"firstPerson\":%s,\"leftPressed\":%s,\"count\":%d}",
             xpos, ypos, dx, dy,
-            s_player->isFirstPerson() ? "true" : "false",
-            s_leftMouseButtonPressed ? "true" : "false",
-            callback_count);
+            m_player->isFirstPerson() ? "true" : "false",
+            m_leftMouseButtonPressed ? "true" : "false",
+            m_cursorLogCount);
 
-    if (s_game != nullptr && s_game->getGameState() == GameState::PAUSED)
+    if (m_game != nullptr && m_game->getGameState() == GameState::PAUSED)
     {
-        if (s_leftMouseButtonPressed)
+        if (m_leftMouseButtonPressed)
         {
-            s_game->handlePauseCameraMove(dx, dy);
+            m_game->handlePauseCameraMove(dx, dy);
         }
-        s_lastCursorPosX = xpos;
-        s_lastCursorPosY = ypos;
+        m_lastCursorPosX = xpos;
+        m_lastCursorPosY = ypos;
         return;
     }
 
-    if (!s_player->isFirstPerson())
+    if (!m_player->isFirstPerson())
     {
-        if (!s_leftMouseButtonPressed)
+        if (!m_leftMouseButtonPressed)
         {
-            s_lastCursorPosX = xpos;
-            s_lastCursorPosY = ypos;
+            m_lastCursorPosX = xpos;
+            m_lastCursorPosY = ypos;
             return;
         }
     }
 
-    s_player->handleMouseMove(dx, dy);
+    // A rotação da câmera do jogador é aplicada no próximo tick
+    m_pendingFrame.lookDx += dx;
+    m_pendingFrame.lookDy += dy;
 
-    s_lastCursorPosX = xpos;
-    s_lastCursorPosY = ypos;
+    m_lastCursorPosX = xpos;
+    m_lastCursorPosY = ypos;
 }
 
-void Input::scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+void Input::onScroll(double yoffset)
 {
-    if (s_game != nullptr && s_game->getGameState() == GameState::PAUSED)
+    if (m_game != nullptr && m_game->getGameState() == GameState::PAUSED)
     {
-        s_game->handlePauseCameraZoom(yoffset);
+        m_game->handlePauseCameraZoom(yoffset);
         return;
     }
 
-    if (s_player == nullptr)
+    if (m_player == nullptr)
         return;
 
-    s_player->handleScroll(yoffset);
+    m_player->handleScroll(yoffset);
 }
 
-void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
+void Input::onKey(GLFWwindow* window, int key, int action)
 {
     Logger::logEvent("Input.keyCallback",
         "{\"key\":%d,\"action\":%d,\"isF\":%s,\"isESC\":%s,\"isK\":%s}",
@@ -115,13 +172,13 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
         (key == GLFW_KEY_ESCAPE) ? "true" : "false",
         (key == GLFW_KEY_K) ? "true" : "false");
 
-    if (s_game == nullptr)
+    if (m_game == nullptr)
     {
-        printf("[Input] s_game is nullptr!\n");
+        printf("[Input] m_game is nullptr!\n");
         return;
     }
 
-    GameState gameState = s_game->getGameState();
+    GameState gameState = m_game->getGameState();
 
     printf("[Input] GameState=%d, key=%d, action=%d, GLFW_KEY_1=%d, GLFW_PRESS=%d\n",
            (int)gameState, key, action, GLFW_KEY_1, GLFW_PRESS);
@@ -133,20 +190,17 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
         if (key == GLFW_KEY_1)
         {
             printf("[Input] Starting game with difficulty 0\n");
-            s_game->setDifficulty(0);
-            s_game->startGame();
+            m_pendingFrame.startDifficulty = 0;
             return;
         }
         else if (key == GLFW_KEY_2)
         {
-            s_game->setDifficulty(1);
-            s_game->startGame();
+            m_pendingFrame.startDifficulty = 1;
             return;
         }
         else if (key == GLFW_KEY_3)
         {
-            s_game->setDifficulty(2);
-            s_game->startGame();
+            m_pendingFrame.startDifficulty = 2;
             return;
         }
     }
@@ -155,12 +209,12 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     {
         if (key == GLFW_KEY_R)
         {
-            s_game->resetGame();
+            m_pendingFrame.restart = true;
             return;
         }
         else if (key == GLFW_KEY_M)
         {
-            s_game->returnToMenu();
+            m_pendingFrame.returnToMenu = true;
             return;
         }
     }
@@ -169,7 +223,7 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     {
         if (gameState == GameState::PLAYING || gameState == GameState::PAUSED)
         {
-            s_game->togglePause();
+            m_pendingFrame.togglePause = true;
         }
         return;
     }
@@ -178,27 +232,27 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     {
         if (key == GLFW_KEY_TAB || key == GLFW_KEY_RIGHT || key == GLFW_KEY_D)
         {
-            s_game->cyclePauseFocusTarget(true);  
+            m_game->cyclePauseFocusTarget(true);  
             return;
         }
         if (key == GLFW_KEY_LEFT || key == GLFW_KEY_A)
         {
-            s_game->cyclePauseFocusTarget(false);  
+            m_game->cyclePauseFocusTarget(false);  
             return;
         }
         if (key == GLFW_KEY_1)
         {
-            s_game->setPauseFocusTarget(PauseFocusTarget::PLAYER);
+            m_game->setPauseFocusTarget(PauseFocusTarget::PLAYER);
             return;
         }
         if (key == GLFW_KEY_2)
         {
-            s_game->setPauseFocusTarget(PauseFocusTarget::ENEMY);
+            m_game->setPauseFocusTarget(PauseFocusTarget::ENEMY);
             return;
         }
         if (key == GLFW_KEY_3)
         {
-            s_game->setPauseFocusTarget(PauseFocusTarget::DRAGON);
+            m_game->setPauseFocusTarget(PauseFocusTarget::DRAGON);
             return;
         }
     }
@@ -207,11 +261,11 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     {
         if (gameState == GameState::PAUSED)
         {
-            s_game->togglePause();
+            m_pendingFrame.togglePause = true;
         }
         else if (gameState == GameState::PLAYING)
         {
-            s_game->returnToMenu();
+            m_pendingFrame.returnToMenu = true;
             glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
         }
         else
@@ -226,8 +280,7 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
 
     if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
     {
-        if (s_player != nullptr)
-            s_player->jump();
+        m_pendingFrame.jump = true;
         return;
     }
 
@@ -235,21 +288,24 @@ void Input::keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     {
         Logger::logEvent("Input.keyCallback.F_pressed", "{}");
 
-        if (s_player == nullptr)
+        if (m_player == nullptr)
         {
-            Logger::logEvent("Input.keyCallback.F_pressed.error", "{\"reason\":\"s_player is null\"}");
+            Logger::logEvent("Input.keyCallback.F_pressed.error", "{\"reason\":\"m_player is null\"}");
             return;
         }
 
-        s_player->toggleCamera();
+        // A troca de câmera é aplicada no próximo tick; o modo do cursor
+        // já segue o estado que a câmera terá depois dela
+        m_pendingFrame.toggleCamera = !m_pendingFrame.toggleCamera;
+        bool willBeFirstPerson = m_player->isFirstPerson() != m_pendingFrame.toggleCamera;
 
-        if (s_player->isFirstPerson())
+        if (willBeFirstPerson)
         {
             glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
             double xpos, ypos;
             glfwGetCursorPos(window, &xpos, &ypos);
-            s_lastCursorPosX = xpos;
-            s_lastCursorPosY = ypos;
+            m_lastCursorPosX = xpos;
+            m_lastCursorPosY = ypos;
             Logger::logEvent("Input.cursorMode.disabled",
                 "{\"x\":%.1f,\"y\":%.1f}",
                 xpos, ypos);
@@ -267,9 +323,9 @@ void Input::errorCallback(int error, const char* description)
     fprintf(stderr, "ERROR: GLFW: %s\n", description);
 }
 
-bool Input::isShootingRequested()
+InputFrame Input::consumeFrame()
 {
-    bool requested = s_shootRequested;
-    s_shootRequested = false;
-    return requested;
+    InputFrame frame = m_pendingFrame;
+    m_pendingFrame = InputFrame();
+    return frame;
 }
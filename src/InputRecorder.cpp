@@ -0,0 +1,384 @@
+// ============================================================================
+// INPUTRECORDER.CPP - Gravação e Replay de Sessões
+// ============================================================================
+//
+// Grava o InputFrame consumido por Game::update em cada tick e o reproduz
+// depois no lugar da entrada do GLFW. Usado para repetir a mesma sessão de
+// jogo real em cada build e comparar tempos de frame e de tick.
+//
+// ============================================================================
+
+#include "InputRecorder.h"
+#include <cstdio>
+#include <cstring>
+
+static const char REPLAY_MAGIC[4] = { 'F', 'G', 'C', 'R' };
+static const uint16_t REPLAY_VERSION = 1;
+static const size_t REPLAY_HEADER_SIZE = 36;
+
+enum ReplayFlags
+{
+    FLAG_FORWARD       = 1 << 0,
+    FLAG_BACKWARD      = 1 << 1,
+    FLAG_LEFT          = 1 << 2,
+    FLAG_RIGHT         = 1 << 3,
+    FLAG_JUMP          = 1 << 4,
+    FLAG_SHOOT         = 1 << 5,
+    FLAG_TOGGLE_CAMERA = 1 << 6,
+    FLAG_TOGGLE_PAUSE  = 1 << 7,
+    FLAG_RESTART       = 1 << 8,
+    FLAG_RETURN_MENU   = 1 << 9,
+    FLAG_START_GAME    = 1 << 10,
+    FLAG_LOOK          = 1 << 11
+};
+
+// ----------------------------------------------------------------------------
+// Leitura/escrita little-endian, independente da plataforma
+// ----------------------------------------------------------------------------
+static void putU16(std::vector<unsigned char>& out, uint16_t v)
+{
+    out.push_back(static_cast<unsigned char>(v));
+    out.push_back(static_cast<unsigned char>(v >> 8));
+}
+
+static void putU32(std::vector<unsigned char>& out, uint32_t v)
+{
+    for (int i = 0; i < 4; i++)
+        out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+}
+
+static void putU64(std::vector<unsigned char>& out, uint64_t v)
+{
+    for (int i = 0; i < 8; i++)
+        out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+}
+
+static void putFloat(std::vector<unsigned char>& out, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    putU32(out, v);
+}
+
+static uint16_t getU16(const unsigned char* p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const unsigned char* p)
+{
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++)
+        v |= static_cast<uint32_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static uint64_t getU64(const unsigned char* p)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static float getFloat(const unsigned char* p)
+{
+    uint32_t v = getU32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+// Cabeçalho completo, REPLAY_HEADER_SIZE bytes
+static void putHeader(std::vector<unsigned char>& out, const ReplayHeader& header)
+{
+    out.insert(out.end(), REPLAY_MAGIC, REPLAY_MAGIC + 4);
+    putU16(out, REPLAY_VERSION);
+    putU16(out, 0);
+    putU64(out, header.seed);
+    putU32(out, static_cast<uint32_t>(header.difficulty));
+    putFloat(out, header.tickRate);
+    putU32(out, header.frameCount);
+    putU64(out, header.finalStateHash);
+}
+
+// ============================================================================
+// GRAVAÇÃO
+// ============================================================================
+InputRecorder::InputRecorder()
+    : m_file(NULL)
+    , m_failed(false)
+    , m_flushInterval(1)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+// Uma gravação não fechada (exceção, saída antecipada) fica no .tmp, com
+// tudo o que já foi escrito
+InputRecorder::~InputRecorder()
+{
+    if (m_file)
+    {
+        flush();
+        fclose(m_file);
+    }
+}
+
+bool InputRecorder::open(const char* path, uint64_t seed, int difficulty, float tickRate)
+{
+    // O arquivo de destino só é substituído em close(), quando a gravação
+    // estiver completa
+    m_path.assign(path, path + strlen(path) + 1);
+    m_tempPath.assign(path, path + strlen(path));
+    const char* suffix = ".tmp";
+    m_tempPath.insert(m_tempPath.end(), suffix, suffix + strlen(suffix) + 1);
+
+    m_file = fopen(&m_tempPath[0], "wb");
+    if (!m_file)
+    {
+        fprintf(stderr, "ERROR: Cannot open \"%s\" for recording.\n", &m_tempPath[0]);
+        return false;
+    }
+
+    m_header.seed = seed;
+    m_header.difficulty = difficulty;
+    m_header.tickRate = tickRate;
+    m_header.frameCount = 0;
+    m_header.finalStateHash = 0;
+    m_failed = false;
+    m_flushInterval = tickRate >= 1.0f ? static_cast<uint32_t>(tickRate) : 1;
+
+    // Cabeçalho provisório: 0 ticks e sem hash, completado em close()
+    m_data.clear();
+    m_data.reserve(4096);
+    putHeader(m_data, m_header);
+    return flush();
+}
+
+// Escreve os registros pendentes e os descarrega em disco
+bool InputRecorder::flush()
+{
+    if (m_failed)
+        return false;
+
+    if (!m_data.empty() && fwrite(&m_data[0], 1, m_data.size(), m_file) != m_data.size())
+        m_failed = true;
+    m_data.clear();
+    if (!m_failed && fflush(m_file) != 0)
+        m_failed = true;
+
+    if (m_failed)
+        fprintf(stderr, "ERROR: Failed writing recording \"%s\".\n", &m_tempPath[0]);
+    return !m_failed;
+}
+
+void InputRecorder::write(const InputFrame& frame)
+{
+    if (!m_file)
+        return;
+
+    uint16_t flags = 0;
+    if (frame.movement.forward)  flags |= FLAG_FORWARD;
+    if (frame.movement.backward) flags |= FLAG_BACKWARD;
+    if (frame.movement.left)     flags |= FLAG_LEFT;
+    if (frame.movement.right)    flags |= FLAG_RIGHT;
+    if (frame.jump)              flags |= FLAG_JUMP;
+    if (frame.shoot)             flags |= FLAG_SHOOT;
+    if (frame.toggleCamera)      flags |= FLAG_TOGGLE_CAMERA;
+    if (frame.togglePause)       flags |= FLAG_TOGGLE_PAUSE;
+    if (frame.restart)           flags |= FLAG_RESTART;
+    if (frame.returnToMenu)      flags |= FLAG_RETURN_MENU;
+    if (frame.startDifficulty >= 0)
+        flags |= FLAG_START_GAME;
+    if (frame.lookDx != 0.0f || frame.lookDy != 0.0f)
+        flags |= FLAG_LOOK;
+
+    putU16(m_data, flags);
+    if (flags & FLAG_START_GAME)
+        m_data.push_back(static_cast<unsigned char>(frame.startDifficulty));
+    if (flags & FLAG_LOOK)
+    {
+        putFloat(m_data, frame.lookDx);
+        putFloat(m_data, frame.lookDy);
+    }
+
+    m_header.frameCount++;
+    if (m_header.frameCount % m_flushInterval == 0)
+        flush();
+}
+
+bool InputRecorder::close(uint64_t finalStateHash)
+{
+    if (!m_file)
+        return false;
+    m_header.finalStateHash = finalStateHash;
+
+    bool ok = flush();
+    if (ok)
+    {
+        std::vector<unsigned char> header;
+        putHeader(header, m_header);
+        ok = fseek(m_file, 0, SEEK_SET) == 0
+            && fwrite(&header[0], 1, header.size(), m_file) == header.size();
+    }
+    ok = fclose(m_file) == 0 && ok;
+    m_file = NULL;
+
+#ifdef _WIN32
+    // rename() não sobrescreve um arquivo existente no Windows
+    if (ok)
+        remove(&m_path[0]);
+#endif
+    if (ok && rename(&m_tempPath[0], &m_path[0]) != 0)
+        ok = false;
+
+    if (!ok)
+    {
+        fprintf(stderr, "ERROR: Failed writing recording \"%s\"; the partial session is in \"%s\".\n",
+                &m_path[0], &m_tempPath[0]);
+        return false;
+    }
+
+    printf("[Replay] Recorded %u ticks (%.1f s) to %s\n",
+           m_header.frameCount, m_header.frameCount / m_header.tickRate, &m_path[0]);
+    return true;
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+InputReplay::InputReplay()
+    : m_open(false)
+    , m_offset(0)
+    , m_framesPlayed(0)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+// Registros completos a partir do cabeçalho; o último pode ter sido cortado
+// se a gravação foi interrompida
+static uint32_t countRecords(const std::vector<unsigned char>& data)
+{
+    uint32_t count = 0;
+    size_t offset = REPLAY_HEADER_SIZE;
+    while (offset + 2 <= data.size())
+    {
+        uint16_t flags = getU16(&data[offset]);
+        size_t size = 2;
+        if (flags & FLAG_START_GAME)
+            size += 1;
+        if (flags & FLAG_LOOK)
+            size += 8;
+        if (offset + size > data.size())
+            break;
+        offset += size;
+        count++;
+    }
+    return count;
+}
+
+bool InputReplay::open(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "ERROR: Cannot open replay \"%s\".\n", path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size < (long)REPLAY_HEADER_SIZE)
+    {
+        fclose(file);
+        fprintf(stderr, "ERROR: \"%s\" is not a replay file.\n", path);
+        return false;
+    }
+
+    m_data.resize(size);
+    bool ok = fread(&m_data[0], 1, size, file) == (size_t)size;
+    fclose(file);
+
+    const unsigned char* p = &m_data[0];
+    if (!ok || memcmp(p, REPLAY_MAGIC, 4) != 0)
+    {
+        fprintf(stderr, "ERROR: \"%s\" is not a replay file.\n", path);
+        return false;
+    }
+    if (getU16(p + 4) != REPLAY_VERSION)
+    {
+        fprintf(stderr, "ERROR: Unsupported replay version %u in \"%s\".\n", getU16(p + 4), path);
+        return false;
+    }
+
+    m_header.seed = getU64(p + 8);
+    m_header.difficulty = static_cast<int>(getU32(p + 16));
+    m_header.tickRate = getFloat(p + 20);
+    m_header.frameCount = getU32(p + 24);
+    m_header.finalStateHash = getU64(p + 28);
+
+    // Gravação que não chegou a close() (o .tmp): o cabeçalho ainda é o
+    // provisório, então os ticks são contados no próprio arquivo
+    if (m_header.frameCount == 0 && m_data.size() > REPLAY_HEADER_SIZE)
+    {
+        m_header.frameCount = countRecords(m_data);
+        printf("[Replay] \"%s\" was not closed; playing its %u complete ticks\n",
+               path, m_header.frameCount);
+    }
+
+    m_offset = REPLAY_HEADER_SIZE;
+    m_framesPlayed = 0;
+    m_open = true;
+    return true;
+}
+
+bool InputReplay::next(InputFrame& frame)
+{
+    if (!m_open || m_framesPlayed >= m_header.frameCount || m_offset + 2 > m_data.size())
+        return false;
+
+    const unsigned char* p = &m_data[0];
+    uint16_t flags = getU16(p + m_offset);
+    m_offset += 2;
+
+    size_t payload = 0;
+    if (flags & FLAG_START_GAME)
+        payload += 1;
+    if (flags & FLAG_LOOK)
+        payload += 8;
+    if (m_offset + payload > m_data.size())
+    {
+        fprintf(stderr, "ERROR: Replay file is truncated at tick %u.\n", m_framesPlayed);
+        m_offset = m_data.size();
+        return false;
+    }
+
+    frame = InputFrame();
+    frame.movement.forward  = (flags & FLAG_FORWARD) != 0;
+    frame.movement.backward = (flags & FLAG_BACKWARD) != 0;
+    frame.movement.left     = (flags & FLAG_LEFT) != 0;
+    frame.movement.right    = (flags & FLAG_RIGHT) != 0;
+    frame.jump              = (flags & FLAG_JUMP) != 0;
+    frame.shoot             = (flags & FLAG_SHOOT) != 0;
+    frame.toggleCamera      = (flags & FLAG_TOGGLE_CAMERA) != 0;
+    frame.togglePause       = (flags & FLAG_TOGGLE_PAUSE) != 0;
+    frame.restart           = (flags & FLAG_RESTART) != 0;
+    frame.returnToMenu      = (flags & FLAG_RETURN_MENU) != 0;
+
+    if (flags & FLAG_START_GAME)
+    {
+        frame.startDifficulty = static_cast<signed char>(p[m_offset]);
+        m_offset += 1;
+    }
+    if (flags & FLAG_LOOK)
+    {
+        frame.lookDx = getFloat(p + m_offset);
+        frame.lookDy = getFloat(p + m_offset + 4);
+        m_offset += 8;
+    }
+
+    m_framesPlayed++;
+    return true;
+}
@@ -0,0 +1,279 @@
+// ============================================================================
+// MESHCACHE.CPP - Cache Binário de Malhas
+// ============================================================================
+//
+// Leitura por mapeamento de memória (mmap no Linux/macOS, MapViewOfFile no
+// Windows): o sistema carrega as páginas do arquivo sob demanda e o upload
+// para o GL lê direto delas, sem cópia intermediária.
+//
+// ============================================================================
+
+#include "MeshCache.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static const char MESH_CACHE_MAGIC[4] = { 'F', 'G', 'C', 'M' };
+
+struct MeshCacheHeader
+{
+    char     magic[4];
+    uint16_t version;
+    uint16_t indexSize;
+    uint64_t sourceHash;
+    uint32_t submeshCount;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t reserved;
+};
+
+// ----------------------------------------------------------------------------
+// Arquivo mapeado
+// ----------------------------------------------------------------------------
+MappedFile::MappedFile()
+    : m_data(NULL)
+    , m_size(0)
+#ifdef _WIN32
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(NULL)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+    m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m_mapping != NULL)
+        m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_data == NULL)
+    {
+        close();
+        return false;
+    }
+    m_size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != NULL)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != NULL)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_data = NULL;
+    m_size = 0;
+    m_mapping = NULL;
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // O mapeamento continua válido depois de fechar o descritor
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = (const unsigned char*)data;
+    m_size = (size_t)info.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data != NULL)
+        munmap((void*)m_data, m_size);
+    m_data = NULL;
+    m_size = 0;
+}
+
+#endif
+
+// ----------------------------------------------------------------------------
+// Cache
+// ----------------------------------------------------------------------------
+uint64_t HashBytes(const unsigned char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool ReadMeshCache(const MappedFile& file, uint64_t sourceHash, MeshView& view)
+{
+    if (file.data() == NULL || file.size() < sizeof(MeshCacheHeader))
+        return false;
+
+    MeshCacheHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, MESH_CACHE_MAGIC, 4) != 0
+        || header.version != MESH_CACHE_VERSION
+        || header.sourceHash != sourceHash
+        || (header.indexSize != 2 && header.indexSize != 4))
+        return false;
+
+    size_t submeshBytes = (size_t)header.submeshCount * sizeof(MeshSubmesh);
+    size_t vertexBytes  = (size_t)header.vertexCount * sizeof(MeshVertex);
+    size_t indexBytes   = (size_t)header.indexCount * header.indexSize;
+    if (file.size() != sizeof(header) + submeshBytes + vertexBytes + indexBytes)
+        return false;
+
+    // O conteúdo vai direto para o GL e para os SceneObject: um arquivo
+    // corrompido é descartado aqui (e o .obj é lido de novo) em vez de virar
+    // nome sem terminador, LOD fora do array ou índice fora dos buffers
+    const unsigned char* p = file.data() + sizeof(header);
+    const MeshSubmesh* submeshes = (const MeshSubmesh*)p;
+    for (uint32_t i = 0; i < header.submeshCount; i++)
+    {
+        const MeshSubmesh& submesh = submeshes[i];
+        if (memchr(submesh.name, '\0', MESH_CACHE_NAME_SIZE) == NULL)
+            return false;
+        if (submesh.numLods == 0 || submesh.numLods > (uint32_t)MESH_CACHE_MAX_LODS)
+            return false;
+        for (uint32_t level = 0; level < submesh.numLods; level++)
+        {
+            uint64_t end = (uint64_t)submesh.lodFirstIndex[level] + submesh.lodNumIndices[level];
+            if (end > header.indexCount)
+                return false;
+        }
+    }
+
+    const unsigned char* indices = p + submeshBytes + vertexBytes;
+    for (uint32_t i = 0; i < header.indexCount; i++)
+    {
+        uint32_t index = header.indexSize == 2 ? ((const uint16_t*)indices)[i]
+                                               : ((const uint32_t*)indices)[i];
+        if (index >= header.vertexCount)
+            return false;
+    }
+
+    view.submeshes    = (const MeshSubmesh*)p;
+    view.submeshCount = header.submeshCount;
+    p += submeshBytes;
+    view.vertices     = (const MeshVertex*)p;
+    view.vertexCount  = header.vertexCount;
+    p += vertexBytes;
+    view.indices      = p;
+    view.indexCount   = header.indexCount;
+    view.indexSize    = header.indexSize;
+    return true;
+}
+
+void ViewMeshData(const MeshData& mesh, std::vector<unsigned char>& packed, MeshView& view)
+{
+    view.indexSize = mesh.vertices.size() <= 65536 ? 2 : 4;
+    packed.resize(mesh.indices.size() * view.indexSize);
+    if (view.indexSize == 2)
+    {
+        uint16_t* out = (uint16_t*)(packed.empty() ? NULL : &packed[0]);
+        for (size_t i = 0; i < mesh.indices.size(); i++)
+            out[i] = (uint16_t)mesh.indices[i];
+    }
+    else if (!packed.empty())
+    {
+        memcpy(&packed[0], &mesh.indices[0], packed.size());
+    }
+
+    view.submeshes    = mesh.submeshes.empty() ? NULL : &mesh.submeshes[0];
+    view.submeshCount = (uint32_t)mesh.submeshes.size();
+    view.vertices     = mesh.vertices.empty() ? NULL : &mesh.vertices[0];
+    view.vertexCount  = (uint32_t)mesh.vertices.size();
+    view.indices      = packed.empty() ? NULL : &packed[0];
+    view.indexCount   = (uint32_t)mesh.indices.size();
+}
+
+bool WriteMeshCache(const char* path, uint64_t sourceHash, const MeshData& mesh)
+{
+    std::vector<unsigned char> packed;
+    MeshView view;
+    ViewMeshData(mesh, packed, view);
+
+    MeshCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+    header.version      = MESH_CACHE_VERSION;
+    header.indexSize    = (uint16_t)view.indexSize;
+    header.sourceHash   = sourceHash;
+    header.submeshCount = view.submeshCount;
+    header.vertexCount  = view.vertexCount;
+    header.indexCount   = view.indexCount;
+
+    FILE* file = fopen(path, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "ERROR: Cannot write mesh cache \"%s\".\n", path);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && view.submeshCount > 0)
+        ok = fwrite(view.submeshes, sizeof(MeshSubmesh), view.submeshCount, file) == view.submeshCount;
+    if (ok && view.vertexCount > 0)
+        ok = fwrite(view.vertices, sizeof(MeshVertex), view.vertexCount, file) == view.vertexCount;
+    if (ok && !packed.empty())
+        ok = fwrite(&packed[0], 1, packed.size(), file) == packed.size();
+    ok = fclose(file) == 0 && ok;
+
+    // Um cache incompleto seria rejeitado pelo tamanho, mas melhor não deixá-lo
+    if (!ok)
+    {
+        remove(path);
+        fprintf(stderr, "ERROR: Failed writing mesh cache \"%s\".\n", path);
+    }
+    return ok;
+}
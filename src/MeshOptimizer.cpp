@@ -0,0 +1,208 @@
+// ============================================================================
+// MESHOPTIMIZER.CPP - Ordem de Triângulos e Vértices para a GPU
+// ============================================================================
+//
+// Forsyth: cada vértice tem uma pontuação que cresce quando ele está no topo
+// de um cache LRU simulado e quando restam poucos triângulos para usá-lo
+// (vértices "quase terminados" são priorizados, para não voltarem depois).
+// A pontuação de um triângulo é a soma das dos seus vértices. A cada passo
+// sai o melhor triângulo entre os que tocam o cache; só esses têm a
+// pontuação recalculada, então o custo é linear no número de triângulos.
+//
+// ============================================================================
+
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+static const int   CACHE_SIZE          = 32;
+static const float CACHE_DECAY_POWER   = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+static const int   MAX_VALENCE         = 32;
+
+// Pontuações tabeladas: posição no cache (-1 = fora) e triângulos restantes
+struct VertexScoreTable
+{
+    float cache[CACHE_SIZE];
+    float valence[MAX_VALENCE];
+
+    VertexScoreTable()
+    {
+        for (int i = 0; i < CACHE_SIZE; i++)
+        {
+            // Os três vértices do último triângulo têm pontuação fixa: sem
+            // isso o algoritmo tenderia a repetir o mesmo triângulo em tiras
+            if (i < 3)
+                cache[i] = LAST_TRIANGLE_SCORE;
+            else
+                cache[i] = powf(1.0f - (float)(i - 3) / (float)(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        valence[0] = 0.0f;
+        for (int i = 1; i < MAX_VALENCE; i++)
+            valence[i] = VALENCE_BOOST_SCALE * powf((float)i, -VALENCE_BOOST_POWER);
+    }
+
+    float score(int cachePosition, unsigned remainingTriangles) const
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+        float result = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+        return result + valence[std::min(remainingTriangles, (unsigned)MAX_VALENCE - 1)];
+    }
+};
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+{
+    static const VertexScoreTable table;
+
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+
+    // Triângulos de cada vértice, em listas compactas (offset + contagem)
+    std::vector<unsigned> remaining(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); i++)
+        remaining[indices[i]]++;
+
+    std::vector<unsigned> offset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        offset[v + 1] = offset[v] + remaining[v];
+
+    std::vector<unsigned> triangles(indices.size());
+    std::vector<unsigned> filled(offset.begin(), offset.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++)
+        for (int k = 0; k < 3; k++)
+            triangles[filled[indices[3*t + k]]++] = (unsigned)t;
+
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+        vertexScore[v] = table.score(-1, remaining[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+        triangleScore[t] = vertexScore[indices[3*t]] + vertexScore[indices[3*t + 1]] + vertexScore[indices[3*t + 2]];
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<int>  cachePosition(vertexCount, -1);
+    std::vector<unsigned> output;
+    output.reserve(indices.size());
+
+    // O cache tem 3 entradas extras para os vértices que acabaram de sair
+    unsigned cache[CACHE_SIZE + 3];
+    int cacheCount = 0;
+
+    size_t best = 0;
+    for (size_t t = 1; t < triangleCount; t++)
+        if (triangleScore[t] > triangleScore[best])
+            best = t;
+
+    size_t nextUnemitted = 0;
+    for (size_t step = 0; step < triangleCount; step++)
+    {
+        // Nenhum triângulo toca o cache: recomeça do primeiro não emitido
+        if (best == (size_t)-1)
+        {
+            while (emitted[nextUnemitted])
+                nextUnemitted++;
+            best = nextUnemitted;
+        }
+
+        emitted[best] = true;
+        unsigned tri[3] = { indices[3*best], indices[3*best + 1], indices[3*best + 2] };
+        output.insert(output.end(), tri, tri + 3);
+
+        // Tira o triângulo das listas dos seus vértices
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned v = tri[k];
+            unsigned* list = &triangles[offset[v]];
+            unsigned* end = list + remaining[v];
+            *std::find(list, end, (unsigned)best) = *(end - 1);
+            remaining[v]--;
+        }
+
+        // Os três vértices vão para o topo do cache, na ordem do triângulo
+        unsigned newCache[CACHE_SIZE + 3];
+        int newCount = 0;
+        for (int k = 0; k < 3; k++)
+            newCache[newCount++] = tri[k];
+        for (int i = 0; i < cacheCount; i++)
+            if (cache[i] != tri[0] && cache[i] != tri[1] && cache[i] != tri[2])
+                newCache[newCount++] = cache[i];
+
+        // Quem ficou além do cache sai, mas ainda tem a pontuação atualizada
+        for (int i = 0; i < newCount; i++)
+        {
+            unsigned v = newCache[i];
+            cachePosition[v] = i < CACHE_SIZE ? i : -1;
+            vertexScore[v] = table.score(cachePosition[v], remaining[v]);
+        }
+
+        cacheCount = std::min(newCount, CACHE_SIZE);
+        std::copy(newCache, newCache + newCount, cache);
+
+        // Pontua de novo os triângulos dos vértices do cache e escolhe o melhor
+        best = (size_t)-1;
+        float bestScore = -1.0f;
+        for (int i = 0; i < newCount; i++)
+        {
+            unsigned v = newCache[i];
+            for (unsigned j = 0; j < remaining[v]; j++)
+            {
+                unsigned t = triangles[offset[v] + j];
+                float s = vertexScore[indices[3*t]] + vertexScore[indices[3*t + 1]] + vertexScore[indices[3*t + 2]];
+                triangleScore[t] = s;
+                if (s > bestScore)
+                {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(output);
+}
+
+void OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount,
+                         std::vector<unsigned int>& remap)
+{
+    const unsigned UNUSED = (unsigned)-1;
+    remap.assign(vertexCount, UNUSED);
+
+    unsigned next = 0;
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        unsigned& target = remap[indices[i]];
+        if (target == UNUSED)
+            target = next++;
+        indices[i] = target;
+    }
+
+    for (size_t v = 0; v < vertexCount; v++)
+        if (remap[v] == UNUSED)
+            remap[v] = next++;
+}
+
+float ComputeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize)
+{
+    if (indices.size() < 3)
+        return 0.0f;
+
+    // Cache FIFO: o vértice guarda o "instante" em que entrou; está no cache
+    // se entrou há menos de cacheSize falhas
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    size_t misses = 0;
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        size_t& inserted = insertedAt[indices[i]];
+        if (inserted == 0 || misses + 1 - inserted > cacheSize)
+        {
+            misses++;
+            inserted = misses;
+        }
+    }
+    return (float)misses / (float)(indices.size() / 3);
+}
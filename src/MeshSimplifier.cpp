@@ -0,0 +1,364 @@
+// ============================================================================
+// MESHSIMPLIFIER.CPP - Níveis de Detalhe por Colapso de Arestas
+// ============================================================================
+//
+// Quádrica de erro de um plano n·p + d = 0 (n unitário):
+//
+//     Q = [ n nᵀ   n d ]       erro(p) = [p 1] Q [p 1]ᵀ = (n·p + d)²
+//         [ n d    d²  ]
+//
+// Cada posição acumula as quádricas dos planos dos seus triângulos
+// (ponderadas pela área). O custo de levar v até u é o erro de u na soma
+// Qv + Qu: a distância quadrática de u aos planos que v e u tinham na
+// malha original. Os colapsos mais baratos saem primeiro de uma fila de
+// prioridade; entradas desatualizadas são descartadas ao sair (cada
+// posição tem um contador de versão).
+//
+// ============================================================================
+
+#include "MeshSimplifier.h"
+#include <glm/glm.hpp>
+#include <queue>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+// Matriz simétrica 4x4: a², ab, ac, ad, b², bc, bd, c², cd, d²
+struct Quadric
+{
+    double q[10];
+};
+
+static void addPlane(Quadric& quadric, double a, double b, double c, double d, double weight)
+{
+    quadric.q[0] += weight * a * a;
+    quadric.q[1] += weight * a * b;
+    quadric.q[2] += weight * a * c;
+    quadric.q[3] += weight * a * d;
+    quadric.q[4] += weight * b * b;
+    quadric.q[5] += weight * b * c;
+    quadric.q[6] += weight * b * d;
+    quadric.q[7] += weight * c * c;
+    quadric.q[8] += weight * c * d;
+    quadric.q[9] += weight * d * d;
+}
+
+// [p 1] (A + B) [p 1]ᵀ
+static double evaluateError(const Quadric& A, const Quadric& B, const glm::vec3& p)
+{
+    double q[10];
+    for (int i = 0; i < 10; i++)
+        q[i] = A.q[i] + B.q[i];
+
+    double x = p.x, y = p.y, z = p.z;
+    return q[0]*x*x + 2.0*q[1]*x*y + 2.0*q[2]*x*z + 2.0*q[3]*x
+         + q[4]*y*y + 2.0*q[5]*y*z + 2.0*q[6]*y
+         + q[7]*z*z + 2.0*q[8]*z
+         + q[9];
+}
+
+// Colapso candidato: leva a posição 'from' até 'to'. Válido enquanto as
+// versões das duas posições forem as mesmas de quando entrou na fila.
+struct Collapse
+{
+    double   cost;
+    int      from;
+    int      to;
+    unsigned fromVersion;
+    unsigned toVersion;
+
+    // std::priority_queue tira o maior primeiro: invertido para o menor custo
+    bool operator<(const Collapse& other) const { return cost > other.cost; }
+};
+
+class Simplifier
+{
+public:
+    Simplifier(const std::vector<glm::vec3>& positions,
+               const std::vector<int>& cornerPosition,
+               const std::vector<bool>& lockedPositions);
+
+    // Colapsa até restarem no máximo 'target' triângulos (ou não haver
+    // mais colapsos válidos) e devolve os cantos dos triângulos vivos
+    void reduceTo(size_t target, std::vector<unsigned int>& corners);
+
+private:
+    bool contains(int triangle, int position) const;
+    void pushCandidates(int position);
+    bool tryCollapse(int from, int to);
+
+    const std::vector<glm::vec3>& m_positions;
+
+    // Por triângulo: posição e canto de cada vértice (3 por triângulo)
+    std::vector<int>  m_trianglePosition;
+    std::vector<int>  m_triangleCorner;
+    std::vector<bool> m_triangleAlive;
+    size_t            m_aliveTriangles;
+
+    // Por posição
+    std::vector<Quadric>           m_quadrics;
+    std::vector< std::vector<int> > m_incident;  // triângulos que a usam
+    std::vector<bool>              m_locked;
+    std::vector<bool>              m_removed;
+    std::vector<unsigned>          m_version;
+
+    std::priority_queue<Collapse> m_heap;
+};
+
+Simplifier::Simplifier(const std::vector<glm::vec3>& positions,
+                       const std::vector<int>& cornerPosition,
+                       const std::vector<bool>& lockedPositions)
+    : m_positions(positions)
+    , m_trianglePosition(cornerPosition)
+    , m_triangleCorner(cornerPosition.size())
+    , m_triangleAlive(cornerPosition.size() / 3, true)
+    , m_aliveTriangles(0)
+    , m_quadrics(positions.size())
+    , m_incident(positions.size())
+    , m_locked(lockedPositions)
+    , m_removed(positions.size(), false)
+    , m_version(positions.size(), 0)
+{
+    m_locked.resize(positions.size(), false);
+    for (size_t i = 0; i < m_quadrics.size(); i++)
+        std::fill(m_quadrics[i].q, m_quadrics[i].q + 10, 0.0);
+
+    std::vector< std::pair<int, int> > edges;
+    size_t numTriangles = m_triangleAlive.size();
+    for (size_t t = 0; t < numTriangles; t++)
+    {
+        int p[3];
+        for (int k = 0; k < 3; k++)
+        {
+            m_triangleCorner[3*t + k] = (int)(3*t + k);
+            p[k] = m_trianglePosition[3*t + k];
+        }
+
+        if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2])
+        {
+            m_triangleAlive[t] = false;
+            continue;
+        }
+        m_aliveTriangles++;
+
+        // Plano do triângulo, com peso igual à área
+        glm::vec3 n = glm::cross(positions[p[1]] - positions[p[0]], positions[p[2]] - positions[p[0]]);
+        float length = glm::length(n);
+        if (length > 0.0f)
+        {
+            n /= length;
+            double d = -glm::dot(n, positions[p[0]]);
+            for (int k = 0; k < 3; k++)
+                addPlane(m_quadrics[p[k]], n.x, n.y, n.z, d, 0.5 * length);
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            m_incident[p[k]].push_back((int)t);
+            int a = p[k], b = p[(k + 1) % 3];
+            edges.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+        }
+    }
+
+    // Bordas abertas: arestas de um único triângulo. As duas pontas ficam
+    // travadas para o contorno da malha não se mover.
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i < edges.size(); )
+    {
+        size_t j = i + 1;
+        while (j < edges.size() && edges[j] == edges[i])
+            j++;
+        if (j - i == 1)
+        {
+            m_locked[edges[i].first] = true;
+            m_locked[edges[i].second] = true;
+        }
+        i = j;
+    }
+
+    for (size_t position = 0; position < positions.size(); position++)
+    {
+        if (!m_incident[position].empty())
+            pushCandidates((int)position);
+    }
+}
+
+bool Simplifier::contains(int triangle, int position) const
+{
+    return m_trianglePosition[3*triangle + 0] == position
+        || m_trianglePosition[3*triangle + 1] == position
+        || m_trianglePosition[3*triangle + 2] == position;
+}
+
+// Enfileira os colapsos das arestas de 'position' com os vizinhos, nos
+// dois sentidos (uma posição travada só pode ser destino)
+void Simplifier::pushCandidates(int position)
+{
+    std::vector<int> neighbours;
+    const std::vector<int>& incident = m_incident[position];
+    for (size_t i = 0; i < incident.size(); i++)
+    {
+        int t = incident[i];
+        if (!m_triangleAlive[t])
+            continue;
+        for (int k = 0; k < 3; k++)
+        {
+            int other = m_trianglePosition[3*t + k];
+            if (other != position)
+                neighbours.push_back(other);
+        }
+    }
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+    for (size_t i = 0; i < neighbours.size(); i++)
+    {
+        int other = neighbours[i];
+        if (!m_locked[position])
+        {
+            Collapse collapse;
+            collapse.cost = evaluateError(m_quadrics[position], m_quadrics[other], m_positions[other]);
+            collapse.from = position;
+            collapse.to = other;
+            collapse.fromVersion = m_version[position];
+            collapse.toVersion = m_version[other];
+            m_heap.push(collapse);
+        }
+        if (!m_locked[other])
+        {
+            Collapse collapse;
+            collapse.cost = evaluateError(m_quadrics[other], m_quadrics[position], m_positions[position]);
+            collapse.from = other;
+            collapse.to = position;
+            collapse.fromVersion = m_version[other];
+            collapse.toVersion = m_version[position];
+            m_heap.push(collapse);
+        }
+    }
+}
+
+bool Simplifier::tryCollapse(int from, int to)
+{
+    std::vector<int>& fromTriangles = m_incident[from];
+
+    // Canto de 'to' num triângulo da aresta: os triângulos de 'from' passam
+    // a usar este canto, que está no mesmo pedaço da textura que eles
+    // ('from' não é costura, senão estaria travada)
+    int toCorner = -1;
+    for (size_t i = 0; i < fromTriangles.size() && toCorner < 0; i++)
+    {
+        int t = fromTriangles[i];
+        if (!m_triangleAlive[t] || !contains(t, to))
+            continue;
+        for (int k = 0; k < 3; k++)
+        {
+            if (m_trianglePosition[3*t + k] == to)
+                toCorner = m_triangleCorner[3*t + k];
+        }
+    }
+    if (toCorner < 0)
+        return false;  // a aresta não existe mais
+
+    // Rejeita colapsos que viram algum triângulo do avesso (ou quase)
+    for (size_t i = 0; i < fromTriangles.size(); i++)
+    {
+        int t = fromTriangles[i];
+        if (!m_triangleAlive[t] || contains(t, to))
+            continue;
+
+        glm::vec3 before[3], after[3];
+        for (int k = 0; k < 3; k++)
+        {
+            int p = m_trianglePosition[3*t + k];
+            before[k] = m_positions[p];
+            after[k] = m_positions[p == from ? to : p];
+        }
+        glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+        glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+        float lengths = glm::length(normalBefore) * glm::length(normalAfter);
+        if (lengths <= 0.0f || glm::dot(normalBefore, normalAfter) < 0.2f * lengths)
+            return false;
+    }
+
+    // Aplica: triângulos da aresta somem, os demais trocam 'from' por 'to'
+    std::vector<int> merged;
+    for (size_t i = 0; i < fromTriangles.size(); i++)
+    {
+        int t = fromTriangles[i];
+        if (!m_triangleAlive[t])
+            continue;
+
+        if (contains(t, to))
+        {
+            m_triangleAlive[t] = false;
+            m_aliveTriangles--;
+            continue;
+        }
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (m_trianglePosition[3*t + k] == from)
+            {
+                m_trianglePosition[3*t + k] = to;
+                m_triangleCorner[3*t + k] = toCorner;
+            }
+        }
+        merged.push_back(t);
+    }
+
+    std::vector<int>& toTriangles = m_incident[to];
+    for (size_t i = 0; i < toTriangles.size(); i++)
+    {
+        if (m_triangleAlive[toTriangles[i]])
+            merged.push_back(toTriangles[i]);
+    }
+    toTriangles.swap(merged);
+    fromTriangles.clear();
+
+    for (int i = 0; i < 10; i++)
+        m_quadrics[to].q[i] += m_quadrics[from].q[i];
+    m_removed[from] = true;
+    m_version[to]++;
+
+    pushCandidates(to);
+    return true;
+}
+
+void Simplifier::reduceTo(size_t target, std::vector<unsigned int>& corners)
+{
+    while (m_aliveTriangles > target && !m_heap.empty())
+    {
+        Collapse collapse = m_heap.top();
+        m_heap.pop();
+
+        if (m_removed[collapse.from] || m_removed[collapse.to])
+            continue;
+        if (m_version[collapse.from] != collapse.fromVersion || m_version[collapse.to] != collapse.toVersion)
+            continue;
+
+        tryCollapse(collapse.from, collapse.to);
+    }
+
+    corners.clear();
+    corners.reserve(3 * m_aliveTriangles);
+    for (size_t t = 0; t < m_triangleAlive.size(); t++)
+    {
+        if (!m_triangleAlive[t])
+            continue;
+        for (int k = 0; k < 3; k++)
+            corners.push_back((unsigned int)m_triangleCorner[3*t + k]);
+    }
+}
+
+void SimplifyMesh(const std::vector<glm::vec3>& positions,
+                  const std::vector<int>& cornerPosition,
+                  const std::vector<bool>& lockedPositions,
+                  const std::vector<size_t>& targetTriangles,
+                  std::vector< std::vector<unsigned int> >& lods)
+{
+    Simplifier simplifier(positions, cornerPosition, lockedPositions);
+
+    lods.assign(targetTriangles.size(), std::vector<unsigned int>());
+    for (size_t level = 0; level < targetTriangles.size(); level++)
+        simplifier.reduceTo(targetTriangles[level], lods[level]);
+}
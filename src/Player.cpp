@@ -23,6 +23,7 @@
 
 Player::Player()
     : m_position(3.5f, 0.101f, 0.0f, 1.0f)
+    , m_previousPosition(3.5f, 0.101f, 0.0f, 1.0f)
     , m_velocityY(0.0f)
     , m_gravity(9.8f)
     , m_jumpForce(2.5f)
@@ -41,6 +42,10 @@ Player::Player()
     , m_maxVida(100)
     , m_damageCooldown(1.0f)
     , m_damageCooldownTimer(0.0f)
+    , m_sfx(nullptr)
+    , m_updateLogCount(0)
+    , m_viewLogCount(0)
+    , m_mouseLogCount(0)
 {
 }
 
@@ -66,14 +71,13 @@ Player::~Player()
 //     - Movimento é relativo aos eixos globais X e Z
 //     - Independente da rotação da câmera
 // ============================================================================
-void Player::update(GLFWwindow* window, float deltaTime)
+void Player::update(const PlayerInput& input, float deltaTime)
 {
     // Atualiza timer de cooldown de dano (evita dano múltiplo instantâneo)
     if (m_damageCooldownTimer > 0.0f)
         m_damageCooldownTimer -= deltaTime;
 
-    static int frame_count = 0;
-    bool should_log = (frame_count++ % 60 == 0);
+    bool should_log = (m_updateLogCount++ % 60 == 0);
 
     glm::vec2 movement_input(0.0f, 0.0f);
 
@@ -95,24 +99,24 @@ void Player::update(GLFWwindow* window, float deltaTime)
         camera_right_xz = camera_right_xz / norm(camera_right_xz);
 
         // W: move para frente (na direção do olhar)
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        if (input.forward)
         {
             // REQUISITO 10: velocidade * deltaTime garante movimento suave
             m_position += camera_front_xz * m_movementSpeed*deltaTime;
             movement_input.y += 1.0f;
-            if (should_log) printf("[FP Movement] W pressed, pos: (%.2f, %.2f, %.2f)\n", m_position.x, m_position.y, m_position.z);
+            if (should_log) Logger::print("[FP Movement] W pressed, pos: (%.2f, %.2f, %.2f)\n", m_position.x, m_position.y, m_position.z);
         }
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        if (input.backward)
         {
             m_position -= camera_front_xz * m_movementSpeed*deltaTime;
             movement_input.y -= 1.0f;
         }
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        if (input.left)
         {
             m_position -= camera_right_xz * m_movementSpeed*deltaTime;
             movement_input.x -= 1.0f;
         }
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        if (input.right)
         {
             m_position += camera_right_xz * m_movementSpeed*deltaTime;
             movement_input.x += 1.0f;
@@ -131,22 +135,22 @@ void Player::update(GLFWwindow* window, float deltaTime)
     // A/D: move no eixo X global
     else
     {
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+        if (input.forward)
         {
             m_position.z -= m_movementSpeed*deltaTime;
             movement_input.y += 1.0f;
         }
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+        if (input.backward)
         {
             m_position.z += m_movementSpeed*deltaTime;
             movement_input.y -= 1.0f;
         }
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+        if (input.left)
         {
             m_position.x -= m_movementSpeed*deltaTime;
             movement_input.x -= 1.0f;
         }
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+        if (input.right)
         {
             m_position.x += m_movementSpeed*deltaTime;
             movement_input.x += 1.0f;
@@ -171,7 +175,7 @@ void Player::update(GLFWwindow* window, float deltaTime)
     }
 
     if (should_log)
-        printf("[Player] Pos: (%.2f,%.2f,%.2f) Yaw:%.2f Pitch:%.2f FP:%d Angle:%.2f\n",
+        Logger::print("[Player] Pos: (%.2f,%.2f,%.2f) Yaw:%.2f Pitch:%.2f FP:%d Angle:%.2f\n",
                m_position.x, m_position.y, m_position.z, m_cameraYaw, m_cameraPitch, m_firstPerson, m_movementAngle);
 }
 
@@ -196,11 +200,16 @@ void Player::update(GLFWwindow* window, float deltaTime)
 //      view = (cos(pitch)*sin(yaw), sin(pitch), cos(pitch)*cos(yaw))
 //
 // Ambos os modos usam a função Matrix_Camera_View() de matrices.cpp
+//
+// O parâmetro alpha interpola a posição do jogador entre os dois últimos
+// ticks da simulação (ver Game::run), evitando trepidação da câmera quando
+// a taxa de frames difere da taxa de ticks.
 // ============================================================================
-glm::mat4 Player::getCameraView() const
+glm::mat4 Player::getCameraView(float alpha) const
 {
-    static int view_log_count = 0;
-    bool should_log = (view_log_count++ % 60 == 0);
+    glm::vec4 position = getInterpolatedPosition(alpha);
+
+    bool should_log = (m_viewLogCount++ % 60 == 0);
 
     // ─────────────────────────────────────────────────────────────────────────
     // CÂMERA LOOK-AT (Terceira Pessoa)
@@ -219,7 +228,7 @@ glm::mat4 Player::getCameraView() const
         float x = r * cos(m_cameraPhi) * sin(m_cameraTheta);
 
         glm::vec4 camera_offset = glm::vec4(x, y, z, 0.0f);
-        glm::vec4 camera_position_c = m_position + camera_offset;
+        glm::vec4 camera_position_c = position + camera_offset;
 
         const float arenaMinX = -4.2f;
         const float arenaMaxX = 4.2f;
@@ -235,7 +244,7 @@ glm::mat4 Player::getCameraView() const
         if (camera_position_c.y < minY) camera_position_c.y = minY;
         if (camera_position_c.y > maxY) camera_position_c.y = maxY;
 
-        glm::vec4 camera_lookat_l    = m_position;
+        glm::vec4 camera_lookat_l    = position;
         glm::vec4 camera_view_vector = camera_lookat_l - camera_position_c;
         glm::vec4 camera_up_vector   = glm::vec4(0.0f, 1.0f, 0.0f, 0.0f);
 
@@ -252,7 +261,7 @@ glm::mat4 Player::getCameraView() const
     {
         // Posição da câmera = posição do jogador + altura dos olhos
         float eye_height = 0.15f;
-        glm::vec4 camera_position_c = m_position + glm::vec4(0.0f, eye_height, 0.0f, 0.0f);
+        glm::vec4 camera_position_c = position + glm::vec4(0.0f, eye_height, 0.0f, 0.0f);
 
         // Calcula o vetor de direção do olhar usando coordenadas esféricas
         // yaw: rotação horizontal (olhar esquerda/direita)
@@ -289,8 +298,7 @@ void Player::toggleCamera()
 
 void Player::handleMouseMove(float dx, float dy)
 {
-    static int log_counter = 0;
-    bool should_log = (log_counter++ % 30 == 0 && (dx != 0 || dy != 0));
+    bool should_log = (m_mouseLogCount++ % 30 == 0 && (dx != 0 || dy != 0));
 
     if (!m_firstPerson)
     {
@@ -412,11 +420,12 @@ void Player::takeDamage(int damage)
     if (m_damageCooldownTimer <= 0.0f)
     {
         m_vida -= damage;
-        sfx.hit_player();
+        if (m_sfx)
+            m_sfx->hit_player();
         if (m_vida < 0)
             m_vida = 0;
         m_damageCooldownTimer = m_damageCooldown;
-        printf("[Player] Took %d damage! HP: %d/%d\n", damage, m_vida, m_maxVida);
+        Logger::print("[Player] Took %d damage! HP: %d/%d\n", damage, m_vida, m_maxVida);
     }
 }
 
@@ -425,8 +434,9 @@ void Player::heal(int amount)
     m_vida += amount;
     if (m_vida > m_maxVida)
         m_vida = m_maxVida;
-    sfx.cura();
-    printf("[Player] Healed %d HP! HP: %d/%d\n", amount, m_vida, m_maxVida);
+    if (m_sfx)
+        m_sfx->cura();
+    Logger::print("[Player] Healed %d HP! HP: %d/%d\n", amount, m_vida, m_maxVida);
 }
 
 void Player::setVida(int vida, int maxVida)
@@ -438,6 +448,7 @@ void Player::setVida(int vida, int maxVida)
 void Player::reset()
 {
     m_position = glm::vec4(3.5f, 0.101f, 0.0f, 1.0f);
+    m_previousPosition = m_position;
     m_vida = m_maxVida;
     m_damageCooldownTimer = 0.0f;
     m_velocityY = 0.0f;
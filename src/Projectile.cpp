@@ -1,113 +1,281 @@
 #include "Projectile.h"
 #include "sfx.h"
 #include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROJECTILE_SIMD_SSE2
+#endif
+
+// Projéteis que saem deste cubo ao redor da origem são descartados
+static const float MAX_DISTANCE = 10.0f;
+
+// ============================================================================
+// Passo de simulação de 'count' projéteis:
+//     posição += velocidade * dt
+//     tempo de vida -= dt
+//     ativo = ativo && tempo de vida > 0 && dentro de [-MAX_DISTANCE, MAX_DISTANCE]³
+//
+// A versão SSE2 processa 4 projéteis por iteração e o restante é escalar,
+// com as mesmas operações na mesma ordem. Projéteis já inativos também são
+// integrados (evita um desvio por elemento), mas continuam inativos e são
+// removidos no fim do tick.
+// ============================================================================
+static void integrateBatch(float* x, float* y, float* z,
+                           const float* vx, const float* vy, const float* vz,
+                           float* lifetime, int32_t* active, size_t count, float dt)
+{
+    size_t i = 0;
+
+#if defined(PROJECTILE_SIMD_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 limit = _mm_set1_ps(MAX_DISTANCE);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 px = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), vdt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), vdt));
+        __m128 pz = _mm_add_ps(_mm_loadu_ps(z + i), _mm_mul_ps(_mm_loadu_ps(vz + i), vdt));
+        __m128 life = _mm_sub_ps(_mm_loadu_ps(lifetime + i), vdt);
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(y + i, py);
+        _mm_storeu_ps(z + i, pz);
+        _mm_storeu_ps(lifetime + i, life);
+
+        __m128 keep = _mm_cmpgt_ps(life, zero);
+        keep = _mm_and_ps(keep, _mm_cmple_ps(_mm_and_ps(px, absMask), limit));
+        keep = _mm_and_ps(keep, _mm_cmple_ps(_mm_and_ps(py, absMask), limit));
+        keep = _mm_and_ps(keep, _mm_cmple_ps(_mm_and_ps(pz, absMask), limit));
+
+        __m128i* a = reinterpret_cast<__m128i*>(active + i);
+        _mm_storeu_si128(a, _mm_and_si128(_mm_loadu_si128(a), _mm_castps_si128(keep)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        z[i] += vz[i] * dt;
+        lifetime[i] -= dt;
+
+        if (lifetime[i] <= 0.0f ||
+            fabsf(x[i]) > MAX_DISTANCE ||
+            fabsf(y[i]) > MAX_DISTANCE ||
+            fabsf(z[i]) > MAX_DISTANCE)
+        {
+            active[i] = 0;
+        }
+    }
+}
 
 ProjectileManager::ProjectileManager()
-    : m_projectileSpeed(6.0f)
+    : m_freeHead(-1)
+    , m_slotsUsed(0)
+    , m_trailHead(0)
+    , m_trailTimer(0.0f)
+    , m_trailsEnabled(true)
+    , m_capacity(DEFAULT_CAPACITY)
+    , m_projectileSpeed(6.0f)
     , m_enemyProjectileSpeed(3.0f)
     , m_maxLifetime(3.0f)
     , m_trailUpdateInterval(0.015f)
-    , m_maxProjectiles(30)
+    , m_sfx(nullptr)
 {
+    allocateSlots();
 }
 
 ProjectileManager::~ProjectileManager()
 {
 }
 
+void ProjectileManager::setCapacity(size_t capacity)
+{
+    if (capacity < 1)
+        capacity = 1;
+    if (capacity > MAX_CAPACITY)
+        capacity = MAX_CAPACITY;
+
+    // Os projéteis atuais são descartados: a capacidade é definida antes
+    // da partida, não durante
+    m_capacity = capacity;
+    allocateSlots();
+}
+
+// Dimensiona todos os arrays, quentes e frios, para m_capacity slots e
+// encadeia todos na lista livre (via clear())
+void ProjectileManager::allocateSlots()
+{
+    m_x.assign(m_capacity, 0.0f);
+    m_y.assign(m_capacity, 0.0f);
+    m_z.assign(m_capacity, 0.0f);
+    m_velocityX.assign(m_capacity, 0.0f);
+    m_velocityY.assign(m_capacity, 0.0f);
+    m_velocityZ.assign(m_capacity, 0.0f);
+    m_lifetime.assign(m_capacity, 0.0f);
+    m_active.assign(m_capacity, 0);
+    m_isEnemy.assign(m_capacity, 0);
+    m_previousX.assign(m_capacity, 0.0f);
+    m_previousY.assign(m_capacity, 0.0f);
+    m_previousZ.assign(m_capacity, 0.0f);
+    m_nextFree.assign(m_capacity, -1);
+
+    for (int s = 0; s < TRAIL_LENGTH; s++)
+    {
+        m_trailX[s].assign(m_capacity, 0.0f);
+        m_trailY[s].assign(m_capacity, 0.0f);
+        m_trailZ[s].assign(m_capacity, 0.0f);
+    }
+
+    m_live.clear();
+    m_live.reserve(m_capacity);
+    m_slotsUsed = 0;
+    clear();
+}
+
 void ProjectileManager::spawnProjectile(const glm::vec3& origin, const glm::vec3& direction, bool isEnemy)
 {
     float speed = isEnemy ? m_enemyProjectileSpeed : m_projectileSpeed;
-    if(!isEnemy){
-        sfx.tiro_player();
-    }
-    else{
-        sfx.fireball();
-    }
-    if (m_projectiles.size() >= m_maxProjectiles)
-    {
-        for (size_t i = 0; i < m_projectiles.size(); i++)
-        {
-            if (!m_projectiles[i].active)
-            {
-                Projectile& proj = m_projectiles[i];
-                proj.position = origin;
-                proj.velocity = direction * speed;
-                proj.lifetime = m_maxLifetime;
-                proj.active = true;
-                proj.isEnemyProjectile = isEnemy;
-                proj.trailIndex = 0;
-                proj.trailTimer = 0.0f;
-                for (int j = 0; j < Projectile::TRAIL_LENGTH; j++)
-                    proj.trailPositions[j] = origin;
-                return;
-            }
+    if (m_sfx){
+        if(!isEnemy){
+            m_sfx->tiro_player();
+        }
+        else{
+            m_sfx->fireball();
         }
+    }
+
+    // Lista livre vazia: a capacidade foi atingida
+    if (m_freeHead < 0)
         return;
+
+    int slot = m_freeHead;
+    m_freeHead = m_nextFree[slot];
+    m_nextFree[slot] = -1;
+    if ((size_t)slot >= m_slotsUsed)
+        m_slotsUsed = slot + 1;
+
+    glm::vec3 velocity = direction * speed;
+
+    m_x[slot] = origin.x;
+    m_y[slot] = origin.y;
+    m_z[slot] = origin.z;
+    m_velocityX[slot] = velocity.x;
+    m_velocityY[slot] = velocity.y;
+    m_velocityZ[slot] = velocity.z;
+    m_lifetime[slot] = m_maxLifetime;
+    m_active[slot] = -1;
+    m_isEnemy[slot] = isEnemy ? 1 : 0;
+    m_previousX[slot] = origin.x;
+    m_previousY[slot] = origin.y;
+    m_previousZ[slot] = origin.z;
+
+    for (int s = 0; s < TRAIL_LENGTH; s++)
+    {
+        m_trailX[s][slot] = origin.x;
+        m_trailY[s][slot] = origin.y;
+        m_trailZ[s][slot] = origin.z;
     }
 
-    Projectile proj;
-    proj.position = origin;
-    proj.velocity = direction * speed;
-    proj.lifetime = m_maxLifetime;
-    proj.active = true;
-    proj.isEnemyProjectile = isEnemy;
-    proj.trailIndex = 0;
-    proj.trailTimer = 0.0f;
-    for (int i = 0; i < Projectile::TRAIL_LENGTH; i++)
-        proj.trailPositions[i] = origin;
-
-    m_projectiles.push_back(proj);
+    m_live.push_back(slot);
 }
 
 void ProjectileManager::update(float deltaTime)
 {
-    for (size_t i = 0; i < m_projectiles.size(); i++)
-    {
-        if (!m_projectiles[i].active)
-            continue;
+    if (m_live.empty())
+        return;
 
-        Projectile& proj = m_projectiles[i];
+    integrateBatch(&m_x[0], &m_y[0], &m_z[0],
+                   &m_velocityX[0], &m_velocityY[0], &m_velocityZ[0],
+                   &m_lifetime[0], &m_active[0], m_slotsUsed, deltaTime);
 
-        proj.position += proj.velocity * deltaTime;
+    if (m_trailsEnabled)
+        updateTrails(deltaTime);
+}
 
-        proj.lifetime -= deltaTime;
-        if (proj.lifetime <= 0.0f)
-        {
-            proj.active = false;
-            continue;
-        }
+// A cada m_trailUpdateInterval segundos copia as posições de todos os
+// slots para o próximo plano do rastro. É o único ponto da simulação
+// que escreve nos dados frios, e a cópia é contínua (sem acesso por
+// projétil). O relógio é um só para todos os projéteis.
+void ProjectileManager::updateTrails(float deltaTime)
+{
+    m_trailTimer += deltaTime;
+    if (m_trailTimer < m_trailUpdateInterval)
+        return;
 
-        proj.trailTimer += deltaTime;
-        if (proj.trailTimer >= m_trailUpdateInterval)
-        {
-            proj.trailTimer = 0.0f;
-            proj.trailPositions[proj.trailIndex] = proj.position;
-            proj.trailIndex = (proj.trailIndex + 1) % Projectile::TRAIL_LENGTH;
-        }
+    m_trailTimer = 0.0f;
+    std::copy(m_x.begin(), m_x.begin() + m_slotsUsed, m_trailX[m_trailHead].begin());
+    std::copy(m_y.begin(), m_y.begin() + m_slotsUsed, m_trailY[m_trailHead].begin());
+    std::copy(m_z.begin(), m_z.begin() + m_slotsUsed, m_trailZ[m_trailHead].begin());
+    m_trailHead = (m_trailHead + 1) % TRAIL_LENGTH;
+}
 
-        float maxDist = 10.0f;
-        if (fabs(proj.position.x) > maxDist ||
-            fabs(proj.position.y) > maxDist ||
-            fabs(proj.position.z) > maxDist)
-        {
-            proj.active = false;
-        }
-    }
+glm::vec3 ProjectileManager::getTrailPosition(size_t i, int age) const
+{
+    int slot = m_live[i];
+    int s = (m_trailHead - 1 - age + TRAIL_LENGTH) % TRAIL_LENGTH;
+    return glm::vec3(m_trailX[s][slot], m_trailY[s][slot], m_trailZ[s][slot]);
 }
 
+void ProjectileManager::storePreviousState()
+{
+    std::copy(m_x.begin(), m_x.begin() + m_slotsUsed, m_previousX.begin());
+    std::copy(m_y.begin(), m_y.begin() + m_slotsUsed, m_previousY.begin());
+    std::copy(m_z.begin(), m_z.begin() + m_slotsUsed, m_previousZ.begin());
+}
+
+glm::vec3 ProjectileManager::getInterpolatedPosition(size_t i, float alpha) const
+{
+    int slot = m_live[i];
+    glm::vec3 previous(m_previousX[slot], m_previousY[slot], m_previousZ[slot]);
+    return previous + (slotPosition(slot) - previous) * alpha;
+}
+
+// Remove os projéteis marcados como inativos da lista densa, trocando cada
+// um pelo último, e devolve o slot à lista livre
 void ProjectileManager::removeInactive()
 {
-    for (size_t i = 0; i < m_projectiles.size(); )
+    for (size_t i = 0; i < m_live.size(); )
     {
-        if (!m_projectiles[i].active)
-            m_projectiles.erase(m_projectiles.begin() + i);
-        else
+        int slot = m_live[i];
+        if (m_active[slot])
+        {
             i++;
+            continue;
+        }
+
+        // Parado, o slot livre continua sendo integrado sem se afastar
+        m_velocityX[slot] = 0.0f;
+        m_velocityY[slot] = 0.0f;
+        m_velocityZ[slot] = 0.0f;
+
+        m_nextFree[slot] = m_freeHead;
+        m_freeHead = slot;
+
+        m_live[i] = m_live.back();
+        m_live.pop_back();
     }
 }
 
+// Esvazia o pool e encadeia todos os slots na lista livre, do 0 em diante
 void ProjectileManager::clear()
 {
-    m_projectiles.clear();
+    for (size_t slot = 0; slot < m_slotsUsed; slot++)
+    {
+        m_active[slot] = 0;
+        m_velocityX[slot] = 0.0f;
+        m_velocityY[slot] = 0.0f;
+        m_velocityZ[slot] = 0.0f;
+    }
+
+    for (size_t slot = 0; slot < m_capacity; slot++)
+        m_nextFree[slot] = (slot + 1 < m_capacity) ? (int)(slot + 1) : -1;
+    m_freeHead = m_capacity > 0 ? 0 : -1;
+
+    m_live.clear();
+    m_slotsUsed = 0;
+    m_trailHead = 0;
+    m_trailTimer = 0.0f;
 }
@@ -0,0 +1,194 @@
+// ============================================================================
+// PROJECTILEBENCH.CPP - Benchmark do Tick de Projéteis
+// ============================================================================
+//
+// Cada rodada cria m_projectiles projéteis perto da origem, com direções
+// sorteadas, e simula um segundo de jogo (m_tickRate ticks). A 6 unidades/s
+// nenhum deles sai da arena nem expira nesse tempo, então o número de
+// projéteis vivos fica constante durante a medição.
+//
+// São medidas três versões do mesmo tick:
+//   - referência: o layout anterior (array de structs, com o rastro de 6
+//     posições dentro de cada projétil), reproduzido abaixo
+//   - ProjectileManager::update com rastro (jogo com janela)
+//   - ProjectileManager::update sem rastro (headless)
+//
+// As posições finais das versões são comparadas: devem ser idênticas.
+//
+// ============================================================================
+
+#include "ProjectileBench.h"
+#include "Projectile.h"
+#include "Random.h"
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <chrono>
+
+// Layout anterior ao ProjectileManager em arrays, só para comparação
+struct LegacyProjectile
+{
+    glm::vec3 position;
+    glm::vec3 previousPosition;
+    glm::vec3 velocity;
+    float lifetime;
+    bool active;
+    bool isEnemyProjectile;
+
+    static const int TRAIL_LENGTH = 6;
+    glm::vec3 trailPositions[TRAIL_LENGTH];
+    int trailIndex;
+    float trailTimer;
+};
+
+static void updateLegacy(std::vector<LegacyProjectile>& projectiles, float deltaTime, float trailUpdateInterval)
+{
+    for (size_t i = 0; i < projectiles.size(); i++)
+    {
+        LegacyProjectile& proj = projectiles[i];
+        if (!proj.active)
+            continue;
+
+        proj.position += proj.velocity * deltaTime;
+
+        proj.lifetime -= deltaTime;
+        if (proj.lifetime <= 0.0f)
+        {
+            proj.active = false;
+            continue;
+        }
+
+        proj.trailTimer += deltaTime;
+        if (proj.trailTimer >= trailUpdateInterval)
+        {
+            proj.trailTimer = 0.0f;
+            proj.trailPositions[proj.trailIndex] = proj.position;
+            proj.trailIndex = (proj.trailIndex + 1) % LegacyProjectile::TRAIL_LENGTH;
+        }
+
+        float maxDist = 10.0f;
+        if (fabs(proj.position.x) > maxDist ||
+            fabs(proj.position.y) > maxDist ||
+            fabs(proj.position.z) > maxDist)
+        {
+            proj.active = false;
+        }
+    }
+}
+
+// Origem e direção (unitária) de cada projétil, iguais para as três versões
+static void makeShots(Random& random, int count, std::vector<glm::vec3>& origins, std::vector<glm::vec3>& directions)
+{
+    origins.resize(count);
+    directions.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        origins[i] = glm::vec3(random.nextFloat() * 2.0f - 1.0f,
+                               random.nextFloat() * 0.5f,
+                               random.nextFloat() * 2.0f - 1.0f);
+
+        glm::vec3 d(random.nextFloat() * 2.0f - 1.0f,
+                    random.nextFloat() * 0.2f - 0.1f,
+                    random.nextFloat() * 2.0f - 1.0f);
+        float length = sqrtf(d.x * d.x + d.y * d.y + d.z * d.z);
+        directions[i] = length > 0.0f ? d / length : glm::vec3(1.0f, 0.0f, 0.0f);
+    }
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ProjectileBench::ProjectileBench(int projectiles, int rounds, float tickRate, uint64_t seed)
+    : m_projectiles(projectiles < 1 ? 1 : projectiles)
+    , m_rounds(rounds < 1 ? 1 : rounds)
+    , m_tickRate(tickRate)
+    , m_seed(seed)
+{
+}
+
+void ProjectileBench::run()
+{
+    const float deltaTime = 1.0f / m_tickRate;
+    const int ticksPerRound = (int)m_tickRate;
+    const float trailUpdateInterval = 0.015f;
+
+    printf("[Bench] %d projectiles, %d rounds x %d ticks (%.0f Hz), seed %llu\n",
+           m_projectiles, m_rounds, ticksPerRound, m_tickRate, (unsigned long long)m_seed);
+
+    Random random(m_seed);
+    std::vector<glm::vec3> origins, directions;
+    makeShots(random, m_projectiles, origins, directions);
+
+    std::vector<LegacyProjectile> legacy(m_projectiles);
+    ProjectileManager withTrails;
+    ProjectileManager withoutTrails;
+    withTrails.setCapacity(m_projectiles);
+    withoutTrails.setCapacity(m_projectiles);
+    withoutTrails.setTrailsEnabled(false);
+
+    double legacyMs = 0.0, trailsMs = 0.0, noTrailsMs = 0.0;
+    bool identical = true;
+
+    for (int round = 0; round < m_rounds; round++)
+    {
+        // Estado inicial da rodada (fora da medição)
+        withTrails.clear();
+        withoutTrails.clear();
+        for (int i = 0; i < m_projectiles; i++)
+        {
+            LegacyProjectile& proj = legacy[i];
+            proj.position = origins[i];
+            proj.previousPosition = origins[i];
+            proj.velocity = directions[i] * 6.0f;
+            proj.lifetime = 3.0f;
+            proj.active = true;
+            proj.isEnemyProjectile = false;
+            proj.trailIndex = 0;
+            proj.trailTimer = 0.0f;
+            for (int t = 0; t < LegacyProjectile::TRAIL_LENGTH; t++)
+                proj.trailPositions[t] = origins[i];
+
+            withTrails.spawnProjectile(origins[i], directions[i]);
+            withoutTrails.spawnProjectile(origins[i], directions[i]);
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticksPerRound; tick++)
+            updateLegacy(legacy, deltaTime, trailUpdateInterval);
+        legacyMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticksPerRound; tick++)
+            withTrails.update(deltaTime);
+        trailsMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int tick = 0; tick < ticksPerRound; tick++)
+            withoutTrails.update(deltaTime);
+        noTrailsMs += elapsedMs(start);
+
+        for (int i = 0; i < m_projectiles; i++)
+        {
+            if (withTrails.getPosition(i) != legacy[i].position ||
+                withoutTrails.getPosition(i) != legacy[i].position ||
+                withTrails.isActive(i) != legacy[i].active)
+            {
+                identical = false;
+            }
+        }
+    }
+
+    double ticks = (double)m_rounds * ticksPerRound;
+    double legacyTick = legacyMs / ticks;
+    double trailsTick = trailsMs / ticks;
+    double noTrailsTick = noTrailsMs / ticks;
+
+    printf("[Bench] array of structs (previous):  %8.4f ms/tick\n", legacyTick);
+    printf("[Bench] SoA, with trails:             %8.4f ms/tick (%.2fx)\n", trailsTick,
+           trailsTick > 0.0 ? legacyTick / trailsTick : 0.0);
+    printf("[Bench] SoA, without trails:          %8.4f ms/tick (%.2fx)\n", noTrailsTick,
+           noTrailsTick > 0.0 ? legacyTick / noTrailsTick : 0.0);
+    printf("[Bench] Final positions %s\n", identical ? "identical" : "DIFFER");
+}
@@ -0,0 +1,211 @@
+// ============================================================================
+// RENDERQUEUE.CPP - Fila de Renderização e Cache de Estado GL
+// ============================================================================
+//
+// A fila só guarda e ordena pacotes; quem os emite é o Renderer
+// (Renderer::flushRenderQueue), que conhece os uniforms e os buffers de
+// instâncias. Aqui ficam a montagem da chave e o cache de estado.
+//
+// ============================================================================
+
+#include "RenderQueue.h"
+#include <algorithm>
+
+// ============================================================================
+// CACHE DE ESTADO GL
+// ============================================================================
+
+GLStateCache::GLStateCache()
+    : m_stats(nullptr)
+{
+    invalidate();
+}
+
+void GLStateCache::invalidate()
+{
+    m_program = UNKNOWN;
+    m_vao = UNKNOWN;
+    m_arrayBuffer = UNKNOWN;
+    m_cullFace = UNKNOWN;
+    m_blend = UNKNOWN;
+    m_blendSource = UNKNOWN;
+    m_blendDestination = UNKNOWN;
+    m_depthMask = UNKNOWN;
+
+    for (int slot = 0; slot < UNIFORM_SLOT_COUNT; slot++)
+        m_uniformValid[slot] = false;
+}
+
+void GLStateCache::issue()
+{
+    if (m_stats)
+        m_stats->glCalls++;
+}
+
+void GLStateCache::skip()
+{
+    if (m_stats)
+        m_stats->redundantCalls++;
+}
+
+void GLStateCache::useProgram(GLuint program)
+{
+    if (m_program == (GLint)program)
+        return skip();
+
+    // Os valores de uniform pertencem ao programa
+    for (int slot = 0; slot < UNIFORM_SLOT_COUNT; slot++)
+        m_uniformValid[slot] = false;
+
+    m_program = (GLint)program;
+    issue();
+    glUseProgram(program);
+}
+
+void GLStateCache::bindVertexArray(GLuint vao)
+{
+    if (m_vao == (GLint)vao)
+        return skip();
+
+    m_vao = (GLint)vao;
+    issue();
+    glBindVertexArray(vao);
+}
+
+void GLStateCache::bindArrayBuffer(GLuint buffer)
+{
+    if (m_arrayBuffer == (GLint)buffer)
+        return skip();
+
+    m_arrayBuffer = (GLint)buffer;
+    issue();
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void GLStateCache::setCullFace(bool enabled)
+{
+    if (m_cullFace == (GLint)enabled)
+        return skip();
+
+    m_cullFace = (GLint)enabled;
+    issue();
+    if (enabled)
+        glEnable(GL_CULL_FACE);
+    else
+        glDisable(GL_CULL_FACE);
+}
+
+void GLStateCache::setBlend(bool enabled)
+{
+    if (m_blend == (GLint)enabled)
+        return skip();
+
+    m_blend = (GLint)enabled;
+    issue();
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+void GLStateCache::setBlendFunc(GLenum source, GLenum destination)
+{
+    if (m_blendSource == (GLint)source && m_blendDestination == (GLint)destination)
+        return skip();
+
+    m_blendSource = (GLint)source;
+    m_blendDestination = (GLint)destination;
+    issue();
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::setDepthMask(bool enabled)
+{
+    if (m_depthMask == (GLint)enabled)
+        return skip();
+
+    m_depthMask = (GLint)enabled;
+    issue();
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::setUniform1i(UniformSlot slot, GLint location, int value)
+{
+    if (m_uniformValid[slot] && m_uniformValue[slot][0] == (float)value)
+        return skip();
+
+    m_uniformValid[slot] = true;
+    m_uniformValue[slot][0] = (float)value;
+    issue();
+    glUniform1i(location, value);
+}
+
+void GLStateCache::setUniform1f(UniformSlot slot, GLint location, float value)
+{
+    if (m_uniformValid[slot] && m_uniformValue[slot][0] == value)
+        return skip();
+
+    m_uniformValid[slot] = true;
+    m_uniformValue[slot][0] = value;
+    issue();
+    glUniform1f(location, value);
+}
+
+void GLStateCache::setUniform4f(UniformSlot slot, GLint location, float x, float y, float z, float w)
+{
+    float* cached = m_uniformValue[slot];
+    if (m_uniformValid[slot] && cached[0] == x && cached[1] == y && cached[2] == z && cached[3] == w)
+        return skip();
+
+    m_uniformValid[slot] = true;
+    cached[0] = x;
+    cached[1] = y;
+    cached[2] = z;
+    cached[3] = w;
+    issue();
+    glUniform4f(location, x, y, z, w);
+}
+
+// ============================================================================
+// FILA
+// ============================================================================
+
+RenderQueue::RenderQueue()
+{
+}
+
+uint64_t RenderQueue::makeKey(RenderPass pass, GLuint program, GLuint vao, int lod, float depth)
+{
+    // Profundidade em 24 bits, até 64 unidades (a arena tem 8.4 x 2.4)
+    uint64_t depthBits = 0;
+    if (pass != PASS_ADDITIVE && depth > 0.0f)
+    {
+        float scaled = depth * (float)(1 << 24) / 64.0f;
+        depthBits = scaled >= (float)((1 << 24) - 1) ? (uint64_t)((1 << 24) - 1) : (uint64_t)scaled;
+    }
+
+    return ((uint64_t)pass                    << 61)
+         | ((uint64_t)(program & 0x7F)        << 54)
+         | ((uint64_t)(vao & 0xFFF)           << 42)
+         | ((uint64_t)(lod & 0x3)             << 40)
+         | (depthBits                         << 16);
+}
+
+void RenderQueue::submit(DrawPacket packet)
+{
+    uint32_t index = (uint32_t)m_packets.size();
+    packet.key |= (uint64_t)(index & 0xFFFF);
+    m_packets.push_back(packet);
+    m_order.push_back(std::make_pair(packet.key, index));
+}
+
+void RenderQueue::sort()
+{
+    std::sort(m_order.begin(), m_order.end());
+}
+
+void RenderQueue::clear()
+{
+    m_packets.clear();
+    m_order.clear();
+}
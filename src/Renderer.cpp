@@ -30,20 +30,119 @@
 #include "Enemy.h"
 #include "Game.h"
 #include "matrices.h"
+#include "collisions.h"
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "MeshCache.h"
+#include "AssetLoader.h"
+#include "TextureBaker.h"
 #include <fstream>
 #include <sstream>
 #include <cstdio>
 #include <cstdlib>
+#include <cstddef>
+#include <cstring>
 #include <cassert>
 #include <cmath>
 #include <stack>
 #include <set>
 #include <string>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
 #include <glm/gtc/type_ptr.hpp>
 #include <stb_image.h>
 void TextRendering_Init();
 void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale);
+void TextRendering_Flush();
+
+// ============================================================================
+// RECURSOS EM CARREGAMENTO
+// ============================================================================
+// Estado de cada tarefa do AssetLoader em init(): a parte do worker
+// preenche a estrutura, e o upload na thread do GL a consome.
+// ============================================================================
+// Textura preparada por um worker, à espera do upload numa camada do array
+// de texturas dos materiais. Normalmente vem do .ktx pré-processado (ver
+// TextureBaker.h); se ele não puder ser gravado, os níveis ficam só na
+// memória ('bakedLevels')
+struct TextureImage
+{
+    std::string             filename;
+    int                     size;     // lado da camada
+    MappedFile              baked;
+    std::vector< std::vector<unsigned char> > bakedLevels;
+    std::vector<BakedLevel> levels;
+    // Níveis descomprimidos na CPU, quando o contexto não tem S3TC
+    std::vector< std::vector<unsigned char> > decodedLevels;
+    bool                    uploaded; // camada preenchida na GPU
+};
+
+// Roda num worker: lê (ou gera) o .ktx, sem chamadas GL. A origem
+// embaixo-esquerda, que o OpenGL espera, é ligada em init() com
+// stbi_set_flip_vertically_on_load e vale também para o baker.
+// Uma imagem que não abre ou não decodifica lança exceção; init() só sai
+// depois que o AssetLoader esperou os outros workers
+static void decodeTextureImage(TextureImage& image, bool compressed)
+{
+    const char* filename = image.filename.c_str();
+
+    MappedFile source;
+    if (!source.open(filename))
+    {
+        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename);
+        throw std::runtime_error("Erro ao carregar textura.");
+    }
+    uint64_t hash = HashBytes(source.data(), source.size());
+    source.close();
+
+    std::string bakedPath = image.filename + ".ktx";
+    bool baked = image.baked.open(bakedPath.c_str()) && ReadBakedTexture(image.baked, hash, image.size, image.levels);
+    if (!baked)
+    {
+        image.baked.close();
+        if (!BakeTextureLevels(filename, image.size, image.bakedLevels))
+            throw std::runtime_error("Erro ao carregar textura.");
+        if (WriteBakedTexture(bakedPath.c_str(), hash, image.size, image.bakedLevels))
+            printf("- Textura pré-processada em \"%s\"\n", bakedPath.c_str());
+
+        image.levels.clear();
+        for (size_t level = 0, size = image.size; level < image.bakedLevels.size(); ++level, size = std::max<size_t>(1, size / 2))
+        {
+            BakedLevel baked_level;
+            baked_level.width = (int)size;
+            baked_level.height = (int)size;
+            baked_level.data = &image.bakedLevels[level][0];
+            baked_level.size = image.bakedLevels[level].size();
+            image.levels.push_back(baked_level);
+        }
+    }
+
+    if (!compressed)
+    {
+        image.decodedLevels.resize(image.levels.size());
+        for (size_t level = 0; level < image.levels.size(); ++level)
+        {
+            const BakedLevel& baked_level = image.levels[level];
+            image.decodedLevels[level].resize((size_t)baked_level.width * baked_level.height * 3);
+            DecodeBC1(baked_level.data, baked_level.width, baked_level.height, &image.decodedLevels[level][0]);
+        }
+    }
+
+    printf("Carregando textura \"%s\"... OK (%dx%d, %zu níveis BC1).\n",
+           bakedPath.c_str(), image.size, image.size, image.levels.size());
+}
+
+// Modelo preparado por um worker, à espera do upload
+struct MeshLoad
+{
+    std::string                filename;
+    MappedFile                 cache;
+    MeshView                   view;
+    MeshData                   mesh;
+    std::vector<unsigned char> packed;
+};
 
 // ============================================================================
 // PILHA DE MATRIZES MODELO
@@ -101,122 +200,216 @@ static float DiferencaAngulo(glm::vec4 v, glm::vec4 u)
 
 Renderer::Renderer()
     : m_vertexArrayObjectID(0)
-    , m_gpuProgramID(0)
-    , m_modelUniform(0)
-    , m_viewUniform(0)
-    , m_projectionUniform(0)
-    , m_renderAsBlackUniform(0)
+    , m_frameStats()
+    , m_instanceVBO(0)
+    , m_instanceCapacity(0)
+    , m_staticBatchVAO(0)
+    , m_staticBatchVBO(0)
+    , m_staticOpaqueCount(0)
+    , m_staticTorchRanges()
+    , m_materialTextures(0)
+    , m_textureCompression(false)
+    , m_textureBytes(0)
+    , m_uncompressedTextureBytes(0)
+    , m_meshMonster(INVALID_MESH)
+    , m_meshArcher(INVALID_MESH)
+    , m_meshWand(INVALID_MESH)
+    , m_meshDragon(INVALID_MESH)
+    , m_meshHealth(INVALID_MESH)
+    , m_meshProjectile(INVALID_MESH)
     , m_currentView(Matrix_Identity())
     , m_currentProjection(Matrix_Identity())
+    , m_visibleObjects(0)
+    , m_culledObjects(0)
+    , m_cameraUniforms()
+    , m_torchUniforms()
+    , m_frameUBO(0)
+    , m_torchBlockOffset(0)
     , m_screenRatio(1.0f)
+    , m_interpolationAlpha(1.0f)
     , m_window(nullptr)
 {
+    for (int material = 0; material < MAX_MATERIALS; material++)
+    {
+        m_materialPermutation[material] = -1;
+        m_materialLayer[material] = 0.0f;
+    }
+    updateFrustum();
 }
 
 Renderer::~Renderer()
 {
-    if (m_gpuProgramID != 0)
+    for (size_t i = 0; i < m_permutations.size(); i++)
+    {
+        if (m_permutations[i].program != 0)
+            glDeleteProgram(m_permutations[i].program);
+    }
+}
+
+// ============================================================================
+// ARRAY DE TEXTURAS DOS MATERIAIS
+// ============================================================================
+// Todas as texturas de material ficam num único GL_TEXTURE_2D_ARRAY, na
+// unidade MATERIAL_TEXTURE_UNIT: a textura i de TEXTURE_FILES é a camada i,
+// que MATERIAL_PERMUTATIONS referencia. O shader recebe a camada por
+// vértice (lote estático), por instância ou pelo uniform material_layer,
+// e não por sampler: materiais diferentes com o mesmo programa saem na
+// mesma chamada, e uma textura nova é só mais uma linha aqui.
+//
+// As camadas têm todas TEXTURE_LAYER_SIZE x TEXTURE_LAYER_SIZE; o baker
+// redimensiona as imagens (ver TextureBaker.h).
+// ============================================================================
+static const int TEXTURE_LAYER_SIZE = 1024;
+static const GLuint MATERIAL_TEXTURE_UNIT = 0;
+
+static const char* const TEXTURE_FILES[] = {
+    "texturas/monstro.jpg", //Monstro
+    "texturas/parede.jpg",
+    "texturas/Chao.png",
+    "texturas/telhado.jpg",
+    "texturas/Arqueira.png",
+    "texturas/Varinha.png",
+    "texturas/vida.png",
+    "texturas/magica.jpg",
+    "texturas/lava.png",
+    "texturas/lava.jpg", //Dragon
+    "texturas/fogo.jpg",
+};
+static const size_t NUM_TEXTURE_FILES = sizeof(TEXTURE_FILES) / sizeof(TEXTURE_FILES[0]);
+
+// Gera todos os .ktx de uma vez, sem janela nem contexto GL (--bake-textures)
+bool Renderer::bakeTextures()
+{
+    stbi_set_flip_vertically_on_load(true);
+
+    bool ok = true;
+    std::mutex okMutex;
+    AssetLoader loader;
+    for (size_t i = 0; i < NUM_TEXTURE_FILES; i++)
+    {
+        std::string filename = TEXTURE_FILES[i];
+        loader.add(filename, [filename, &ok, &okMutex]()
+        {
+            MappedFile source;
+            bool baked = source.open(filename.c_str());
+            if (baked)
+            {
+                uint64_t hash = HashBytes(source.data(), source.size());
+                source.close();
+                baked = BakeTexture(filename.c_str(), (filename + ".ktx").c_str(), hash, TEXTURE_LAYER_SIZE);
+            }
+            else
+                fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename.c_str());
+
+            if (baked)
+                printf("- Textura pré-processada em \"%s.ktx\"\n", filename.c_str());
+            std::lock_guard<std::mutex> lock(okMutex);
+            ok = ok && baked;
+        }, [](){});
+    }
+    loader.run((int)std::thread::hardware_concurrency());
+    return ok;
+}
+
+// Extensões pela lista indexada (glGetString(GL_EXTENSIONS) não existe no
+// perfil core)
+static bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
     {
-        glDeleteProgram(m_gpuProgramID);
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (extension != NULL && strcmp(extension, name) == 0)
+            return true;
     }
+    return false;
 }
 
 bool Renderer::init(GLFWwindow* window)
 {
     m_window = window;
 
+    // Um programa por conjunto de #defines; a camada de textura de cada
+    // material segue a ordem de TEXTURE_FILES
     loadShadersFromFiles();
 
-    m_modelUniform = glGetUniformLocation(m_gpuProgramID, "model");
-    m_viewUniform = glGetUniformLocation(m_gpuProgramID, "view");
-    m_projectionUniform = glGetUniformLocation(m_gpuProgramID, "projection");
-    m_renderAsBlackUniform = glGetUniformLocation(m_gpuProgramID, "render_as_black");
-    m_objectIdUniform = glGetUniformLocation(m_gpuProgramID, "object_id");
-    m_bbox_min_uniform   = glGetUniformLocation(m_gpuProgramID, "bbox_min");
-    m_bbox_max_uniform   = glGetUniformLocation(m_gpuProgramID, "bbox_max");
-
-    m_torchPositionsUniform = glGetUniformLocation(m_gpuProgramID, "torch_positions");
-    m_torchColorsUniform = glGetUniformLocation(m_gpuProgramID, "torch_colors");
-    m_torchIntensitiesUniform = glGetUniformLocation(m_gpuProgramID, "torch_intensities");
-    m_numTorchesUniform = glGetUniformLocation(m_gpuProgramID, "num_torches");
-
-    glUseProgram(m_gpuProgramID);
-    //Inimigo
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage0"), 0);
-    //Parede
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage1"), 1);
-    //Ch�o
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage2"), 2);
-    //Telhado
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage3"), 3);
-    //Player
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage4"), 4);
-    //Varinha
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage5"), 5);
-    //Vida
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage6"), 6);
-    //Projétil player
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage7"), 7);
-    //Projétil inimigo
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage8"), 8);
-    //Dragon
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage9"), 9);
-    //Fogo
-    glUniform1i(glGetUniformLocation(m_gpuProgramID, "TextureImage10"), 10);
-    glUseProgram(0);
+    initFrameUniforms();
 
+    // Antes da geometria: todo VAO de modelo liga os atributos de instância
+    initInstancing();
     m_vertexArrayObjectID = buildGeometry();
 
-    try {
-        LoadTextureImage("texturas/monstro.jpg"); //Monstro
-        LoadTextureImage("texturas/parede.jpg");
-        LoadTextureImage("texturas/Chao.png");
-        LoadTextureImage("texturas/telhado.jpg");
-        LoadTextureImage("texturas/Arqueira.png");
-        LoadTextureImage("texturas/Varinha.png");
-        LoadTextureImage("texturas/vida.png");
-        LoadTextureImage("texturas/magica.jpg");
-        LoadTextureImage("texturas/lava.png");
-        LoadTextureImage("texturas/lava.jpg"); //Dragon
-        LoadTextureImage("texturas/fogo.jpg");
-
-        ObjModel monstermodel("modelos/monstro.obj");
-        computeNormals(&monstermodel);
-        buildTrianglesFromObj(&monstermodel);
-
-        ObjModel cubemodel("modelos/cube.obj");
-        computeNormals(&cubemodel);
-        buildTrianglesFromObj(&cubemodel);
-
-        ObjModel planemodel("modelos/plane.obj");
-        computeNormals(&planemodel);
-        buildTrianglesFromObj(&planemodel);
-
-        ObjModel arqueiramodel("modelos/arqueira.obj");
-        computeNormals(&arqueiramodel);
-        buildTrianglesFromObj(&arqueiramodel);
-
-        ObjModel dragonmodel("modelos/dragon.obj");
-        computeNormals(&dragonmodel);
-        buildTrianglesFromObj(&dragonmodel);
-
-        ObjModel varinhamodel("modelos/Varinha.obj");
-        computeNormals(&varinhamodel);
-        buildTrianglesFromObj(&varinhamodel);
-
-        ObjModel vidamodel("modelos/vida.obj");
-        computeNormals(&vidamodel);
-        buildTrianglesFromObj(&vidamodel);
-
-        ObjModel fireballmodel("modelos/fireball.obj");
-        computeNormals(&fireballmodel);
-        buildTrianglesFromObj(&fireballmodel);
+    // Imagens e modelos são preparados em paralelo (ver AssetLoader.h)
+    static const char* const MODEL_FILES[] = {
+        "modelos/monstro.obj",
+        "modelos/cube.obj",
+        "modelos/plane.obj",
+        "modelos/arqueira.obj",
+        "modelos/dragon.obj",
+        "modelos/Varinha.obj",
+        "modelos/vida.obj",
+        "modelos/fireball.obj",
+    };
+    const size_t numTextures = NUM_TEXTURE_FILES;
+    const size_t numModels = sizeof(MODEL_FILES) / sizeof(MODEL_FILES[0]);
 
+    // Os vetores não crescem depois daqui: as tarefas guardam referências
+    std::vector<TextureImage> textures(numTextures);
+    std::vector<MeshLoad> models(numModels);
+
+    // O stb_image guarda esta opção numa variável global: fica definida
+    // antes de qualquer worker começar
+    stbi_set_flip_vertically_on_load(true);
+
+    // BC1 (S3TC) não é core no OpenGL 3.3: sem as extensões, os níveis do
+    // .ktx são descomprimidos na CPU
+    m_textureCompression = hasExtension("GL_EXT_texture_compression_s3tc") && hasExtension("GL_EXT_texture_sRGB");
+    const bool compressed = m_textureCompression;
+    createMaterialTextures((GLsizei)numTextures);
+
+    AssetLoader loader;
+    for (size_t i = 0; i < numTextures; i++)
+    {
+        TextureImage& image = textures[i];
+        image.filename = TEXTURE_FILES[i];
+        image.size = TEXTURE_LAYER_SIZE;
+        image.uploaded = false;
+        loader.add(image.filename,
+                   [&image, compressed]() { decodeTextureImage(image, compressed); },
+                   [this, &image, i]() { uploadTextureImage(image, (GLint)i); });
+    }
+    for (size_t i = 0; i < numModels; i++)
+    {
+        MeshLoad& load = models[i];
+        load.filename = MODEL_FILES[i];
+        loader.add(load.filename,
+                   [this, &load]() { prepareObjModel(load); },
+                   [this, &load]() { uploadMesh(load.view); });
+    }
+
+    try {
+        loader.run((int)std::thread::hardware_concurrency());
         printf("All OBJ models loaded successfully!\n");
     } catch (const std::exception& e) {
-        fprintf(stderr, "ERROR loading OBJ models: %s\n", e.what());
+        fprintf(stderr, "ERROR loading assets: %s\n", e.what());
     }
 
+    // Um modelo que falhou só deixa de ser desenhado; sem uma das texturas
+    // o jogo não continua. run() já esperou todos os workers
+    for (size_t i = 0; i < numTextures; i++)
+    {
+        if (!textures[i].uploaded)
+            return false;
+    }
+
+    printf("[Textures] %zu layers of %dx%d: %.1f MB on the GPU (%s), %.1f MB as GL_SRGB8 with mipmaps\n",
+           numTextures, TEXTURE_LAYER_SIZE, TEXTURE_LAYER_SIZE,
+           m_textureBytes / (1024.0 * 1024.0), m_textureCompression ? "BC1" : "uncompressed",
+           m_uncompressedTextureBytes / (1024.0 * 1024.0));
+
+    resolveMeshHandles();
+
     glEnable(GL_DEPTH_TEST);
 
     TextRendering_Init();
@@ -227,13 +420,16 @@ bool Renderer::init(GLFWwindow* window)
 void Renderer::setProjection(const glm::mat4& projection)
 {
     m_currentProjection = projection;
-    glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, glm::value_ptr(projection));
+    m_cameraUniforms.projection = projection;
+    updateFrustum();
 }
 
 void Renderer::setView(const glm::mat4& view)
 {
     m_currentView = view;
-    glUniformMatrix4fv(m_viewUniform, 1, GL_FALSE, glm::value_ptr(view));
+    m_cameraUniforms.view = view;
+    m_cameraUniforms.cameraPosition = glm::inverse(view) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    updateFrustum();
 }
 
 void Renderer::renderScene(const Player& player, const EnemyManager& enemyManager, const Enemy& dragonBoss, bool dragonBossAlive, float deltaTime, const ProjectileManager* projectileManager)
@@ -241,17 +437,11 @@ void Renderer::renderScene(const Player& player, const EnemyManager& enemyManage
     glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(m_gpuProgramID);
-
-    glUniformMatrix4fv(m_viewUniform, 1, GL_FALSE, glm::value_ptr(m_currentView));
-    glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, glm::value_ptr(m_currentProjection));
-
-    glBindVertexArray(m_vertexArrayObjectID);
-
     renderArena();
+    glm::vec4 playerPosition = player.getInterpolatedPosition(m_interpolationAlpha);
     renderPlayer(player);
-    renderEnemies(enemyManager, player.getPosition());
-    renderDragonBoss(dragonBoss, dragonBossAlive, player.getPosition());
+    renderEnemies(enemyManager, playerPosition);
+    renderDragonBoss(dragonBoss, dragonBossAlive, playerPosition);
 
     if (projectileManager != nullptr)
     {
@@ -264,13 +454,6 @@ void Renderer::renderScenePaused(const Player& player, const EnemyManager& enemy
     glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glUseProgram(m_gpuProgramID);
-
-    glUniformMatrix4fv(m_viewUniform, 1, GL_FALSE, glm::value_ptr(m_currentView));
-    glUniformMatrix4fv(m_projectionUniform, 1, GL_FALSE, glm::value_ptr(m_currentProjection));
-
-    glBindVertexArray(m_vertexArrayObjectID);
-
     renderArena();
     renderPlayerLookingAt(player, cameraPosition);
     renderEnemiesLookingAt(enemyManager, cameraPosition);
@@ -282,30 +465,296 @@ void Renderer::renderScenePaused(const Player& player, const EnemyManager& enemy
     }
 }
 
-void Renderer::renderArena()
+// ============================================================================
+// GEOMETRIA BASE
+// ============================================================================
+// Cubo (vértices 0..7, índices 0..35) e os quadriláteros da arena: chão,
+// teto e as quatro paredes. buildGeometry() envia estes arrays para a GPU
+// (desenhados com as matrizes de cada objeto) e buildStaticBatch() os usa
+// para montar o lote estático, já em coordenadas do mundo.
+// ============================================================================
+static const GLfloat g_BaseModelCoefficients[] = {
+    -0.1f,  0.1f,  0.1f, 1.0f,
+    -0.1f, -0.1f,  0.1f, 1.0f,
+     0.1f, -0.1f,  0.1f, 1.0f,
+     0.1f,  0.1f,  0.1f, 1.0f,
+    -0.1f,  0.1f, -0.1f, 1.0f,
+    -0.1f, -0.1f, -0.1f, 1.0f,
+     0.1f, -0.1f, -0.1f, 1.0f,
+     0.1f,  0.1f, -0.1f, 1.0f,
+     5.0f, 0.0f,  2.0f, 1.0f,
+    -5.0f, 0.0f,  2.0f, 1.0f,
+     5.0f, 0.0f, -2.0f, 1.0f,
+    -5.0f, 0.0f, -2.0f, 1.0f,
+     0.0f,  0.0f,  0.0f, 1.0f,
+     0.0f,  0.0f,  0.4f, 1.0f,
+     5.0f, 3.0f,  2.0f, 1.0f,
+    -5.0f, 3.0f,  2.0f, 1.0f,
+     5.0f, 3.0f, -2.0f, 1.0f,
+    -5.0f, 3.0f, -2.0f, 1.0f,
+     4.5f, 0.0f,  1.5f, 1.0f,
+    -4.5f, 0.0f,  1.5f, 1.0f,
+    -4.5f, 3.0f,  1.5f, 1.0f,
+     4.5f, 3.0f,  1.5f, 1.0f,
+    -4.5f, 0.0f, -1.5f, 1.0f,
+     4.5f, 0.0f, -1.5f, 1.0f,
+     4.5f, 3.0f, -1.5f, 1.0f,
+    -4.5f, 3.0f, -1.5f, 1.0f,
+     4.5f, 0.0f, -1.5f, 1.0f,
+     4.5f, 0.0f,  1.5f, 1.0f,
+     4.5f, 3.0f,  1.5f, 1.0f,
+     4.5f, 3.0f, -1.5f, 1.0f,
+    -4.5f, 0.0f,  1.5f, 1.0f,
+    -4.5f, 0.0f, -1.5f, 1.0f,
+    -4.5f, 3.0f, -1.5f, 1.0f,
+    -4.5f, 3.0f,  1.5f, 1.0f,
+};
+
+static const GLfloat g_BaseNormalCoefficients[] = {
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, -1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    -1.0f, 0.0f, 0.0f, 0.0f,
+    1.0f, 0.0f, 0.0f, 0.0f,
+    1.0f, 0.0f, 0.0f, 0.0f,
+    1.0f, 0.0f, 0.0f, 0.0f,
+    1.0f, 0.0f, 0.0f, 0.0f,
+};
+
+static const GLuint g_BaseIndices[] = {
+    0, 1, 2,
+    7, 6, 5,
+    3, 2, 6,
+    4, 0, 3,
+    4, 5, 1,
+    1, 5, 6,
+    0, 2, 3,
+    7, 5, 4,
+    3, 6, 7,
+    4, 3, 7,
+    4, 1, 0,
+    1, 6, 2,
+    9, 8, 10,
+    11, 9, 10,
+    12, 13,
+    14, 15, 16,
+    15, 17, 16,
+    18, 19, 21,
+    19, 20, 21,
+    22, 23, 25,
+    23, 24, 25,
+    26, 27, 29,
+    27, 28, 29,
+    30, 31, 33,
+    31, 32, 33
+};
+
+
+// ============================================================================
+// LOTE ESTÁTICO (arena, pilares e tochas)
+// ============================================================================
+// Tudo o que não se move na arena é montado uma vez, em buildStaticBatch(),
+// num único VBO com os vértices já em coordenadas do mundo:
+//
+//   [0, m_staticOpaqueCount)       chão, teto, paredes e pilares (opacos)
+//   [m_staticOpaqueCount, +tochas)  cubos das tochas (blend aditivo)
+//
+// Cada quadrilátero da arena, pilar e tocha é um trecho com a sua AABB, e
+// o frustum culling testa e conta cada um (ver submitStaticBatch). Os
+// vértices ficam agrupados por material: trechos visíveis vizinhos no VBO
+// e com a mesma permutação de shader (ver ShaderPermutation) saem num só
+// glDrawArrays, então com tudo visível são os mesmos desenhos de um lote
+// por permutação, qualquer que seja o número de pilares.
+// Cada vértice traz a posição no espaço do objeto, usada nas coordenadas
+// de textura, e a camada da textura do seu material.
+//
+// As tochas guardam o centro no lugar da posição: a escala da chama varia
+// a cada quadro e é aplicada no vertex shader (uniform torch_flicker).
+// ============================================================================
+struct StaticVertex
 {
-    glm::mat4 model = Matrix_Identity();
-    glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
+    glm::vec4 position;    // mundo (tochas: centro da tocha)
+    glm::vec4 normal;      // mundo
+    glm::vec4 local;       // espaço do objeto
+    float     flamePhase;  // fase da chama (tochas)
+    float     layer;       // camada da textura do material
+};
+
+// Acrescenta os 6 vértices de um quadrilátero da arena (índices first..first+5
+// de g_BaseIndices), que já está em coordenadas do mundo
+static void appendArenaQuad(std::vector<StaticVertex>& vertices, int first, float layer)
+{
+    for (int k = 0; k < 6; k++)
+    {
+        GLuint v = g_BaseIndices[first + k];
+        StaticVertex vertex;
+        vertex.position = glm::make_vec4(&g_BaseModelCoefficients[4 * v]);
+        vertex.normal = glm::make_vec4(&g_BaseNormalCoefficients[4 * v]);
+        vertex.local = vertex.position;
+        vertex.flamePhase = 0.0f;
+        vertex.layer = layer;
+        vertices.push_back(vertex);
+    }
+}
 
-    glBindVertexArray(m_vertexArrayObjectID);
+// Acrescenta os 36 vértices do cubo transformados por 'model'. Para as
+// tochas (keepCenter), a posição fica sendo o centro e a escala é aplicada
+// no shader.
+static void appendCube(std::vector<StaticVertex>& vertices, const glm::mat4& model, float phase, bool keepCenter, float layer)
+{
+    glm::mat4 normalMatrix = glm::transpose(glm::inverse(model));
+    glm::vec4 center = model * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
-    glUniform1i(m_objectIdUniform, 2);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(36*sizeof(GLuint)));
+    for (int k = 0; k < 36; k++)
+    {
+        GLuint v = g_BaseIndices[k];
+        glm::vec4 local = glm::make_vec4(&g_BaseModelCoefficients[4 * v]);
+        glm::vec4 normal = glm::make_vec4(&g_BaseNormalCoefficients[4 * v]);
+
+        StaticVertex vertex;
+        vertex.position = keepCenter ? center : model * local;
+        vertex.normal = keepCenter ? normal : normalMatrix * normal;
+        vertex.normal.w = 0.0f;
+        vertex.local = local;
+        vertex.flamePhase = phase;
+        vertex.layer = layer;
+        vertices.push_back(vertex);
+    }
+}
 
-    glUniform1i(m_objectIdUniform, 3);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(50*sizeof(GLuint)));
+// Trecho de um objeto, vértices [first, end), com a AABB deles aumentada
+// de 'margin' em cada eixo
+static void appendStaticRange(std::vector<StaticBatchRange>& ranges, const std::vector<StaticVertex>& vertices,
+                              int permutation, GLsizei first, GLsizei end, const glm::vec3& margin)
+{
+    StaticBatchRange range;
+    range.permutation = permutation;
+    range.first = first;
+    range.count = end - first;
+    range.bboxMin = glm::vec3(0.0f);
+    range.bboxMax = glm::vec3(0.0f);
+    for (GLsizei v = range.first; v < range.first + range.count; v++)
+    {
+        glm::vec3 position = glm::vec3(vertices[v].position);
+        range.bboxMin = v == range.first ? position : glm::min(range.bboxMin, position);
+        range.bboxMax = v == range.first ? position : glm::max(range.bboxMax, position);
+    }
+    range.bboxMin -= margin;
+    range.bboxMax += margin;
+    ranges.push_back(range);
+}
 
-    glUniform1i(m_objectIdUniform, 4);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(56*sizeof(GLuint)));
+void Renderer::buildStaticBatch(const std::vector<Pillar>& pillars, const std::vector<Torch>& torches)
+{
+    std::vector<StaticVertex> vertices;
+    vertices.reserve(6 * 6 + 36 * (pillars.size() + torches.size()));
+    m_staticOpaqueRanges.clear();
+    m_staticTorchRanges.clear();
+
+    // (primeiro índice em g_BaseIndices, material)
+    static const int ARENA_QUADS[][2] = {
+        { 36, 2 },  // chão
+        { 50, 3 },  // parede norte
+        { 56, 4 },  // parede sul
+        { 62, 5 },  // parede leste
+        { 68, 6 },  // parede oeste
+        { 44, 7 },  // teto
+    };
+    for (size_t q = 0; q < sizeof(ARENA_QUADS) / sizeof(ARENA_QUADS[0]); q++)
+    {
+        GLsizei first = (GLsizei)vertices.size();
+        appendArenaQuad(vertices, ARENA_QUADS[q][0], m_materialLayer[ARENA_QUADS[q][1]]);
+        appendStaticRange(m_staticOpaqueRanges, vertices, permutationOf(ARENA_QUADS[q][1]),
+                          first, (GLsizei)vertices.size(), glm::vec3(0.0f));
+    }
+
+    for (size_t i = 0; i < pillars.size(); i++)
+    {
+        const Pillar& pillar = pillars[i];
+        float cubeSize = 0.2f;
+        glm::mat4 model = Matrix_Translate(pillar.position.x, pillar.position.y + pillar.height * 0.5f, pillar.position.z)
+                        * Matrix_Scale(pillar.sizeXZ / cubeSize, pillar.height / cubeSize, pillar.sizeXZ / cubeSize);
+        GLsizei first = (GLsizei)vertices.size();
+        appendCube(vertices, model, 0.0f, false, m_materialLayer[15]);
+        appendStaticRange(m_staticOpaqueRanges, vertices, permutationOf(15), // PILAR
+                          first, (GLsizei)vertices.size(), glm::vec3(0.0f));
+    }
+    m_staticOpaqueCount = (GLsizei)vertices.size();
+
+    // Os vértices das tochas são o centro; a chama chega a 0.15 x 0.225 x 0.15
+    // vezes o cubo base (±0.1), ver o vertex shader
+    const glm::vec3 flameMargin(0.015f, 0.0225f, 0.015f);
+    for (size_t i = 0; i < torches.size(); i++)
+    {
+        if (!torches[i].active)
+            continue;
 
-    glUniform1i(m_objectIdUniform, 5);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(62*sizeof(GLuint)));
+        const Torch& torch = torches[i];
+        glm::mat4 model = Matrix_Translate(torch.position.x, torch.position.y, torch.position.z);
+        GLsizei first = (GLsizei)vertices.size();
+        appendCube(vertices, model, i * 1.5f, true, m_materialLayer[17]);
+        appendStaticRange(m_staticTorchRanges, vertices, permutationOf(17), // TOCHA
+                          first, (GLsizei)vertices.size(), flameMargin);
+    }
+
+    if (m_staticBatchVAO == 0)
+    {
+        glGenVertexArrays(1, &m_staticBatchVAO);
+        glGenBuffers(1, &m_staticBatchVBO);
+    }
 
-    glUniform1i(m_objectIdUniform, 6);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(68*sizeof(GLuint)));
+    glBindVertexArray(m_staticBatchVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_staticBatchVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(StaticVertex), vertices.data(), GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, local));
+    glEnableVertexAttribArray(8);
+    glVertexAttribPointer(9, 1, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, flamePhase));
+    glEnableVertexAttribArray(9);
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, layer));
+    glEnableVertexAttribArray(7);
 
-    glUniform1i(m_objectIdUniform, 7);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(44*sizeof(GLuint)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void Renderer::renderArena()
+{
+    if (m_staticBatchVAO == 0)
+        return;
+
+    // Os cubos dos pilares não têm orientação consistente nas faces
+    submitStaticBatch(PASS_OPAQUE_NO_CULL, m_staticOpaqueRanges);
 }
 
 // ============================================================================
@@ -326,13 +775,13 @@ void Renderer::renderArena()
 void Renderer::renderPlayer(const Player& player)
 {
     glm::mat4 model = Matrix_Identity();
-    glm::vec4 position = player.getPosition();
+    glm::vec4 position = player.getInterpolatedPosition(m_interpolationAlpha);
 
     // Salva a matriz identidade na pilha
     PushMatrix(model);
 
     // Ajusta a posição Y para que os pés toquem o chão
-    float dist_chao = m_virtualScene["Arqueira"].bbox_min.y;
+    float dist_chao = meshBottom(m_meshArcher);
     dist_chao=0-dist_chao;
     dist_chao=dist_chao*0.001f;
 
@@ -348,9 +797,7 @@ void Renderer::renderPlayer(const Player& player)
         // Aplica offset para posicionar a varinha na "mão" da arqueira
         // + rotação e escala específicas da varinha
         model = model*Matrix_Translate(0.057f,0.06f,0.02f)*Matrix_Rotate_X(M_PI/4)* Matrix_Scale(0.09f, 0.09f, 0.09f);
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, 10);
-        drawVirtualObject("Varinha");
+        submitMesh(PASS_OPAQUE, m_meshWand, 10, model);
     // Restaura a matriz da arqueira
     PopMatrix(model);
 
@@ -358,16 +805,11 @@ void Renderer::renderPlayer(const Player& player)
     // RENDERIZAÇÃO DA ARQUEIRA (Objeto Pai)
     // ─────────────────────────────────────────────────────────────────────────
     model=model* Matrix_Scale(0.001f, 0.001f, 0.001f);
-    glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1i(m_objectIdUniform, 1);
     // Renderiza o player
-    if (m_virtualScene.find("Arqueira") != m_virtualScene.end())
-        drawVirtualObject("Arqueira");
-    else if (m_virtualScene.find("cube_faces") != m_virtualScene.end())
-    {
-        glBindVertexArray(m_vertexArrayObjectID);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-    }
+    if (m_meshArcher != INVALID_MESH)
+        submitMesh(PASS_OPAQUE, m_meshArcher, 1, model);
+    else
+        submitCube(PASS_OPAQUE, 1, model);
 
     PopMatrix(model);
 }
@@ -375,33 +817,26 @@ void Renderer::renderPlayer(const Player& player)
 void Renderer::renderPlayerLookingAt(const Player& player, const glm::vec4& cameraPosition)
 {
     glm::mat4 model = Matrix_Identity();
-    glm::vec4 position = player.getPosition();
+    glm::vec4 position = player.getInterpolatedPosition(m_interpolationAlpha);
 
     glm::vec4 toCamera = cameraPosition - position;
     float angleToCamera = atan2(toCamera.x, toCamera.z);
 
     PushMatrix(model);
-    float dist_chao = m_virtualScene["Arqueira"].bbox_min.y;
+    float dist_chao = meshBottom(m_meshArcher);
     dist_chao=0-dist_chao;
     dist_chao=dist_chao*0.001f;
     model = model * Matrix_Translate(position.x, dist_chao + position.y - 0.101f, position.z)
                   * Matrix_Rotate_Y(angleToCamera);
     PushMatrix(model);
         model = model*Matrix_Translate(0.057f,0.06f,0.02f)*Matrix_Rotate_X(M_PI/4)* Matrix_Scale(0.09f, 0.09f, 0.09f);
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, 10);
-        drawVirtualObject("Varinha");
+        submitMesh(PASS_OPAQUE, m_meshWand, 10, model);
     PopMatrix(model);
     model=model* Matrix_Scale(0.001f, 0.001f, 0.001f);
-    glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1i(m_objectIdUniform, 1);
-    if (m_virtualScene.find("Arqueira") != m_virtualScene.end())
-        drawVirtualObject("Arqueira");
-    else if (m_virtualScene.find("cube_faces") != m_virtualScene.end())
-    {
-        glBindVertexArray(m_vertexArrayObjectID);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-    }
+    if (m_meshArcher != INVALID_MESH)
+        submitMesh(PASS_OPAQUE, m_meshArcher, 1, model);
+    else
+        submitCube(PASS_OPAQUE, 1, model);
 
     PopMatrix(model);
 }
@@ -417,52 +852,38 @@ void Renderer::renderPlayerLookingAt(const Player& player, const glm::vec4& came
 // Cada inimigo i possui sua própria matriz modelo:
 //     M_inimigo[i] = Translate(x[i], y[i], z[i]) * Rotate(angulo[i]) * Scale(s[i])
 //
-// O VAO do modelo "turle" é vinculado uma vez e reutilizado para
-// todos os inimigos, mudando apenas a uniform "model" entre as chamadas.
-//
-// Isso é mais eficiente do que criar geometria separada para cada inimigo,
-// pois os dados de vértices são compartilhados na GPU.
+// Cada inimigo vira um pacote na fila de renderização. Como todos usam o
+// modelo "turle", os pacotes ficam vizinhos depois da ordenação e o
+// flush desenha a horda inteira com uma glDrawElementsInstanced. Os que
+// estão morrendo usam outro programa e formam uma corrida à parte.
 // ============================================================================
-void Renderer::renderEnemies(const EnemyManager& enemyManager, const glm::vec4& playerPosition)
+void Renderer::submitEnemy(const EnemyManager& enemyManager, size_t i, float groundOffset, float rotationAngle)
 {
-    const std::vector<Enemy>& enemies = enemyManager.getEnemies();
-    glm::mat4 model = Matrix_Identity();
+    const float baseScale = 0.15f;
+    float scale = baseScale * enemyManager.getDeathScale(i);
+    glm::vec4 enemyPos = enemyManager.getInterpolatedPosition(i, m_interpolationAlpha);
+
+    glm::mat4 model = Matrix_Translate(enemyPos.x, groundOffset, enemyPos.z)
+                    * Matrix_Rotate_Y(rotationAngle)
+                    * Matrix_Scale(scale, scale, scale);
+    int objectId = enemyManager.isDying(i) ? 18 : 0; // DYING_ENEMY : MONSTRO
+
+    // Sem o modelo do monstro, cada inimigo vira um cubo
+    if (m_meshMonster != INVALID_MESH)
+        submitMesh(PASS_OPAQUE, m_meshMonster, objectId, model);
+    else
+        submitCube(PASS_OPAQUE, objectId, model);
+}
 
+void Renderer::renderEnemies(const EnemyManager& enemyManager, const glm::vec4& playerPosition)
+{
     // Ajuste de altura para posicionar no chão (baseado na bounding box)
-    float dist_chao = m_virtualScene["turle"].bbox_min.y;
+    float dist_chao = meshBottom(m_meshMonster);
     dist_chao=0-dist_chao;
     dist_chao=dist_chao*0.15f;
 
-    // Itera sobre todos os inimigos, renderizando cada um com sua matriz própria
-    for (size_t i = 0; i < enemies.size(); i++)
-    {
-        float baseScale = 0.15f;
-        float deathScale = enemies[i].getDeathScale();
-        float finalScale = baseScale * deathScale;
-
-        PushMatrix(model);
-        model = model * Matrix_Translate(enemies[i].getX(), dist_chao, enemies[i].getZ());
-        float rotation_angle = enemies[i].lookAt(playerPosition);
-        model = model * Matrix_Rotate_Y(rotation_angle);
-        model = model * Matrix_Scale(finalScale, finalScale, finalScale);
-
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-
-        if (enemies[i].isDying())
-            glUniform1i(m_objectIdUniform, 18);
-        else
-            glUniform1i(m_objectIdUniform, 0);
-
-        if (m_virtualScene.find("turle") != m_virtualScene.end())
-            drawVirtualObject("turle");
-        else if (m_virtualScene.find("cube_faces") != m_virtualScene.end())
-        {
-            glBindVertexArray(m_vertexArrayObjectID);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-        }
-
-        PopMatrix(model);
-    }
+    for (size_t i = 0; i < enemyManager.getEnemyCount(); i++)
+        submitEnemy(enemyManager, i, dist_chao, enemyManager.lookAt(i, playerPosition));
 }
 
 void Renderer::renderDragonBoss(const Enemy& dragon, bool isAlive, const glm::vec4& playerPosition)
@@ -471,7 +892,7 @@ void Renderer::renderDragonBoss(const Enemy& dragon, bool isAlive, const glm::ve
         return;
 
     glm::mat4 model = Matrix_Identity();
-    glm::vec4 dragonPos = dragon.getPosition();
+    glm::vec4 dragonPos = dragon.getInterpolatedPosition(m_interpolationAlpha);
 
     PushMatrix(model);
 
@@ -481,12 +902,9 @@ void Renderer::renderDragonBoss(const Enemy& dragon, bool isAlive, const glm::ve
                   * Matrix_Rotate_Y(angleToPlayer)
                   * Matrix_Scale(0.4f, 0.4f, 0.4f);
 
-    glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1i(m_objectIdUniform, 9);
-
-    if (m_virtualScene.find("Mesh1.001") != m_virtualScene.end())
+    if (m_meshDragon != INVALID_MESH)
     {
-        drawVirtualObject("Mesh1.001");
+        submitMesh(PASS_OPAQUE, m_meshDragon, 9, model);
     }
 
     PopMatrix(model);
@@ -494,42 +912,16 @@ void Renderer::renderDragonBoss(const Enemy& dragon, bool isAlive, const glm::ve
 
 void Renderer::renderEnemiesLookingAt(const EnemyManager& enemyManager, const glm::vec4& cameraPosition)
 {
-    const std::vector<Enemy>& enemies = enemyManager.getEnemies();
-    glm::mat4 model = Matrix_Identity();
-    float dist_chao = m_virtualScene["turle"].bbox_min.y;
+    float dist_chao = meshBottom(m_meshMonster);
     dist_chao=0-dist_chao;
     dist_chao=dist_chao*0.15f;
-    for (size_t i = 0; i < enemies.size(); i++)
+    for (size_t i = 0; i < enemyManager.getEnemyCount(); i++)
     {
-        float baseScale = 0.15f;
-        float deathScale = enemies[i].getDeathScale();
-        float finalScale = baseScale * deathScale;
-
-        glm::vec4 enemyPos = enemies[i].getPosition();
+        glm::vec4 enemyPos = enemyManager.getInterpolatedPosition(i, m_interpolationAlpha);
         glm::vec4 toCamera = cameraPosition - enemyPos;
         float angleToCamera = atan2(toCamera.x, toCamera.z);
 
-        PushMatrix(model);
-        model = model * Matrix_Translate(enemies[i].getX(), dist_chao, enemies[i].getZ());
-        model = model * Matrix_Rotate_Y(angleToCamera);
-        model = model * Matrix_Scale(finalScale, finalScale, finalScale);
-
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-
-        if (enemies[i].isDying())
-            glUniform1i(m_objectIdUniform, 18);
-        else
-            glUniform1i(m_objectIdUniform, 0);
-
-        if (m_virtualScene.find("turle") != m_virtualScene.end())
-            drawVirtualObject("turle");
-        else if (m_virtualScene.find("cube_faces") != m_virtualScene.end())
-        {
-            glBindVertexArray(m_vertexArrayObjectID);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-        }
-
-        PopMatrix(model);
+        submitEnemy(enemyManager, i, dist_chao, angleToCamera);
     }
 }
 
@@ -539,7 +931,7 @@ void Renderer::renderDragonBossLookingAt(const Enemy& dragon, bool isAlive, cons
         return;
 
     glm::mat4 model = Matrix_Identity();
-    glm::vec4 dragonPos = dragon.getPosition();
+    glm::vec4 dragonPos = dragon.getInterpolatedPosition(m_interpolationAlpha);
 
     glm::vec4 toCamera = cameraPosition - dragonPos;
     float angleToCamera = atan2(toCamera.x, toCamera.z) + 1.5707963f;
@@ -550,44 +942,14 @@ void Renderer::renderDragonBossLookingAt(const Enemy& dragon, bool isAlive, cons
                   * Matrix_Rotate_Y(angleToCamera)
                   * Matrix_Scale(0.4f, 0.4f, 0.4f);
 
-    glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-    glUniform1i(m_objectIdUniform, 9);
-
-    if (m_virtualScene.find("Mesh1.001") != m_virtualScene.end())
+    if (m_meshDragon != INVALID_MESH)
     {
-        drawVirtualObject("Mesh1.001");
+        submitMesh(PASS_OPAQUE, m_meshDragon, 9, model);
     }
 
     PopMatrix(model);
 }
 
-void Renderer::renderPillars(const std::vector<Pillar>& pillars)
-{
-    glDisable(GL_CULL_FACE);
-
-    for (size_t i = 0; i < pillars.size(); i++)
-    {
-        const Pillar& pillar = pillars[i];
-
-        glm::mat4 model = Matrix_Identity();
-        float cubeSize = 0.2f;
-        float scaleX = pillar.sizeXZ / cubeSize;
-        float scaleY = pillar.height / cubeSize;
-        float scaleZ = pillar.sizeXZ / cubeSize;
-
-        model = model * Matrix_Translate(pillar.position.x, pillar.position.y + pillar.height * 0.5f, pillar.position.z)
-                      * Matrix_Scale(scaleX, scaleY, scaleZ);
-
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, 15); // PILAR
-
-        glBindVertexArray(m_vertexArrayObjectID);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-    }
-
-    glEnable(GL_CULL_FACE);
-}
-
 void Renderer::renderHealthPickups(const std::vector<HealthPickup>& pickups, float deltaTime)
 {
     static float rotation = 0.0f;
@@ -607,41 +969,29 @@ void Renderer::renderHealthPickups(const std::vector<HealthPickup>& pickups, flo
                       * Matrix_Rotate_Y(rotation)
                       * Matrix_Scale(pickupScale, pickupScale, pickupScale);
 
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, 16);
-        drawVirtualObject("vida");
+        submitMesh(PASS_OPAQUE, m_meshHealth, 16, model);
     }
 }
 
 void Renderer::updateTorchLights(const std::vector<Torch>& torches, float flicker)
 {
-    float positions[24];
-    float colors[24];
-    float intensities[8];
     int count = 0;
 
-    for (size_t i = 0; i < torches.size() && i < 8; i++)
+    for (size_t i = 0; i < torches.size() && count < MAX_TORCH_LIGHTS; i++)
     {
         if (!torches[i].active) continue;
 
-        positions[count*3]   = torches[i].position.x;
-        positions[count*3+1] = torches[i].position.y;
-        positions[count*3+2] = torches[i].position.z;
+        //float intensity = 2.2f + 0.5f * sin(flicker + i * 1.5f);
+        float intensity = 1.5f + 0.4f * sin(flicker + i * 1.5f);
 
-        colors[count*3]   = 1.0f;
-        colors[count*3+1] = 0.55f;
-        colors[count*3+2] = 0.15f;
-
-        //intensities[count] = 2.2f + 0.5f * sin(flicker + i * 1.5f);
-        intensities[count] = 1.5f + 0.4f * sin(flicker + i * 1.5f);
+        m_torchUniforms.positions[count] = glm::vec4(torches[i].position, intensity);
+        m_torchUniforms.colors[count] = glm::vec4(1.0f, 0.55f, 0.15f, 1.0f);
 
         count++;
     }
 
-    glUniform3fv(m_torchPositionsUniform, count, positions);
-    glUniform3fv(m_torchColorsUniform, count, colors);
-    glUniform1fv(m_torchIntensitiesUniform, count, intensities);
-    glUniform1i(m_numTorchesUniform, count);
+    m_torchUniforms.count = count;
+    m_torchUniforms.flicker = flicker;
 }
 
 void Renderer::renderTorches(const std::vector<Torch>& torches, float deltaTime)
@@ -651,86 +1001,55 @@ void Renderer::renderTorches(const std::vector<Torch>& torches, float deltaTime)
 
     updateTorchLights(torches, flicker);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glDepthMask(GL_FALSE);
-
-    for (size_t i = 0; i < torches.size(); i++)
-    {
-        if (!torches[i].active)
-            continue;
-
-        const Torch& torch = torches[i];
-
-        float scale = 0.12f + 0.03f * sin(flicker + i * 1.5f);
-
-        glm::mat4 model = Matrix_Identity();
-        model = model * Matrix_Translate(torch.position.x, torch.position.y, torch.position.z)
-                      * Matrix_Scale(scale, scale * 1.5f, scale);
-
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, 17);  // TOCHA
-
-        glBindVertexArray(m_vertexArrayObjectID);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
-    }
+    if (m_staticBatchVAO == 0)
+        return;
 
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
+    // As coordenadas de textura da chama são relativas ao cubo base
+    submitStaticBatch(PASS_ADDITIVE, m_staticTorchRanges);
 }
 
 void Renderer::renderProjectiles(const ProjectileManager& projectileManager, float deltaTime)
 {
-    const std::vector<Projectile>& projectiles = projectileManager.getProjectiles();
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glDepthMask(GL_FALSE);
-
-    for (size_t i = 0; i < projectiles.size(); i++)
+    for (size_t i = 0; i < projectileManager.getProjectileCount(); i++)
     {
-        if (!projectiles[i].active)
+        if (!projectileManager.isActive(i))
             continue;
 
-        const Projectile& proj = projectiles[i];
+        bool isEnemy = projectileManager.isEnemyProjectile(i);
+        glm::vec3 position = projectileManager.getInterpolatedPosition(i, m_interpolationAlpha);
 
         glm::mat4 model = Matrix_Identity();
-        model = model * Matrix_Translate(proj.position.x, proj.position.y-0.03f, proj.position.z)
+        model = model * Matrix_Translate(position.x, position.y-0.03f, position.z)
                       * Matrix_Scale(0.005f, 0.005f, 0.005f);
 
-        glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-        glUniform1i(m_objectIdUniform, proj.isEnemyProjectile ? 13 : 11);
+        submitMesh(PASS_ADDITIVE, m_meshProjectile, isEnemy ? 13 : 11, model);
 
-        drawVirtualObject("Sphere");
-
-        for (int t = 0; t < Projectile::TRAIL_LENGTH; t++)
+        for (int t = 0; t < ProjectileManager::TRAIL_LENGTH; t++)
         {
-            int idx = (proj.trailIndex - 1 - t + Projectile::TRAIL_LENGTH) % Projectile::TRAIL_LENGTH;
-            glm::vec3 trailPos = proj.trailPositions[idx];
+            glm::vec3 trailPos = projectileManager.getTrailPosition(i, t);
 
-            float dx = trailPos.x - proj.position.x;
-            float dy = trailPos.y - proj.position.y;
-            float dz = trailPos.z - proj.position.z;
+            float dx = trailPos.x - position.x;
+            float dy = trailPos.y - position.y;
+            float dz = trailPos.z - position.z;
             float distSq = dx*dx + dy*dy + dz*dz;
             if (distSq < 0.01f) continue;
 
-            float scale = 0.04f * (1.0f - (float)t / Projectile::TRAIL_LENGTH);
+            float scale = 0.04f * (1.0f - (float)t / ProjectileManager::TRAIL_LENGTH);
             if (scale < 0.01f) continue;
 
             model = Matrix_Identity();
             model = model * Matrix_Translate(trailPos.x, trailPos.y, trailPos.z)
                           * Matrix_Scale(scale, scale, scale);
 
-            glUniformMatrix4fv(m_modelUniform, 1, GL_FALSE, glm::value_ptr(model));
-            glUniform1i(m_objectIdUniform, proj.isEnemyProjectile ? 14 : 12);
-
-            glBindVertexArray(m_vertexArrayObjectID);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
+            submitCube(PASS_ADDITIVE, isEnemy ? 14 : 12, model);
         }
     }
+}
 
-    glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
+// O texto dos render* abaixo só é desenhado aqui, todo de uma vez
+void Renderer::flushText()
+{
+    TextRendering_Flush();
 }
 
 void Renderer::renderHitMarker()
@@ -866,194 +1185,93 @@ void Renderer::renderPauseOverlay(const char* focusTargetName, int enemyIndex)
 
 GLuint Renderer::buildGeometry()
 {
-    GLfloat model_coefficients[] = {
-        -0.1f,  0.1f,  0.1f, 1.0f,
-        -0.1f, -0.1f,  0.1f, 1.0f,
-         0.1f, -0.1f,  0.1f, 1.0f,
-         0.1f,  0.1f,  0.1f, 1.0f,
-        -0.1f,  0.1f, -0.1f, 1.0f,
-        -0.1f, -0.1f, -0.1f, 1.0f,
-         0.1f, -0.1f, -0.1f, 1.0f,
-         0.1f,  0.1f, -0.1f, 1.0f,
-         5.0f, 0.0f,  2.0f, 1.0f,
-        -5.0f, 0.0f,  2.0f, 1.0f,
-         5.0f, 0.0f, -2.0f, 1.0f,
-        -5.0f, 0.0f, -2.0f, 1.0f,
-         0.0f,  0.0f,  0.0f, 1.0f,
-         0.0f,  0.0f,  0.4f, 1.0f,
-         5.0f, 3.0f,  2.0f, 1.0f,
-        -5.0f, 3.0f,  2.0f, 1.0f,
-         5.0f, 3.0f, -2.0f, 1.0f,
-        -5.0f, 3.0f, -2.0f, 1.0f,
-         4.5f, 0.0f,  1.5f, 1.0f,
-        -4.5f, 0.0f,  1.5f, 1.0f,
-        -4.5f, 3.0f,  1.5f, 1.0f,
-         4.5f, 3.0f,  1.5f, 1.0f,
-        -4.5f, 0.0f, -1.5f, 1.0f,
-         4.5f, 0.0f, -1.5f, 1.0f,
-         4.5f, 3.0f, -1.5f, 1.0f,
-        -4.5f, 3.0f, -1.5f, 1.0f,
-         4.5f, 0.0f, -1.5f, 1.0f,
-         4.5f, 0.0f,  1.5f, 1.0f,
-         4.5f, 3.0f,  1.5f, 1.0f,
-         4.5f, 3.0f, -1.5f, 1.0f,
-        -4.5f, 0.0f,  1.5f, 1.0f,
-        -4.5f, 0.0f, -1.5f, 1.0f,
-        -4.5f, 3.0f, -1.5f, 1.0f,
-        -4.5f, 3.0f,  1.5f, 1.0f,
-    };
-
     GLuint VBO_model_coefficients_id;
     glGenBuffers(1, &VBO_model_coefficients_id);
     GLuint vertex_array_object_id;
     glGenVertexArrays(1, &vertex_array_object_id);
     glBindVertexArray(vertex_array_object_id);
+    enableInstanceAttributes();
     glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(model_coefficients), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(model_coefficients), model_coefficients);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(g_BaseModelCoefficients), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(g_BaseModelCoefficients), g_BaseModelCoefficients);
     GLuint location = 0;
     GLint  number_of_dimensions = 4;
     glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(location);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    GLfloat normal_coefficients[] = {
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, -1.0f, 0.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, -1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        0.0f, 0.0f, 1.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f, 0.0f,
-    };
-
     GLuint VBO_normal_coefficients_id;
     glGenBuffers(1, &VBO_normal_coefficients_id);
     glBindBuffer(GL_ARRAY_BUFFER, VBO_normal_coefficients_id);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(normal_coefficients), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(normal_coefficients), normal_coefficients);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(g_BaseNormalCoefficients), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(g_BaseNormalCoefficients), g_BaseNormalCoefficients);
     location = 1;
     number_of_dimensions = 4;
     glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(location);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    GLuint indices[] = {
-        0, 1, 2,
-        7, 6, 5,
-        3, 2, 6,
-        4, 0, 3,
-        4, 5, 1,
-        1, 5, 6,
-        0, 2, 3,
-        7, 5, 4,
-        3, 6, 7,
-        4, 3, 7,
-        4, 1, 0,
-        1, 6, 2,
-        9, 8, 10,
-        11, 9, 10,
-        12, 13,
-        14, 15, 16,
-        15, 17, 16,
-        18, 19, 21,
-        19, 20, 21,
-        22, 23, 25,
-        23, 24, 25,
-        26, 27, 29,
-        27, 28, 29,
-        30, 31, 33,
-        31, 32, 33
-    };
-
     SceneObject cube_faces;
     cube_faces.name           = "Cubo (faces coloridas)";
     cube_faces.first_index    = 0;
     cube_faces.num_indices    = 36;
     cube_faces.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["cube_faces"] = cube_faces;
+    addMesh("cube_faces", cube_faces);
 
     SceneObject piso;
     piso.name = "Piso";
     piso.first_index = (36*sizeof(GLuint));
     piso.num_indices = 6;
     piso.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["piso"] = piso;
+    addMesh("piso", piso);
 
     SceneObject eixo_z;
     eixo_z.name = "Z";
     eixo_z.first_index = (42*sizeof(GLuint));
     eixo_z.num_indices = 2;
     eixo_z.rendering_mode = GL_LINES;
-    m_virtualScene["eixo_z"] = eixo_z;
+    addMesh("eixo_z", eixo_z);
 
     SceneObject teto;
     teto.name = "Teto";
     teto.first_index = (44*sizeof(GLuint));
     teto.num_indices = 6;
     teto.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["teto"] = teto;
+    addMesh("teto", teto);
 
     SceneObject parede_norte;
     parede_norte.name = "Parede Norte";
     parede_norte.first_index = (50*sizeof(GLuint));
     parede_norte.num_indices = 6;
     parede_norte.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["parede_norte"] = parede_norte;
+    addMesh("parede_norte", parede_norte);
 
     SceneObject parede_sul;
     parede_sul.name = "Parede Sul";
     parede_sul.first_index = (56*sizeof(GLuint));
     parede_sul.num_indices = 6;
     parede_sul.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["parede_sul"] = parede_sul;
+    addMesh("parede_sul", parede_sul);
 
     SceneObject parede_leste;
     parede_leste.name = "Parede Leste";
     parede_leste.first_index = (62*sizeof(GLuint));
     parede_leste.num_indices = 6;
     parede_leste.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["parede_leste"] = parede_leste;
+    addMesh("parede_leste", parede_leste);
 
     SceneObject parede_oeste;
     parede_oeste.name = "Parede Oeste";
     parede_oeste.first_index = (68*sizeof(GLuint));
     parede_oeste.num_indices = 6;
     parede_oeste.rendering_mode = GL_TRIANGLES;
-    m_virtualScene["parede_oeste"] = parede_oeste;
+    addMesh("parede_oeste", parede_oeste);
 
     GLuint indices_id;
     glGenBuffers(1, &indices_id);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(g_BaseIndices), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(g_BaseIndices), g_BaseIndices);
     glBindVertexArray(0);
     return vertex_array_object_id;
 }
@@ -1063,95 +1281,204 @@ GLuint Renderer::buildGeometry()
 // ============================================================================
 // REQUISITO 8: Mapeamento de texturas em todos os objetos
 //
-// Carrega uma imagem do disco e cria uma textura OpenGL.
-// Cada textura é associada a uma unidade de textura (GL_TEXTURE0 + n).
+// O array de texturas dos materiais é alocado uma vez, com todas as
+// camadas e níveis, e cada imagem carregada preenche a sua camada.
 //
 // Parâmetros de amostragem configurados:
 // - GL_TEXTURE_WRAP_S/T = GL_REPEAT: textura repete nas bordas
 // - GL_TEXTURE_MIN_FILTER = GL_LINEAR_MIPMAP_LINEAR: trilinear filtering
 // - GL_TEXTURE_MAG_FILTER = GL_LINEAR: bilinear filtering
 //
-// As texturas são vinculadas no fragment shader via samplers:
-//     uniform sampler2D TextureImage0;  // textura do inimigo
-//     uniform sampler2D TextureImage1;  // textura da parede
-//     etc.
+// No fragment shader o array é amostrado com a camada do material:
+//     uniform sampler2DArray material_textures;
+//     texture(material_textures, vec3(U, V, texture_layer))
 // ============================================================================
-void Renderer::LoadTextureImage(const char* filename)
+void Renderer::createMaterialTextures(GLsizei layers)
 {
-    printf("Carregando imagem \"%s\"... ", filename);
-
-    // Leitura da imagem usando stb_image
-    // stbi_set_flip_vertically_on_load: OpenGL espera a origem em baixo-esquerda
-    stbi_set_flip_vertically_on_load(true);
-    int width;
-    int height;
-    int channels;
-    unsigned char *data = stbi_load(filename, &width, &height, &channels, 3);
-
-    if ( data == NULL )
-    {
-        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", filename);
-        std::exit(EXIT_FAILURE);
-    }
-
-    printf("OK (%dx%d).\n", width, height);
-
-    // Agora criamos objetos na GPU com OpenGL para armazenar a textura
-    GLuint texture_id;
     GLuint sampler_id;
-    glGenTextures(1, &texture_id);
+    glGenTextures(1, &m_materialTextures);
     glGenSamplers(1, &sampler_id);
 
     // Veja slides 95-96 do documento Aula_20_Mapeamento_de_Texturas.pdf
     glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glSamplerParameteri(sampler_id, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-    // Par�metros de amostragem da textura.
+    // Parâmetros de amostragem da textura.
     glSamplerParameteri(sampler_id, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glSamplerParameteri(sampler_id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+    glActiveTexture(GL_TEXTURE0 + MATERIAL_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_materialTextures);
+    glBindSampler(MATERIAL_TEXTURE_UNIT, sampler_id);
+
+    // Todos os níveis de todas as camadas, sem dados: os uploads só
+    // preenchem (glTexStorage3D é do OpenGL 4.2)
+    int levels = TextureLevelCount(TEXTURE_LAYER_SIZE);
+    for (int level = 0, size = TEXTURE_LAYER_SIZE; level < levels; ++level, size = std::max(1, size / 2))
+    {
+        size_t uncompressed = (size_t)size * size * 3 * layers;
+        size_t blocks = (size_t)((size + 3) / 4) * ((size + 3) / 4) * 8 * layers;
+        if (m_textureCompression)
+            glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+                                   size, size, layers, 0, (GLsizei)blocks, NULL);
+        else
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_SRGB8, size, size, layers, 0,
+                         GL_RGB, GL_UNSIGNED_BYTE, NULL);
+        m_textureBytes += m_textureCompression ? blocks : uncompressed;
+        m_uncompressedTextureBytes += uncompressed;
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+}
+
+void Renderer::uploadTextureImage(TextureImage& image, GLint layer)
+{
     // Agora enviamos a imagem lida do disco para a GPU
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
     glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
 
-    GLuint textureunit = m_NumLoadedTextures;
-    glActiveTexture(GL_TEXTURE0 + textureunit);
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glBindSampler(textureunit, sampler_id);
+    glActiveTexture(GL_TEXTURE0 + MATERIAL_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_materialTextures);
 
-    stbi_image_free(data);
+    // Níveis do .ktx, já com os mipmaps
+    for (size_t level = 0; level < image.levels.size(); ++level)
+    {
+        const BakedLevel& baked = image.levels[level];
+        if (m_textureCompression)
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, 0, 0, layer, baked.width, baked.height, 1,
+                                      GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, (GLsizei)baked.size, baked.data);
+        else
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, 0, 0, layer, baked.width, baked.height, 1,
+                            GL_RGB, GL_UNSIGNED_BYTE, &image.decodedLevels[level][0]);
+    }
+
+    image.decodedLevels.clear();
+    image.bakedLevels.clear();
+    image.levels.clear();
+    image.uploaded = true;
+    image.baked.close();
 
     m_NumLoadedTextures += 1;
 }
 
+// ============================================================================
+// PERMUTAÇÕES DE MATERIAL
+// ============================================================================
+// Os #defines de cada material (object_id) e a camada da sua textura no
+// array de texturas (a ordem de TEXTURE_FILES). As opções estão descritas
+// no início de "shader_fragment.glsl" e "shader_vertex.glsl".
+// ============================================================================
+struct MaterialPermutation
+{
+    int         material;      // object_id
+    GLint       textureLayer;  // -1: sem textura
+    const char* defines;
+};
+
+static const MaterialPermutation MATERIAL_PERMUTATIONS[] =
+{
+    {  0,  0, "#define TEXCOORDS_MESH\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.2\n#define MATERIAL_SHININESS 64.0\n" },   // MONSTRO
+    {  1,  4, "#define TEXCOORDS_MESH\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.3\n#define MATERIAL_SHININESS 128.0\n" },  // CUBE (jogador)
+    {  2,  2, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.2\n#define GOURAUD_KA 0.1\n#define TEXCOORDS_PLANAR_XZ\n#define LIGHTING_GOURAUD\n" },  // PLANE
+    {  3,  1, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.3\n#define GOURAUD_KA 0.15\n#define TEXCOORDS_PLANAR_XY\n#define LIGHTING_GOURAUD\n" }, // WALL_NORTH
+    {  4,  1, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.3\n#define GOURAUD_KA 0.15\n#define TEXCOORDS_PLANAR_XY\n#define LIGHTING_GOURAUD\n" }, // WALL_SOUTH
+    {  5,  1, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.3\n#define GOURAUD_KA 0.15\n#define TEXCOORDS_PLANAR_ZY\n#define LIGHTING_GOURAUD\n" }, // WALL_EAST
+    {  6,  1, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.3\n#define GOURAUD_KA 0.15\n#define TEXCOORDS_PLANAR_ZY\n#define LIGHTING_GOURAUD\n" }, // WALL_WEST
+    {  7,  3, "#define STATIC_BATCH\n#define GOURAUD\n#define GOURAUD_KD 0.3\n#define GOURAUD_KA 0.15\n#define TEXCOORDS_PLANAR_XZ\n#define LIGHTING_GOURAUD\n" }, // CEILING
+    {  9,  9, "#define TEXCOORDS_MESH\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.4\n#define MATERIAL_SHININESS 64.0\n" },   // DRAGON_BOSS
+    { 10,  5, "#define TEXCOORDS_MESH\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.4\n#define MATERIAL_SHININESS 32.0\n" },   // VARINHA
+    { 11,  7, "#define TEXCOORDS_SPHERICAL\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.3\n#define MATERIAL_SHININESS 64.0\n" },  // PROJECTILE
+    { 12, -1, "#define LIGHTING_UNLIT\n#define UNLIT_COLOR (vec3(0.7, 0.1, 0.7) * 2.5)\n" },  // PROJECTILE_TRAIL
+    { 13,  8, "#define TEXCOORDS_SPHERICAL\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.3\n#define MATERIAL_SHININESS 64.0\n" },  // ENEMY_PROJECTILE
+    { 14, -1, "#define LIGHTING_UNLIT\n#define UNLIT_COLOR (vec3(1.0, 0.2, 0.0) * 1.8)\n" },  // ENEMY_PROJECTILE_TRAIL
+    { 15,  1, "#define STATIC_BATCH\n#define TEXCOORDS_BOX_WORLD\n#define LIGHTING_LAMBERT\n" },  // PILLAR
+    { 16,  6, "#define TEXCOORDS_MESH\n#define LIGHTING_BLINN_PHONG\n#define MATERIAL_KS 0.2\n#define MATERIAL_SHININESS 4.0\n" },    // HEALTH_PICKUP
+    { 17, 10, "#define STATIC_BATCH\n#define TORCH_FLAME\n#define TEXCOORDS_BOX_LOCAL\n#define LIGHTING_FIRE\n" },  // TORCH
+    { 18,  0, "#define TEXCOORDS_MESH\n#define LIGHTING_DEATH_FLASH\n" },  // DYING_ENEMY
+};
+
 void Renderer::loadShadersFromFiles()
 {
-    GLuint vertex_shader_id = loadShader_Vertex("src/shaders/shader_vertex.glsl");
-    GLuint fragment_shader_id = loadShader_Fragment("src/shaders/shader_fragment.glsl");
-    if (m_gpuProgramID != 0)
-        glDeleteProgram(m_gpuProgramID);
-    m_gpuProgramID = createGpuProgram(vertex_shader_id, fragment_shader_id);
+    for (size_t i = 0; i < m_permutations.size(); i++)
+        glDeleteProgram(m_permutations[i].program);
+    m_permutations.clear();
+    for (int material = 0; material < MAX_MATERIALS; material++)
+    {
+        m_materialPermutation[material] = -1;
+        m_materialLayer[material] = 0.0f;
+    }
+
+    for (size_t m = 0; m < sizeof(MATERIAL_PERMUTATIONS) / sizeof(MATERIAL_PERMUTATIONS[0]); m++)
+    {
+        const MaterialPermutation& material = MATERIAL_PERMUTATIONS[m];
+
+        // Mesmos #defines: reaproveita o programa, qualquer que seja a textura
+        int index = -1;
+        for (size_t i = 0; i < m_permutations.size(); i++)
+        {
+            if (m_permutations[i].defines == material.defines)
+                index = (int)i;
+        }
+
+        if (index < 0)
+        {
+            ShaderPermutation permutation;
+            permutation.defines = material.defines;
+
+            GLuint vertex_shader_id = loadShader_Vertex("src/shaders/shader_vertex.glsl", permutation.defines);
+            GLuint fragment_shader_id = loadShader_Fragment("src/shaders/shader_fragment.glsl", permutation.defines);
+            permutation.program = createGpuProgram(vertex_shader_id, fragment_shader_id);
+            // Os shaders só são liberados junto com o programa
+            glDeleteShader(vertex_shader_id);
+            glDeleteShader(fragment_shader_id);
+
+            permutation.modelUniform         = glGetUniformLocation(permutation.program, "model");
+            permutation.normalMatrixUniform  = glGetUniformLocation(permutation.program, "normal_matrix");
+            permutation.bboxMinUniform       = glGetUniformLocation(permutation.program, "bbox_min");
+            permutation.bboxMaxUniform       = glGetUniformLocation(permutation.program, "bbox_max");
+            permutation.useInstancingUniform = glGetUniformLocation(permutation.program, "use_instancing");
+            permutation.materialLayerUniform = glGetUniformLocation(permutation.program, "material_layer");
+
+            // Programas sem textura não têm o sampler (localização -1)
+            glUseProgram(permutation.program);
+            glUniform1i(glGetUniformLocation(permutation.program, "material_textures"), MATERIAL_TEXTURE_UNIT);
+            glUseProgram(0);
+
+            index = (int)m_permutations.size();
+            m_permutations.push_back(permutation);
+        }
+
+        m_materialPermutation[material.material] = index;
+        m_materialLayer[material.material] = (float)std::max(0, material.textureLayer);
+    }
+
+    printf("%zu shader permutations for %zu materials\n", m_permutations.size(),
+           sizeof(MATERIAL_PERMUTATIONS) / sizeof(MATERIAL_PERMUTATIONS[0]));
+}
+
+int Renderer::permutationOf(int objectId) const
+{
+    if (objectId < 0 || objectId >= MAX_MATERIALS)
+        return -1;
+    return m_materialPermutation[objectId];
 }
 
-GLuint Renderer::loadShader_Vertex(const char* filename)
+GLuint Renderer::loadShader_Vertex(const char* filename, const std::string& defines)
 {
     GLuint vertex_shader_id = glCreateShader(GL_VERTEX_SHADER);
-    loadShader(filename, vertex_shader_id);
+    loadShader(filename, vertex_shader_id, defines);
     return vertex_shader_id;
 }
 
-GLuint Renderer::loadShader_Fragment(const char* filename)
+GLuint Renderer::loadShader_Fragment(const char* filename, const std::string& defines)
 {
     GLuint fragment_shader_id = glCreateShader(GL_FRAGMENT_SHADER);
-    loadShader(filename, fragment_shader_id);
+    loadShader(filename, fragment_shader_id, defines);
     return fragment_shader_id;
 }
 
-void Renderer::loadShader(const char* filename, GLuint shader_id)
+void Renderer::loadShader(const char* filename, GLuint shader_id, const std::string& defines)
 {
     std::ifstream file;
     try {
@@ -1164,9 +1491,23 @@ void Renderer::loadShader(const char* filename, GLuint shader_id)
     std::stringstream shader;
     shader << file.rdbuf();
     std::string str = shader.str();
-    const GLchar* shader_string = str.c_str();
-    const GLint   shader_string_length = static_cast<GLint>(str.length());
-    glShaderSource(shader_id, 1, &shader_string, &shader_string_length);
+
+    // Os #defines da permutação vão logo depois da linha do #version, que
+    // tem de ser a primeira do shader; o #line mantém a numeração do
+    // arquivo nas mensagens de erro
+    size_t version_end = str.find("#version");
+    version_end = version_end == std::string::npos ? 0 : str.find('\n', version_end);
+    version_end = version_end == std::string::npos ? str.length() : version_end + 1;
+    std::string header = str.substr(0, version_end);
+    std::string prologue = defines + "#line 2\n";
+
+    const GLchar* shader_strings[3] = { header.c_str(), prologue.c_str(), str.c_str() + version_end };
+    const GLint   shader_string_lengths[3] = {
+        static_cast<GLint>(header.length()),
+        static_cast<GLint>(prologue.length()),
+        static_cast<GLint>(str.length() - version_end)
+    };
+    glShaderSource(shader_id, 3, shader_strings, shader_string_lengths);
     glCompileShader(shader_id);
     GLint compiled_ok;
     glGetShaderiv(shader_id, GL_COMPILE_STATUS, &compiled_ok);
@@ -1183,6 +1524,8 @@ void Renderer::loadShader(const char* filename, GLuint shader_id)
             output += "ERROR: OpenGL compilation of \"";
             output += filename;
             output += "\" failed.\n";
+            output += "== Permutation defines\n";
+            output += defines;
             output += "== Start of compilation log\n";
             output += log;
             output += "== End of compilation log\n";
@@ -1210,7 +1553,18 @@ GLuint Renderer::createGpuProgram(GLuint vertex_shader_id, GLuint fragment_shade
     glLinkProgram(program_id);
     GLint linked_ok = GL_FALSE;
     glGetProgramiv(program_id, GL_LINK_STATUS, &linked_ok);
-    if (linked_ok == GL_FALSE)
+    if (linked_ok == GL_TRUE)
+    {
+        // Uniform blocks por quadro (ver CameraUniforms), se o programa os usa
+        GLuint cameraBlock = glGetUniformBlockIndex(program_id, "CameraBlock");
+        if (cameraBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(program_id, cameraBlock, CAMERA_BLOCK_BINDING);
+
+        GLuint torchBlock = glGetUniformBlockIndex(program_id, "TorchBlock");
+        if (torchBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(program_id, torchBlock, TORCH_BLOCK_BINDING);
+    }
+    else
     {
         GLint log_length = 0;
         glGetProgramiv(program_id, GL_INFO_LOG_LENGTH, &log_length);
@@ -1365,148 +1719,792 @@ void Renderer::computeNormals(ObjModel* model)
     }
 }
 
-void Renderer::buildTrianglesFromObj(ObjModel* model)
+// ============================================================================
+// NÍVEIS DE DETALHE
+// ============================================================================
+// Cada objeto com pelo menos MIN_LOD_TRIANGLES triângulos ganha até
+// MAX_MESH_LODS - 1 versões simplificadas (ver MeshSimplifier.h), com
+// 1/2, 1/4 e 1/8 dos triângulos. A topologia vem dos índices de posição
+// do .obj; posições cujos cantos têm normais ou coordenadas de textura
+// diferentes (costuras) ficam travadas. Um nível que não reduz pelo menos
+// um quarto dos triângulos do anterior encerra a lista.
+//
+// Na hora do desenho, submitMesh() escolhe o nível pelo tamanho projetado
+// do objeto na tela (ver selectLod).
+// ============================================================================
+static const size_t MIN_LOD_TRIANGLES = 256;
+
+// Cantos (locais ao objeto, 3 por triângulo, na numeração 3t+k do .obj)
+// de cada nível simplificado
+static void buildMeshLods(const ObjModel* model, size_t shape, std::vector< std::vector<unsigned int> >& lods)
+{
+    lods.clear();
+
+    const tinyobj::mesh_t& mesh = model->shapes[shape].mesh;
+    size_t num_triangles = mesh.num_face_vertices.size();
+    if (num_triangles < MIN_LOD_TRIANGLES)
+        return;
+
+    size_t num_positions = model->attrib.vertices.size() / 3;
+    std::vector<glm::vec3> positions(num_positions);
+    for (size_t p = 0; p < num_positions; ++p)
+        positions[p] = glm::make_vec3(&model->attrib.vertices[3*p]);
+
+    // Posição de cada canto e costuras: a primeira (normal, textura) vista
+    // em cada posição; outra combinação na mesma posição trava a posição
+    std::vector<int> cornerPosition(3 * num_triangles);
+    std::vector<bool> locked(num_positions, false);
+    std::vector< std::pair<int, int> > firstWedge(num_positions, std::make_pair(-2, -2));
+    for (size_t c = 0; c < cornerPosition.size(); ++c)
+    {
+        const tinyobj::index_t& idx = mesh.indices[c];
+        cornerPosition[c] = idx.vertex_index;
+
+        std::pair<int, int> wedge(idx.normal_index, idx.texcoord_index);
+        if (firstWedge[idx.vertex_index].first == -2)
+            firstWedge[idx.vertex_index] = wedge;
+        else if (firstWedge[idx.vertex_index] != wedge)
+            locked[idx.vertex_index] = true;
+    }
+
+    std::vector<size_t> targets;
+    for (int level = 1; level < MAX_MESH_LODS; ++level)
+        targets.push_back(num_triangles >> level);
+
+    std::vector< std::vector<unsigned int> > levels;
+    SimplifyMesh(positions, cornerPosition, locked, targets, levels);
+
+    size_t previous = 3 * num_triangles;
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        if (levels[level].empty() || 4 * levels[level].size() > 3 * previous)
+            break;
+        previous = levels[level].size();
+        lods.push_back(levels[level]);
+    }
+
+    printf("- LODs de '%s': %zu", model->shapes[shape].name.c_str(), num_triangles);
+    for (size_t level = 0; level < lods.size(); ++level)
+        printf(" -> %zu", lods[level].size() / 3);
+    printf(" triângulos\n");
+}
+
+// ============================================================================
+// CARREGAMENTO DE MODELOS
+// ============================================================================
+// O .obj só é lido quando o cache binário ao lado dele (ver MeshCache.h)
+// não existe ou é de outra versão do arquivo. Os dois caminhos terminam em
+// uploadMesh(), com os dados já no formato final dos buffers; tudo antes
+// dele roda num worker do AssetLoader.
+// ============================================================================
+static_assert(MAX_MESH_LODS == MESH_CACHE_MAX_LODS, "MeshSubmesh guarda MAX_MESH_LODS níveis");
+
+// Roda num worker: não usa o GL nem o estado do Renderer. A view aponta
+// para o cache mapeado ou para load.mesh
+void Renderer::prepareObjModel(MeshLoad& load)
 {
-    GLuint vertex_array_object_id;
-    glGenVertexArrays(1, &vertex_array_object_id);
-    glBindVertexArray(vertex_array_object_id);
+    const char* filename = load.filename.c_str();
+
+    MappedFile source;
+    if (!source.open(filename))
+    {
+        fprintf(stderr, "ERROR: Cannot open \"%s\".\n", filename);
+        throw std::runtime_error("Erro ao carregar modelo.");
+    }
+    uint64_t hash = HashBytes(source.data(), source.size());
+    source.close();
+
+    std::string cachePath = load.filename + ".mesh";
+
+    if (load.cache.open(cachePath.c_str()) && ReadMeshCache(load.cache, hash, load.view))
+    {
+        printf("Carregando malhas do cache \"%s\"...\n", cachePath.c_str());
+        return;
+    }
+    load.cache.close();
+
+    {
+        ObjModel model(filename);
+        computeNormals(&model);
+        buildTrianglesFromObj(&model, load.mesh);
+    }
 
-    std::vector<GLuint> indices;
-    std::vector<float>  model_coefficients;
-    std::vector<float>  normal_coefficients;
-    std::vector<float>  texture_coefficients;
+    if (WriteMeshCache(cachePath.c_str(), hash, load.mesh))
+        printf("- Cache gravado em \"%s\"\n", cachePath.c_str());
+
+    ViewMeshData(load.mesh, load.packed, load.view);
+}
 
+void Renderer::buildTrianglesFromObj(ObjModel* model, MeshData& meshData)
+{
     for (size_t shape = 0; shape < model->shapes.size(); ++shape)
     {
-        size_t first_index = indices.size();
-        size_t num_triangles = model->shapes[shape].mesh.num_face_vertices.size();
+        const tinyobj::mesh_t& mesh = model->shapes[shape].mesh;
+        size_t first_vertex = meshData.vertices.size();
+        size_t num_triangles = mesh.num_face_vertices.size();
 
-        const float minval = std::numeric_limits<float>::min();
-        const float maxval = std::numeric_limits<float>::max();
+        if (model->shapes[shape].name.size() >= MESH_CACHE_NAME_SIZE)
+        {
+            fprintf(stderr, "ERROR: Object name '%s' is too long.\n", model->shapes[shape].name.c_str());
+            throw std::runtime_error("Nome de objeto muito longo.");
+        }
 
-        glm::vec3 bbox_min = glm::vec3(maxval,maxval,maxval);
-        glm::vec3 bbox_max = glm::vec3(minval,minval,minval);
+        // Solda: cantos com a mesma (posição, normal, textura) do .obj viram
+        // um único vértice
+        std::map< std::pair<int, std::pair<int, int> >, unsigned int> vertex_by_wedge;
+        std::vector<tinyobj::index_t> wedges;
+        std::vector<unsigned int> corner_vertex(3 * num_triangles);
 
         for (size_t triangle = 0; triangle < num_triangles; ++triangle)
         {
-            assert(model->shapes[shape].mesh.num_face_vertices[triangle] == 3);
+            assert(mesh.num_face_vertices[triangle] == 3);
 
             for (size_t vertex = 0; vertex < 3; ++vertex)
             {
-                tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
+                tinyobj::index_t idx = mesh.indices[3*triangle + vertex];
+                std::pair<int, std::pair<int, int> > wedge(idx.vertex_index, std::make_pair(idx.normal_index, idx.texcoord_index));
 
-                indices.push_back(first_index + 3*triangle + vertex);
+                std::map< std::pair<int, std::pair<int, int> >, unsigned int>::iterator it = vertex_by_wedge.find(wedge);
+                if (it == vertex_by_wedge.end())
+                {
+                    it = vertex_by_wedge.insert(std::make_pair(wedge, (unsigned int)wedges.size())).first;
+                    wedges.push_back(idx);
+                }
+                corner_vertex[3*triangle + vertex] = it->second;
+            }
+        }
 
-                const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
-                const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
-                const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
-                model_coefficients.push_back( vx );
-                model_coefficients.push_back( vy );
-                model_coefficients.push_back( vz );
-                model_coefficients.push_back( 1.0f );
+        // Nível 0 e níveis simplificados, em índices locais ao objeto
+        std::vector< std::vector<unsigned int> > levels(1, corner_vertex);
+        float acmr_welded = ComputeACMR(levels[0], wedges.size());
 
-                bbox_min.x = std::min(bbox_min.x, vx);
-                bbox_min.y = std::min(bbox_min.y, vy);
-                bbox_min.z = std::min(bbox_min.z, vz);
-                bbox_max.x = std::max(bbox_max.x, vx);
-                bbox_max.y = std::max(bbox_max.y, vy);
-                bbox_max.z = std::max(bbox_max.z, vz);
+        std::vector< std::vector<unsigned int> > lods;
+        buildMeshLods(model, shape, lods);
+        for (size_t level = 0; level < lods.size(); ++level)
+        {
+            levels.push_back(lods[level]);
+            for (size_t c = 0; c < levels.back().size(); ++c)
+                levels.back()[c] = corner_vertex[levels.back()[c]];
+        }
 
+        for (size_t level = 0; level < levels.size(); ++level)
+            OptimizeVertexCache(levels[level], wedges.size());
+        float acmr_optimized = ComputeACMR(levels[0], wedges.size());
 
-                if ( idx.normal_index != -1 )
-                {
-                    const float nx = model->attrib.normals[3*idx.normal_index + 0];
-                    const float ny = model->attrib.normals[3*idx.normal_index + 1];
-                    const float nz = model->attrib.normals[3*idx.normal_index + 2];
-                    normal_coefficients.push_back( nx );
-                    normal_coefficients.push_back( ny );
-                    normal_coefficients.push_back( nz );
-                    normal_coefficients.push_back( 0.0f );
-                }
+        // Os vértices seguem a ordem de uso do nível 0; os simplificados só
+        // usam vértices que o nível 0 também usa
+        std::vector<unsigned int> remap;
+        OptimizeVertexFetch(levels[0], wedges.size(), remap);
+        for (size_t level = 1; level < levels.size(); ++level)
+            for (size_t i = 0; i < levels[level].size(); ++i)
+                levels[level][i] = remap[levels[level][i]];
 
-                if ( idx.texcoord_index != -1 )
-                {
-                    const float u = model->attrib.texcoords[2*idx.texcoord_index + 0];
-                    const float v = model->attrib.texcoords[2*idx.texcoord_index + 1];
-                    texture_coefficients.push_back( u );
-                    texture_coefficients.push_back( v );
-                }
+        std::vector<tinyobj::index_t> ordered(wedges.size());
+        for (size_t v = 0; v < wedges.size(); ++v)
+            ordered[remap[v]] = wedges[v];
+
+        const float minval = std::numeric_limits<float>::min();
+        const float maxval = std::numeric_limits<float>::max();
+
+        glm::vec3 bbox_min = glm::vec3(maxval,maxval,maxval);
+        glm::vec3 bbox_max = glm::vec3(minval,minval,minval);
+
+        // Sem normal ou coordenada de textura, o vértice leva zeros: o mesmo
+        // valor que o shader lia com o atributo desligado
+        for (size_t v = 0; v < ordered.size(); ++v)
+        {
+            const tinyobj::index_t& idx = ordered[v];
+            MeshVertex vertex;
+            memset(&vertex, 0, sizeof(vertex));
+
+            const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
+            const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
+            const float vz = model->attrib.vertices[3*idx.vertex_index + 2];
+            vertex.position[0] = vx;
+            vertex.position[1] = vy;
+            vertex.position[2] = vz;
+
+            bbox_min.x = std::min(bbox_min.x, vx);
+            bbox_min.y = std::min(bbox_min.y, vy);
+            bbox_min.z = std::min(bbox_min.z, vz);
+            bbox_max.x = std::max(bbox_max.x, vx);
+            bbox_max.y = std::max(bbox_max.y, vy);
+            bbox_max.z = std::max(bbox_max.z, vz);
+
+            if ( idx.normal_index != -1 )
+            {
+                vertex.normal[0] = model->attrib.normals[3*idx.normal_index + 0];
+                vertex.normal[1] = model->attrib.normals[3*idx.normal_index + 1];
+                vertex.normal[2] = model->attrib.normals[3*idx.normal_index + 2];
             }
+
+            if ( idx.texcoord_index != -1 )
+            {
+                vertex.texcoord[0] = model->attrib.texcoords[2*idx.texcoord_index + 0];
+                vertex.texcoord[1] = model->attrib.texcoords[2*idx.texcoord_index + 1];
+            }
+
+            meshData.vertices.push_back(vertex);
         }
 
-        size_t last_index = indices.size() - 1;
+        MeshSubmesh submesh;
+        memset(&submesh, 0, sizeof(submesh));
+        // O nome cabe (nomes longos são recusados acima) e o terminador
+        // vem do memset
+        const std::string& name = model->shapes[shape].name;
+        memcpy(submesh.name, name.c_str(), name.size());
+        for (int k = 0; k < 3; ++k)
+        {
+            submesh.bboxMin[k] = bbox_min[k];
+            submesh.bboxMax[k] = bbox_max[k];
+        }
+
+        // Cada nível é um trecho do buffer de índices, logo após o anterior
+        submesh.numLods = (uint32_t)levels.size();
+        for (size_t level = 0; level < levels.size(); ++level)
+        {
+            submesh.lodFirstIndex[level] = (uint32_t)meshData.indices.size();
+            submesh.lodNumIndices[level] = (uint32_t)levels[level].size();
+            for (size_t i = 0; i < levels[level].size(); ++i)
+                meshData.indices.push_back((uint32_t)(first_vertex + levels[level][i]));
+        }
+
+        printf("- Vértices de '%s': %zu -> %zu, ACMR 3.00 -> %.2f (soldados) -> %.2f (Forsyth)\n",
+               submesh.name, 3 * num_triangles, ordered.size(), acmr_welded, acmr_optimized);
+
+        meshData.submeshes.push_back(submesh);
+    }
+}
+
+// Um VAO por modelo, com os vértices intercalados num único VBO
+void Renderer::uploadMesh(const MeshView& mesh)
+{
+    GLuint vertex_array_object_id;
+    glGenVertexArrays(1, &vertex_array_object_id);
+    glBindVertexArray(vertex_array_object_id);
+    enableInstanceAttributes();
+
+    GLuint VBO_vertices_id;
+    glGenBuffers(1, &VBO_vertices_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_vertices_id);
+    glBufferData(GL_ARRAY_BUFFER, mesh.vertexCount * sizeof(MeshVertex), mesh.vertices, GL_STATIC_DRAW);
+
+    // Posições e normais vão com 3 componentes: o w que falta é
+    // completado com 1 pelo GL, e o shader só usa o xyz da normal
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(MeshVertex), (void*)offsetof(MeshVertex, texcoord));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLuint indices_id;
+    glGenBuffers(1, &indices_id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)mesh.indexCount * mesh.indexSize, mesh.indices, GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    GLenum index_type = mesh.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    printf("- %u vértices, índices de %u bits\n", mesh.vertexCount, 8 * mesh.indexSize);
+
+    for (uint32_t i = 0; i < mesh.submeshCount; ++i)
+    {
+        const MeshSubmesh& submesh = mesh.submeshes[i];
 
         SceneObject theobject;
-        theobject.name           = model->shapes[shape].name;
-        theobject.first_index    = first_index;
-        theobject.num_indices    = last_index - first_index + 1;
+        theobject.name           = submesh.name;
+        theobject.first_index    = submesh.lodFirstIndex[0];
+        theobject.num_indices    = submesh.lodNumIndices[0];
         theobject.rendering_mode = GL_TRIANGLES;
+        theobject.index_type     = index_type;
         theobject.vertex_array_object_id = vertex_array_object_id;
 
-        theobject.bbox_min = bbox_min;
-        theobject.bbox_max = bbox_max;
+        theobject.bbox_min = glm::make_vec3(submesh.bboxMin);
+        theobject.bbox_max = glm::make_vec3(submesh.bboxMax);
 
-        m_virtualScene[model->shapes[shape].name] = theobject;
+        theobject.num_lods = (int)submesh.numLods;
+        for (uint32_t level = 0; level < submesh.numLods; ++level)
+        {
+            theobject.lod_first_index[level] = submesh.lodFirstIndex[level];
+            theobject.lod_num_indices[level] = submesh.lodNumIndices[level];
+        }
+
+        addMesh(theobject.name, theobject);
     }
+}
 
-    GLuint VBO_model_coefficients_id;
-    glGenBuffers(1, &VBO_model_coefficients_id);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
-    glBufferData(GL_ARRAY_BUFFER, model_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, model_coefficients.size() * sizeof(float), model_coefficients.data());
-    GLuint location = 0;
-    GLint  number_of_dimensions = 4;
-    glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(location);
+// ============================================================================
+// TABELA DE MODELOS
+// ============================================================================
+// Cada SceneObject ganha um índice fixo (MeshHandle) em m_meshes quando é
+// carregado. Um nome repetido substitui o objeto anterior no mesmo índice.
+// Os modelos usados pelo jogo são resolvidos uma vez em resolveMeshHandles();
+// a partir daí os desenhos só indexam o vetor.
+// ============================================================================
+MeshHandle Renderer::addMesh(const std::string& key, const SceneObject& object)
+{
+    std::map<std::string, MeshHandle>::iterator it = m_meshByName.find(key);
+    if (it != m_meshByName.end())
+    {
+        m_meshes[it->second] = object;
+        return it->second;
+    }
+
+    MeshHandle mesh = (MeshHandle)m_meshes.size();
+    m_meshes.push_back(object);
+    m_meshByName[key] = mesh;
+    return mesh;
+}
+
+MeshHandle Renderer::findMesh(const std::string& key) const
+{
+    std::map<std::string, MeshHandle>::const_iterator it = m_meshByName.find(key);
+    return it != m_meshByName.end() ? it->second : INVALID_MESH;
+}
+
+void Renderer::resolveMeshHandles()
+{
+    m_meshMonster    = findMesh("turle");
+    m_meshArcher     = findMesh("Arqueira");
+    m_meshWand       = findMesh("Varinha");
+    m_meshDragon     = findMesh("Mesh1.001");
+    m_meshHealth     = findMesh("vida");
+    m_meshProjectile = findMesh("Sphere");
+}
+
+// ============================================================================
+// UNIFORMS POR QUADRO
+// ============================================================================
+// Os dois blocos ficam no mesmo buffer, o das tochas alinhado a
+// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. Os binding points são fixos: todo
+// programa criado por createGpuProgram() liga os blocos que declara a eles.
+// ============================================================================
+void Renderer::initFrameUniforms()
+{
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    m_torchBlockOffset = (GLintptr)((sizeof(CameraUniforms) + alignment - 1) / alignment * alignment);
+    m_frameUniformData.assign(m_torchBlockOffset + sizeof(TorchUniforms), 0);
+
+    m_cameraUniforms.view = Matrix_Identity();
+    m_cameraUniforms.projection = Matrix_Identity();
+    m_cameraUniforms.cameraPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    glGenBuffers(1, &m_frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, m_frameUniformData.size(), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, m_frameUBO, 0, sizeof(CameraUniforms));
+    glBindBufferRange(GL_UNIFORM_BUFFER, TORCH_BLOCK_BINDING, m_frameUBO, m_torchBlockOffset, sizeof(TorchUniforms));
+}
+
+// Uma escrita por quadro, com a câmera e as tochas já atualizadas por
+// setView/setProjection e updateTorchLights
+void Renderer::uploadFrameUniforms()
+{
+    memcpy(&m_frameUniformData[0], &m_cameraUniforms, sizeof(CameraUniforms));
+    memcpy(&m_frameUniformData[m_torchBlockOffset], &m_torchUniforms, sizeof(TorchUniforms));
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, m_frameUniformData.size(), m_frameUniformData.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// ============================================================================
+// FILA DE RENDERIZAÇÃO
+// ============================================================================
+// Os render* só submetem pacotes; flushRenderQueue() os ordena e emite (ver
+// RenderQueue.h). Corridas de pacotes do mesmo modelo com pelo menos
+// MIN_INSTANCED_RUN elementos viram uma chamada instanciada: as matrizes
+// de todas as corridas do quadro vão num único upload para
+// m_instanceVBO, e os atributos de instância do VAO apontam para o trecho
+// de cada corrida. Todo VAO de modelo (cubo e OBJs) tem esses atributos.
+// ============================================================================
+static const size_t MIN_INSTANCED_RUN = 4;
+
+void Renderer::initInstancing()
+{
+    glGenBuffers(1, &m_instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+
+    // Nunca vazio: desenhos não instanciados de um VAO com os atributos de
+    // instância ligados ainda leem a instância 0
+    m_instanceCapacity = 64;
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Atributos de instância: matriz modelo (3..6), camada da textura (7) e
+// matriz das normais (10..12)
+static const GLuint INSTANCE_ATTRIBUTES[] = { 3, 4, 5, 6, 7, 10, 11, 12 };
 
-    if ( !normal_coefficients.empty() )
+// Liga os atributos de instância no VAO atualmente ligado
+void Renderer::enableInstanceAttributes()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    pointInstanceAttributes(0);
+    for (size_t i = 0; i < sizeof(INSTANCE_ATTRIBUTES) / sizeof(INSTANCE_ATTRIBUTES[0]); i++)
     {
-        GLuint VBO_normal_coefficients_id;
-        glGenBuffers(1, &VBO_normal_coefficients_id);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_normal_coefficients_id);
-        glBufferData(GL_ARRAY_BUFFER, normal_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, normal_coefficients.size() * sizeof(float), normal_coefficients.data());
-        location = 1;
-        number_of_dimensions = 4;
-        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(location);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glEnableVertexAttribArray(INSTANCE_ATTRIBUTES[i]);
+        glVertexAttribDivisor(INSTANCE_ATTRIBUTES[i], 1);
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Aponta os atributos de instância do VAO ligado para m_instanceVBO, a
+// partir da instância 'firstInstance'
+void Renderer::pointInstanceAttributes(size_t firstInstance)
+{
+    size_t base = firstInstance * sizeof(InstanceData);
 
-    if ( !texture_coefficients.empty() )
+    // mat4 = 4 atributos vec4 consecutivos (uma coluna cada)
+    for (GLuint column = 0; column < 4; column++)
     {
-        GLuint VBO_texture_coefficients_id;
-        glGenBuffers(1, &VBO_texture_coefficients_id);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_texture_coefficients_id);
-        glBufferData(GL_ARRAY_BUFFER, texture_coefficients.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, texture_coefficients.size() * sizeof(float), texture_coefficients.data());
-        location = 2;
-        number_of_dimensions = 2;
-        glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-        glEnableVertexAttribArray(location);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
     }
-    GLuint indices_id;
-    glGenBuffers(1, &indices_id);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
-    glBindVertexArray(0);
+    // mat3 = 3 atributos vec3
+    for (GLuint column = 0; column < 3; column++)
+    {
+        glVertexAttribPointer(10 + column, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, normalMatrix) + column * sizeof(glm::vec3)));
+    }
+    glVertexAttribPointer(7, 1, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(base + offsetof(InstanceData, layer)));
 }
 
-void Renderer::drawVirtualObject(const std::string& object_name)
+// Matriz das normais: inversa transposta da parte linear da matriz modelo
+static glm::mat3 NormalMatrix(const glm::mat4& model)
 {
-    glBindVertexArray(m_virtualScene[object_name].vertex_array_object_id);
-    glm::vec3 bbox_min = m_virtualScene[object_name].bbox_min;
-    glm::vec3 bbox_max = m_virtualScene[object_name].bbox_max;
-    glUniform4f(m_bbox_min_uniform, bbox_min.x, bbox_min.y, bbox_min.z, 1.0f);
-    glUniform4f(m_bbox_max_uniform, bbox_max.x, bbox_max.y, bbox_max.z, 1.0f);
-    glDrawElements(
-        m_virtualScene[object_name].rendering_mode,
-        m_virtualScene[object_name].num_indices,
-        GL_UNSIGNED_INT,
-        (void*)(m_virtualScene[object_name].first_index * sizeof(GLuint))
-    );
-    glBindVertexArray(0);
+    return glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+// ============================================================================
+// FRUSTUM CULLING
+// ============================================================================
+// Cada pacote é testado antes de entrar na fila: a caixa do modelo vai ao
+// mundo (transformAABB) e é comparada com os seis planos do frustum
+// (testAABBFrustum). Os trechos do lote estático têm a AABB calculada uma
+// vez, em buildStaticBatch(). Os contadores vão para RenderStats no flush.
+// ============================================================================
+void Renderer::updateFrustum()
+{
+    extractFrustumPlanes(m_currentProjection * m_currentView, m_frustumPlanes);
+}
+
+bool Renderer::isVisible(const glm::vec3& worldMin, const glm::vec3& worldMax)
+{
+    if (!testAABBFrustum(worldMin, worldMax, m_frustumPlanes))
+    {
+        m_culledObjects++;
+        return false;
+    }
+    m_visibleObjects++;
+    return true;
+}
+
+// Escolhe o nível pelo tamanho projetado: o raio da AABB no mundo dividido
+// pela distância à câmera, escalado pelo foco vertical da projeção, é a
+// fração da altura da tela que o objeto ocupa (aproximadamente)
+static const float LOD_SCREEN_SIZE[MAX_MESH_LODS - 1] = { 0.25f, 0.12f, 0.06f };
+
+int Renderer::selectLod(const SceneObject& object, const glm::vec3& worldMin, const glm::vec3& worldMax) const
+{
+    if (object.num_lods <= 1)
+        return 0;
+
+    glm::vec3 center = 0.5f * (worldMin + worldMax);
+    float radius = 0.5f * glm::length(worldMax - worldMin);
+    float distance = glm::length(center - glm::vec3(m_cameraUniforms.cameraPosition));
+    if (distance <= radius)
+        return 0;
+
+    float screenSize = radius * fabsf(m_currentProjection[1][1]) / distance;
+
+    int lod = 0;
+    while (lod + 1 < object.num_lods && screenSize < LOD_SCREEN_SIZE[lod])
+        lod++;
+    return lod;
+}
+
+float Renderer::distanceToCamera(const glm::mat4& model) const
+{
+    glm::vec4 offset = model[3] - m_cameraUniforms.cameraPosition;
+    return sqrtf(offset.x*offset.x + offset.y*offset.y + offset.z*offset.z);
+}
+
+void Renderer::submitMesh(RenderPass pass, MeshHandle mesh, int objectId, const glm::mat4& model)
+{
+    int permutation = permutationOf(objectId);
+    if (mesh == INVALID_MESH || permutation < 0)
+        return;
+
+    const SceneObject& object = m_meshes[mesh];
+
+    glm::vec3 worldMin, worldMax;
+    transformAABB(model, object.bbox_min, object.bbox_max, worldMin, worldMax);
+    if (!isVisible(worldMin, worldMax))
+        return;
+
+    GLuint program = m_permutations[permutation].program;
+    int lod = selectLod(object, worldMin, worldMax);
+
+    DrawPacket packet;
+    packet.key = RenderQueue::makeKey(pass, program, object.vertex_array_object_id, lod, distanceToCamera(model));
+    packet.program = program;
+    packet.vao = object.vertex_array_object_id;
+    packet.mode = object.rendering_mode;
+    packet.count = (GLsizei)object.lod_num_indices[lod];
+    packet.first = (GLsizei)object.lod_first_index[lod];
+    packet.indexType = object.index_type;
+    packet.indexed = true;
+    packet.staticBatch = false;
+    packet.instanceable = true;
+    packet.permutation = permutation;
+    packet.layer = m_materialLayer[objectId];
+    packet.bboxMin = object.bbox_min;
+    packet.bboxMax = object.bbox_max;
+    packet.model = model;
+    m_renderQueue.submit(packet);
+}
+
+void Renderer::submitCube(RenderPass pass, int objectId, const glm::mat4& model)
+{
+    int permutation = permutationOf(objectId);
+    if (permutation < 0)
+        return;
+
+    glm::vec3 worldMin, worldMax;
+    transformAABB(model, glm::vec3(-0.1f, -0.1f, -0.1f), glm::vec3(0.1f, 0.1f, 0.1f), worldMin, worldMax);
+    if (!isVisible(worldMin, worldMax))
+        return;
+
+    GLuint program = m_permutations[permutation].program;
+
+    DrawPacket packet;
+    packet.key = RenderQueue::makeKey(pass, program, m_vertexArrayObjectID, 0, distanceToCamera(model));
+    packet.program = program;
+    packet.vao = m_vertexArrayObjectID;
+    packet.mode = GL_TRIANGLES;
+    packet.count = 36;
+    packet.first = 0;
+    packet.indexType = GL_UNSIGNED_INT;
+    packet.indexed = true;
+    packet.staticBatch = false;
+    packet.instanceable = true;
+    packet.permutation = permutation;
+    packet.layer = m_materialLayer[objectId];
+    packet.bboxMin = glm::vec3(-0.1f, -0.1f, -0.1f);
+    packet.bboxMax = glm::vec3(0.1f, 0.1f, 0.1f);
+    packet.model = model;
+    m_renderQueue.submit(packet);
+}
+
+// Objetos do lote estático (ver buildStaticBatch): cada um é testado
+// contra o frustum, e os visíveis vizinhos no VBO com a mesma permutação
+// são juntados num só pacote
+void Renderer::submitStaticBatch(RenderPass pass, const std::vector<StaticBatchRange>& ranges)
+{
+    StaticBatchRange merged;
+    bool pending = false;
+    for (size_t i = 0; i < ranges.size(); i++)
+    {
+        const StaticBatchRange& range = ranges[i];
+        if (range.permutation < 0 || !isVisible(range.bboxMin, range.bboxMax))
+            continue;
+
+        if (pending && merged.permutation == range.permutation && merged.first + merged.count == range.first)
+        {
+            merged.count += range.count;
+            continue;
+        }
+        if (pending)
+            submitStaticRange(pass, merged);
+        merged = range;
+        pending = true;
+    }
+    if (pending)
+        submitStaticRange(pass, merged);
+}
+
+void Renderer::submitStaticRange(RenderPass pass, const StaticBatchRange& range)
+{
+    GLuint program = m_permutations[range.permutation].program;
+
+    DrawPacket packet;
+    packet.key = RenderQueue::makeKey(pass, program, m_staticBatchVAO, 0, 0.0f);
+    packet.program = program;
+    packet.vao = m_staticBatchVAO;
+    packet.mode = GL_TRIANGLES;
+    packet.count = range.count;
+    packet.first = range.first;
+    packet.indexType = GL_UNSIGNED_INT;
+    packet.indexed = false;
+    packet.staticBatch = true;
+    packet.instanceable = false;
+    packet.permutation = range.permutation;
+    packet.layer = 0.0f;  // por vértice
+    packet.bboxMin = glm::vec3(-0.1f, -0.1f, -0.1f);
+    packet.bboxMax = glm::vec3(0.1f, 0.1f, 0.1f);
+    packet.model = Matrix_Identity();
+    m_renderQueue.submit(packet);
+}
+
+// Deslocamento em bytes do primeiro índice do pacote no buffer de índices
+static const void* indexOffset(const DrawPacket& packet)
+{
+    size_t size = packet.indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    return (const void*)(packet.first * size);
+}
+
+// Dois pacotes vizinhos podem sair na mesma chamada instanciada? A
+// camada da textura vai por instância: o material pode mudar
+static bool sameRun(const DrawPacket& a, const DrawPacket& b)
+{
+    return RenderQueue::passOf(a.key) == RenderQueue::passOf(b.key)
+        && a.program == b.program && a.vao == b.vao
+        && a.mode == b.mode && a.first == b.first && a.count == b.count
+        && a.indexed == b.indexed && a.staticBatch == b.staticBatch
+        && a.bboxMin == b.bboxMin && a.bboxMax == b.bboxMax;
+}
+
+void Renderer::flushRenderQueue()
+{
+    m_frameStats = RenderStats();
+    m_frameStats.packets = (unsigned)m_renderQueue.size();
+    m_frameStats.visibleObjects = m_visibleObjects;
+    m_frameStats.culledObjects = m_culledObjects;
+    m_visibleObjects = 0;
+    m_culledObjects = 0;
+
+    // O texto e o HUD mexem no GL por fora do cache
+    m_stateCache.invalidate();
+    m_stateCache.setStats(&m_frameStats);
+
+    uploadFrameUniforms();
+    m_stateCache.countCall(2);
+
+    m_renderQueue.sort();
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Corridas e dados de instância do quadro inteiro
+    // ─────────────────────────────────────────────────────────────────────────
+    m_renderRuns.clear();
+    m_instances.clear();
+    for (size_t begin = 0; begin < m_renderQueue.size(); )
+    {
+        size_t end = begin + 1;
+        while (end < m_renderQueue.size() && sameRun(m_renderQueue[begin], m_renderQueue[end]))
+            end++;
+
+        RenderRun run;
+        run.begin = begin;
+        run.end = end;
+        run.instanced = m_renderQueue[begin].instanceable && end - begin >= MIN_INSTANCED_RUN;
+        run.firstInstance = m_instances.size();
+        if (run.instanced)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                InstanceData instance;
+                instance.model = m_renderQueue[i].model;
+                instance.normalMatrix = NormalMatrix(m_renderQueue[i].model);
+                instance.layer = m_renderQueue[i].layer;
+                m_instances.push_back(instance);
+            }
+        }
+        m_renderRuns.push_back(run);
+        begin = end;
+    }
+
+    if (!m_instances.empty())
+    {
+        if (m_instances.size() > m_instanceCapacity)
+        {
+            // Cresce em potências de 2 para não realocar a cada instância nova
+            while (m_instanceCapacity < m_instances.size())
+                m_instanceCapacity *= 2;
+        }
+        // "Orphaning": descarta o conteúdo do quadro anterior, para o driver não
+        // esperar a GPU terminar de lê-lo antes de aceitar os dados novos
+        m_stateCache.bindArrayBuffer(m_instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(InstanceData), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_instances.size() * sizeof(InstanceData), m_instances.data());
+        m_stateCache.countCall(2);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────
+    // Emissão, na ordem da chave
+    // ─────────────────────────────────────────────────────────────────────────
+    for (size_t r = 0; r < m_renderRuns.size(); r++)
+    {
+        const RenderRun& run = m_renderRuns[r];
+        const DrawPacket& first = m_renderQueue[run.begin];
+
+        RenderPass pass = RenderQueue::passOf(first.key);
+        m_stateCache.setCullFace(pass != PASS_OPAQUE_NO_CULL);
+        m_stateCache.setBlend(pass == PASS_ADDITIVE);
+        if (pass == PASS_ADDITIVE)
+            m_stateCache.setBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        m_stateCache.setDepthMask(pass != PASS_ADDITIVE);
+
+        // Uniforms que o programa não usa têm localização -1 e são ignorados
+        const ShaderPermutation& permutation = m_permutations[first.permutation];
+        m_stateCache.useProgram(first.program);
+        m_stateCache.bindVertexArray(first.vao);
+        if (permutation.bboxMinUniform >= 0)
+            m_stateCache.setUniform4f(GLStateCache::UNIFORM_BBOX_MIN, permutation.bboxMinUniform, first.bboxMin.x, first.bboxMin.y, first.bboxMin.z, 1.0f);
+        if (permutation.bboxMaxUniform >= 0)
+            m_stateCache.setUniform4f(GLStateCache::UNIFORM_BBOX_MAX, permutation.bboxMaxUniform, first.bboxMax.x, first.bboxMax.y, first.bboxMax.z, 1.0f);
+        if (!first.staticBatch)
+            m_stateCache.setUniform1i(GLStateCache::UNIFORM_USE_INSTANCING, permutation.useInstancingUniform, run.instanced ? 1 : 0);
+
+        if (run.instanced)
+        {
+            m_stateCache.bindArrayBuffer(m_instanceVBO);
+            pointInstanceAttributes(run.firstInstance);
+            glDrawElementsInstanced(first.mode, first.count, first.indexType,
+                                    indexOffset(first), (GLsizei)(run.end - run.begin));
+            m_stateCache.countCall(8 + 1);
+            if (first.mode == GL_TRIANGLES)
+                m_frameStats.triangles += (unsigned)(first.count / 3) * (unsigned)(run.end - run.begin);
+            m_frameStats.drawCalls++;
+            m_frameStats.instancedDraws++;
+            continue;
+        }
+
+        for (size_t i = run.begin; i < run.end; i++)
+        {
+            const DrawPacket& packet = m_renderQueue[i];
+
+            // No lote estático os vértices já estão no mundo e trazem a camada
+            if (!packet.staticBatch)
+            {
+                glUniformMatrix4fv(permutation.modelUniform, 1, GL_FALSE, glm::value_ptr(packet.model));
+                glUniformMatrix3fv(permutation.normalMatrixUniform, 1, GL_FALSE, glm::value_ptr(NormalMatrix(packet.model)));
+                m_stateCache.countCall(2);
+                if (permutation.materialLayerUniform >= 0)
+                    m_stateCache.setUniform1f(GLStateCache::UNIFORM_MATERIAL_LAYER, permutation.materialLayerUniform, packet.layer);
+            }
+
+            if (packet.indexed)
+                glDrawElements(packet.mode, packet.count, packet.indexType, indexOffset(packet));
+            else
+                glDrawArrays(packet.mode, packet.first, packet.count);
+            m_stateCache.countCall();
+            if (packet.mode == GL_TRIANGLES)
+                m_frameStats.triangles += (unsigned)(packet.count / 3);
+            m_frameStats.drawCalls++;
+        }
+    }
+
+    // Estado padrão para o texto e o HUD
+    m_stateCache.bindVertexArray(0);
+    m_stateCache.setCullFace(true);
+    m_stateCache.setBlend(false);
+    m_stateCache.setDepthMask(true);
+
+    m_renderQueue.clear();
 }
@@ -0,0 +1,118 @@
+// ============================================================================
+// SPATIALGRID.CPP - Grade Uniforme para a Broad Phase das Colisões
+// ============================================================================
+//
+// Os testes de colisão do Game (projéteis x inimigos, inimigos x pilares,
+// jogador x inimigos) consultam a grade antes do teste exato, de modo que o
+// custo depende do número de objetos próximos e não do produto
+// projéteis x inimigos.
+//
+// ============================================================================
+
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid()
+    : m_minX(0.0f)
+    , m_minZ(0.0f)
+    , m_inverseCellSize(1.0f)
+    , m_cellsX(1)
+    , m_cellsZ(1)
+    , m_hasMultiCellObjects(false)
+{
+}
+
+void SpatialGrid::init(float minX, float minZ, float maxX, float maxZ, float cellSize)
+{
+    m_minX = minX;
+    m_minZ = minZ;
+    m_inverseCellSize = 1.0f / cellSize;
+    m_cellsX = std::max(1, (int)std::ceil((maxX - minX) * m_inverseCellSize));
+    m_cellsZ = std::max(1, (int)std::ceil((maxZ - minZ) * m_inverseCellSize));
+
+    m_cellStart.assign(m_cellsX * m_cellsZ + 1, 0);
+    clear();
+}
+
+int SpatialGrid::cellX(float x) const
+{
+    int cell = (int)std::floor((x - m_minX) * m_inverseCellSize);
+    return std::max(0, std::min(cell, m_cellsX - 1));
+}
+
+int SpatialGrid::cellZ(float z) const
+{
+    int cell = (int)std::floor((z - m_minZ) * m_inverseCellSize);
+    return std::max(0, std::min(cell, m_cellsZ - 1));
+}
+
+void SpatialGrid::clear()
+{
+    m_hasMultiCellObjects = false;
+    m_pending.clear();
+    m_cellEntries.clear();
+}
+
+void SpatialGrid::insert(int id, float minX, float minZ, float maxX, float maxZ)
+{
+    int x0 = cellX(minX), x1 = cellX(maxX);
+    int z0 = cellZ(minZ), z1 = cellZ(maxZ);
+
+    if (x0 != x1 || z0 != z1)
+        m_hasMultiCellObjects = true;
+
+    for (int z = z0; z <= z1; z++)
+        for (int x = x0; x <= x1; x++)
+            m_pending.push_back(std::make_pair(z * m_cellsX + x, id));
+}
+
+void SpatialGrid::build()
+{
+    m_cellEntries.clear();
+    if (m_pending.empty())
+        return;
+
+    const int cellCount = m_cellsX * m_cellsZ;
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+    // Conta os registros de cada célula e acumula em m_cellStart
+    for (size_t i = 0; i < m_pending.size(); i++)
+        m_cellStart[m_pending[i].first + 1]++;
+    for (int c = 0; c < cellCount; c++)
+        m_cellStart[c + 1] += m_cellStart[c];
+
+    // Distribui os ids; dentro de cada célula mantém a ordem de inserção
+    m_cellEntries.resize(m_pending.size());
+    m_cursor.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t i = 0; i < m_pending.size(); i++)
+        m_cellEntries[m_cursor[m_pending[i].first]++] = m_pending[i].second;
+}
+
+void SpatialGrid::query(float minX, float minZ, float maxX, float maxZ, std::vector<int>& out) const
+{
+    out.clear();
+    if (m_cellEntries.empty())
+        return;
+
+    int x0 = cellX(minX), x1 = cellX(maxX);
+    int z0 = cellZ(minZ), z1 = cellZ(maxZ);
+
+    for (int z = z0; z <= z1; z++)
+    {
+        for (int x = x0; x <= x1; x++)
+        {
+            int cell = z * m_cellsX + x;
+            out.insert(out.end(),
+                       m_cellEntries.begin() + m_cellStart[cell],
+                       m_cellEntries.begin() + m_cellStart[cell + 1]);
+        }
+    }
+
+    // Remove as repetições de objetos que ocupam mais de uma célula
+    if (m_hasMultiCellObjects && (x0 != x1 || z0 != z1))
+    {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
@@ -0,0 +1,592 @@
+// ============================================================================
+// TEXTUREBAKER.CPP - Mipmaps e Compressão BC1 Offline
+// ============================================================================
+//
+// Bloco BC1 (8 bytes):
+//
+//     uint16  c0, c1     cores extremas em RGB 5:6:5
+//     uint32  índices    2 bits por pixel, linha a linha
+//
+// Com c0 > c1 a paleta é {c0, c1, (2c0 + c1)/3, (c0 + 2c1)/3}. Com c0 <= c1
+// o bloco usa o modo de 3 cores com transparência, que o encoder só produz
+// quando c0 == c1 (bloco de uma cor só, todos os índices 0).
+//
+// ============================================================================
+
+#include "TextureBaker.h"
+#include <glad/glad.h>
+#include <stb_image.h>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+static const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+static const uint32_t KTX_ENDIANNESS = 0x04030201;
+static const char KEY_SOURCE_HASH[] = "FGCSourceHash";
+static const char KEY_BAKE_VERSION[] = "FGCBakeVersion";
+
+struct KtxHeader
+{
+    unsigned char identifier[12];
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+static size_t bc1Size(int width, int height)
+{
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * 8;
+}
+
+int TextureLevelCount(int size)
+{
+    int levels = 1;
+    for (; size > 1; size /= 2)
+        levels++;
+    return levels;
+}
+
+// ----------------------------------------------------------------------------
+// Leitura
+// ----------------------------------------------------------------------------
+bool ReadBakedTexture(const MappedFile& file, uint64_t sourceHash, int size, std::vector<BakedLevel>& levels)
+{
+    levels.clear();
+    if (file.data() == NULL || file.size() < sizeof(KtxHeader))
+        return false;
+
+    KtxHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.identifier, KTX_IDENTIFIER, 12) != 0
+        || header.endianness != KTX_ENDIANNESS
+        || header.glInternalFormat != GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+        || header.numberOfFaces != 1 || header.pixelDepth != 0
+        || header.pixelWidth != (uint32_t)size || header.pixelHeight != (uint32_t)size
+        || header.numberOfMipmapLevels != (uint32_t)TextureLevelCount(size))
+        return false;
+
+    const unsigned char* p = file.data() + sizeof(header);
+    const unsigned char* end = file.data() + file.size();
+    if (header.bytesOfKeyValueData > (size_t)(end - p))
+        return false;
+
+    // Pares chave/valor: uint32 tamanho, "chave\0valor\0", alinhado a 4
+    char expectedHash[32];
+    char expectedVersion[16];
+    snprintf(expectedHash, sizeof(expectedHash), "%016llx", (unsigned long long)sourceHash);
+    snprintf(expectedVersion, sizeof(expectedVersion), "%u", TEXTURE_BAKE_VERSION);
+    bool hashMatches = false;
+    bool versionMatches = false;
+
+    const unsigned char* keyValues = p;
+    const unsigned char* keyValuesEnd = p + header.bytesOfKeyValueData;
+    while (keyValues + 4 <= keyValuesEnd)
+    {
+        uint32_t size;
+        memcpy(&size, keyValues, 4);
+        const char* key = (const char*)keyValues + 4;
+        if (size > (size_t)(keyValuesEnd - keyValues - 4))
+            return false;
+
+        size_t keyLength = strnlen(key, size);
+        if (keyLength + 1 < size)
+        {
+            std::string value(key + keyLength + 1, strnlen(key + keyLength + 1, size - keyLength - 1));
+            if (strcmp(key, KEY_SOURCE_HASH) == 0)
+                hashMatches = value == expectedHash;
+            else if (strcmp(key, KEY_BAKE_VERSION) == 0)
+                versionMatches = value == expectedVersion;
+        }
+        keyValues += 4 + ((size + 3) & ~3u);
+    }
+    if (!hashMatches || !versionMatches)
+        return false;
+
+    p = keyValuesEnd;
+    int width = (int)header.pixelWidth;
+    int height = (int)header.pixelHeight;
+    for (uint32_t level = 0; level < header.numberOfMipmapLevels; level++)
+    {
+        uint32_t imageSize;
+        if (end - p < 4)
+            return false;
+        memcpy(&imageSize, p, 4);
+        p += 4;
+        if (imageSize != bc1Size(width, height) || imageSize > (size_t)(end - p))
+            return false;
+
+        BakedLevel baked;
+        baked.width = width;
+        baked.height = height;
+        baked.data = p;
+        baked.size = imageSize;
+        levels.push_back(baked);
+
+        p += (imageSize + 3) & ~3u;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Mipmaps em espaço linear
+// ----------------------------------------------------------------------------
+static float srgbToLinear(float c)
+{
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static unsigned char linearToSrgb(float c)
+{
+    c = c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+    int value = (int)(c * 255.0f + 0.5f);
+    return (unsigned char)std::min(255, std::max(0, value));
+}
+
+struct SrgbTable
+{
+    float linear[256];
+
+    SrgbTable()
+    {
+        for (int i = 0; i < 256; i++)
+            linear[i] = srgbToLinear(i / 255.0f);
+    }
+};
+
+// Redimensiona para size x size. Separável: primeiro as linhas, depois as
+// colunas. Cada pixel de destino é a média dos pixels de origem próximos ao
+// seu centro, com peso triangular de raio max(1, escala): interpolação
+// bilinear na ampliação, média da área coberta na redução
+static void resampleAxis(const float* src, int length, int stride, int count, int countStride,
+                         int size, float* dst, int dstStride, int dstCountStride)
+{
+    float scale = (float)length / (float)size;
+    float radius = std::max(1.0f, scale);
+
+    for (int i = 0; i < size; i++)
+    {
+        float center = (i + 0.5f) * scale - 0.5f;
+        int first = (int)floorf(center - radius) + 1;
+        int last = (int)floorf(center + radius);
+
+        for (int n = 0; n < count; n++)
+        {
+            float sum[3] = { 0.0f, 0.0f, 0.0f };
+            float weights = 0.0f;
+            for (int s = first; s <= last; s++)
+            {
+                float weight = 1.0f - fabsf(s - center) / radius;
+                if (weight <= 0.0f)
+                    continue;
+                // Repetição nas bordas, como o GL_REPEAT do sampler
+                int wrapped = ((s % length) + length) % length;
+                const float* p = src + (size_t)n * countStride + (size_t)wrapped * stride;
+                sum[0] += weight * p[0];
+                sum[1] += weight * p[1];
+                sum[2] += weight * p[2];
+                weights += weight;
+            }
+
+            float* out = dst + (size_t)n * dstCountStride + (size_t)i * dstStride;
+            out[0] = sum[0] / weights;
+            out[1] = sum[1] / weights;
+            out[2] = sum[2] / weights;
+        }
+    }
+}
+
+static void resample(const unsigned char* src, int width, int height, int size, std::vector<unsigned char>& dst)
+{
+    static const SrgbTable srgb;
+
+    std::vector<float> linear((size_t)width * height * 3);
+    for (size_t i = 0; i < linear.size(); i++)
+        linear[i] = srgb.linear[src[i]];
+
+    // Linhas: width -> size; colunas: height -> size
+    std::vector<float> rows((size_t)size * height * 3);
+    resampleAxis(&linear[0], width, 3, height, width * 3, size, &rows[0], 3, size * 3);
+    std::vector<float> result((size_t)size * size * 3);
+    resampleAxis(&rows[0], height, size * 3, size, 3, size, &result[0], size * 3, 3);
+
+    dst.resize(result.size());
+    for (size_t i = 0; i < result.size(); i++)
+        dst[i] = linearToSrgb(result[i]);
+}
+
+// Próximo nível: média dos 2x2 pixels (ou 2x1/1x2 quando a dimensão já é 1)
+static void downsample(const unsigned char* src, int width, int height, std::vector<unsigned char>& dst)
+{
+    // Inicialização de static local é segura entre threads (C++11)
+    static const SrgbTable srgb;
+    const float* table = srgb.linear;
+
+    int nextWidth = std::max(1, width / 2);
+    int nextHeight = std::max(1, height / 2);
+    dst.resize((size_t)nextWidth * nextHeight * 3);
+
+    for (int y = 0; y < nextHeight; y++)
+    {
+        int y0 = std::min(2*y, height - 1), y1 = std::min(2*y + 1, height - 1);
+        for (int x = 0; x < nextWidth; x++)
+        {
+            int x0 = std::min(2*x, width - 1), x1 = std::min(2*x + 1, width - 1);
+            for (int c = 0; c < 3; c++)
+            {
+                float sum = table[src[((size_t)y0*width + x0)*3 + c]] + table[src[((size_t)y0*width + x1)*3 + c]]
+                          + table[src[((size_t)y1*width + x0)*3 + c]] + table[src[((size_t)y1*width + x1)*3 + c]];
+                dst[((size_t)y*nextWidth + x)*3 + c] = linearToSrgb(0.25f * sum);
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// BC1
+// ----------------------------------------------------------------------------
+static uint16_t packColor565(const float color[3])
+{
+    int r = (int)(std::min(255.0f, std::max(0.0f, color[0])) * 31.0f / 255.0f + 0.5f);
+    int g = (int)(std::min(255.0f, std::max(0.0f, color[1])) * 63.0f / 255.0f + 0.5f);
+    int b = (int)(std::min(255.0f, std::max(0.0f, color[2])) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor565(uint16_t packed, int color[3])
+{
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static void bc1Palette(uint16_t c0, uint16_t c1, int palette[4][3])
+{
+    unpackColor565(c0, palette[0]);
+    unpackColor565(c1, palette[1]);
+    for (int k = 0; k < 3; k++)
+    {
+        if (c0 > c1)
+        {
+            palette[2][k] = (2*palette[0][k] + palette[1][k]) / 3;
+            palette[3][k] = (palette[0][k] + 2*palette[1][k]) / 3;
+        }
+        else
+        {
+            palette[2][k] = (palette[0][k] + palette[1][k]) / 2;
+            palette[3][k] = 0;
+        }
+    }
+}
+
+// Escolhe o índice mais próximo de cada pixel; retorna o erro quadrático
+static int bc1Indices(const int pixels[16][3], uint16_t c0, uint16_t c1, uint32_t& indices)
+{
+    int palette[4][3];
+    bc1Palette(c0, c1, palette);
+    int colors = c0 > c1 ? 4 : 3;
+
+    int error = 0;
+    indices = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int best = 0, bestError = 1 << 30;
+        for (int k = 0; k < colors; k++)
+        {
+            int dr = pixels[i][0] - palette[k][0];
+            int dg = pixels[i][1] - palette[k][1];
+            int db = pixels[i][2] - palette[k][2];
+            int e = dr*dr + dg*dg + db*db;
+            if (e < bestError)
+            {
+                bestError = e;
+                best = k;
+            }
+        }
+        error += bestError;
+        indices |= (uint32_t)best << (2*i);
+    }
+    return error;
+}
+
+// Ordena os extremos para o modo de 4 cores (c0 > c1)
+static void orderEndpoints(uint16_t& c0, uint16_t& c1)
+{
+    if (c0 < c1)
+        std::swap(c0, c1);
+}
+
+static void encodeBlock(const int pixels[16][3], unsigned char out[8])
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; i++)
+        for (int k = 0; k < 3; k++)
+            mean[k] += pixels[i][k] / 16.0f;
+
+    // Eixo principal: iteração de potência na matriz de covariância
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; i++)
+    {
+        float r = pixels[i][0] - mean[0], g = pixels[i][1] - mean[1], b = pixels[i][2] - mean[2];
+        cov[0] += r*r; cov[1] += r*g; cov[2] += r*b;
+        cov[3] += g*g; cov[4] += g*b; cov[5] += b*b;
+    }
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (int iteration = 0; iteration < 4; iteration++)
+    {
+        float x = cov[0]*axis[0] + cov[1]*axis[1] + cov[2]*axis[2];
+        float y = cov[1]*axis[0] + cov[3]*axis[1] + cov[4]*axis[2];
+        float z = cov[2]*axis[0] + cov[4]*axis[1] + cov[5]*axis[2];
+        float length = std::max(std::max(fabsf(x), fabsf(y)), fabsf(z));
+        if (length < 1e-6f)
+            break;
+        axis[0] = x / length; axis[1] = y / length; axis[2] = z / length;
+    }
+
+    float minProjection = 1e30f, maxProjection = -1e30f;
+    for (int i = 0; i < 16; i++)
+    {
+        float projection = (pixels[i][0] - mean[0])*axis[0] + (pixels[i][1] - mean[1])*axis[1] + (pixels[i][2] - mean[2])*axis[2];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    float axisLength2 = axis[0]*axis[0] + axis[1]*axis[1] + axis[2]*axis[2];
+    float high[3], low[3];
+    for (int k = 0; k < 3; k++)
+    {
+        high[k] = mean[k] + axis[k] * maxProjection / std::max(axisLength2, 1e-6f);
+        low[k]  = mean[k] + axis[k] * minProjection / std::max(axisLength2, 1e-6f);
+    }
+
+    uint16_t c0 = packColor565(high), c1 = packColor565(low);
+    orderEndpoints(c0, c1);
+    uint32_t indices;
+    int error = bc1Indices(pixels, c0, c1, indices);
+
+    // Refinamento: com os índices fixos, os extremos que minimizam o erro
+    // saem de um sistema 2x2 de mínimos quadrados (pesos 1, 0, 2/3, 1/3)
+    if (c0 != c1)
+    {
+        static const float WEIGHT[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+        float aa = 0, bb = 0, ab = 0, ax[3] = { 0, 0, 0 }, bx[3] = { 0, 0, 0 };
+        for (int i = 0; i < 16; i++)
+        {
+            float a = WEIGHT[(indices >> (2*i)) & 3], b = 1.0f - a;
+            aa += a*a; bb += b*b; ab += a*b;
+            for (int k = 0; k < 3; k++)
+            {
+                ax[k] += a * pixels[i][k];
+                bx[k] += b * pixels[i][k];
+            }
+        }
+        float determinant = aa*bb - ab*ab;
+        if (fabsf(determinant) > 1e-6f)
+        {
+            float refinedHigh[3], refinedLow[3];
+            for (int k = 0; k < 3; k++)
+            {
+                refinedHigh[k] = (ax[k]*bb - bx[k]*ab) / determinant;
+                refinedLow[k]  = (bx[k]*aa - ax[k]*ab) / determinant;
+            }
+            uint16_t r0 = packColor565(refinedHigh), r1 = packColor565(refinedLow);
+            orderEndpoints(r0, r1);
+            uint32_t refinedIndices;
+            int refinedError = bc1Indices(pixels, r0, r1, refinedIndices);
+            if (refinedError < error)
+            {
+                c0 = r0;
+                c1 = r1;
+                indices = refinedIndices;
+            }
+        }
+    }
+
+    // Bloco de uma cor só: modo de 3 cores, índice 0 em todos os pixels
+    if (c0 == c1)
+        indices = 0;
+
+    out[0] = (unsigned char)(c0 & 0xFF);
+    out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF);
+    out[3] = (unsigned char)(c1 >> 8);
+    out[4] = (unsigned char)(indices & 0xFF);
+    out[5] = (unsigned char)((indices >> 8) & 0xFF);
+    out[6] = (unsigned char)((indices >> 16) & 0xFF);
+    out[7] = (unsigned char)(indices >> 24);
+}
+
+static void encodeBC1(const unsigned char* rgb, int width, int height, std::vector<unsigned char>& blocks)
+{
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    blocks.resize((size_t)blocksX * blocksY * 8);
+
+    // Blocos na borda repetem a última linha/coluna da imagem
+    int pixels[16][3];
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                int x = std::min(4*bx + (i & 3), width - 1);
+                int y = std::min(4*by + (i >> 2), height - 1);
+                const unsigned char* p = rgb + ((size_t)y*width + x) * 3;
+                pixels[i][0] = p[0];
+                pixels[i][1] = p[1];
+                pixels[i][2] = p[2];
+            }
+            encodeBlock(pixels, &blocks[((size_t)by*blocksX + bx) * 8]);
+        }
+    }
+}
+
+void DecodeBC1(const unsigned char* blocks, int width, int height, unsigned char* rgb)
+{
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            const unsigned char* block = blocks + ((size_t)by*blocksX + bx) * 8;
+            uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+            uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+            uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+
+            int palette[4][3];
+            bc1Palette(c0, c1, palette);
+            for (int i = 0; i < 16; i++)
+            {
+                int x = 4*bx + (i & 3), y = 4*by + (i >> 2);
+                if (x >= width || y >= height)
+                    continue;
+                const int* color = palette[(indices >> (2*i)) & 3];
+                unsigned char* p = rgb + ((size_t)y*width + x) * 3;
+                p[0] = (unsigned char)color[0];
+                p[1] = (unsigned char)color[1];
+                p[2] = (unsigned char)color[2];
+            }
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Gravação
+// ----------------------------------------------------------------------------
+static void appendKeyValue(std::vector<unsigned char>& out, const char* key, const char* value)
+{
+    uint32_t size = (uint32_t)(strlen(key) + 1 + strlen(value) + 1);
+    const unsigned char* sizeBytes = (const unsigned char*)&size;
+    out.insert(out.end(), sizeBytes, sizeBytes + 4);
+    out.insert(out.end(), key, key + strlen(key) + 1);
+    out.insert(out.end(), value, value + strlen(value) + 1);
+    while (out.size() % 4 != 0)
+        out.push_back(0);
+}
+
+bool BakeTextureLevels(const char* sourcePath, int size, std::vector< std::vector<unsigned char> >& levels)
+{
+    levels.clear();
+
+    int width, height, channels;
+    unsigned char* data = stbi_load(sourcePath, &width, &height, &channels, 3);
+    if (data == NULL)
+    {
+        fprintf(stderr, "ERROR: Cannot open image file \"%s\".\n", sourcePath);
+        return false;
+    }
+
+    std::vector<unsigned char> level;
+    if (width == size && height == size)
+        level.assign(data, data + (size_t)width * height * 3);
+    else
+        resample(data, width, height, size, level);
+    stbi_image_free(data);
+
+    int count = TextureLevelCount(size);
+    levels.resize(count);
+    std::vector<unsigned char> next;
+    for (int i = 0, levelSize = size; i < count; i++, levelSize = std::max(1, levelSize / 2))
+    {
+        encodeBC1(&level[0], levelSize, levelSize, levels[i]);
+        if (i + 1 < count)
+        {
+            downsample(&level[0], levelSize, levelSize, next);
+            level.swap(next);
+        }
+    }
+    return true;
+}
+
+bool WriteBakedTexture(const char* bakedPath, uint64_t sourceHash, int size, const std::vector< std::vector<unsigned char> >& levels)
+{
+    char hashText[32];
+    char versionText[16];
+    snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)sourceHash);
+    snprintf(versionText, sizeof(versionText), "%u", TEXTURE_BAKE_VERSION);
+    std::vector<unsigned char> keyValues;
+    appendKeyValue(keyValues, KEY_SOURCE_HASH, hashText);
+    appendKeyValue(keyValues, KEY_BAKE_VERSION, versionText);
+
+    KtxHeader header;
+    memcpy(header.identifier, KTX_IDENTIFIER, 12);
+    header.endianness            = KTX_ENDIANNESS;
+    header.glType                = 0;
+    header.glTypeSize            = 1;
+    header.glFormat              = 0;
+    header.glInternalFormat      = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+    header.glBaseInternalFormat  = GL_RGB;
+    header.pixelWidth            = (uint32_t)size;
+    header.pixelHeight           = (uint32_t)size;
+    header.pixelDepth            = 0;
+    header.numberOfArrayElements = 0;
+    header.numberOfFaces         = 1;
+    header.numberOfMipmapLevels  = (uint32_t)levels.size();
+    header.bytesOfKeyValueData   = (uint32_t)keyValues.size();
+
+    FILE* file = fopen(bakedPath, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "ERROR: Cannot write baked texture \"%s\".\n", bakedPath);
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+           && fwrite(&keyValues[0], 1, keyValues.size(), file) == keyValues.size();
+
+    // Os níveis BC1 têm tamanho múltiplo de 8: já saem alinhados a 4
+    for (size_t i = 0; ok && i < levels.size(); i++)
+    {
+        uint32_t imageSize = (uint32_t)levels[i].size();
+        ok = fwrite(&imageSize, 4, 1, file) == 1
+          && fwrite(&levels[i][0], 1, levels[i].size(), file) == levels[i].size();
+    }
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok)
+    {
+        remove(bakedPath);
+        fprintf(stderr, "ERROR: Failed writing baked texture \"%s\".\n", bakedPath);
+    }
+    return ok;
+}
+
+bool BakeTexture(const char* sourcePath, const char* bakedPath, uint64_t sourceHash, int size)
+{
+    std::vector< std::vector<unsigned char> > levels;
+    return BakeTextureLevels(sourcePath, size, levels)
+        && WriteBakedTexture(bakedPath, sourceHash, size, levels);
+}
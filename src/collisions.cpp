@@ -129,6 +129,94 @@ bool testAABBAABB(const glm::vec3& minA, const glm::vec3& maxA,
            (minA.z <= maxB.z && maxA.z >= minB.z);    // Eixo Z
 }
 
+// ============================================================================
+// AABB TRANSFORMADA
+// ============================================================================
+// A caixa do modelo (espaço do objeto) levada ao mundo por 'model' deixa de
+// ser alinhada aos eixos; a AABB que a envolve tem o centro transformado e
+// semi-extensões |M| * e, onde |M| é a parte linear de 'model' com cada
+// elemento em valor absoluto (Arvo). Mais barato que transformar os 8 cantos.
+// ============================================================================
+void transformAABB(const glm::mat4& model, const glm::vec3& localMin, const glm::vec3& localMax,
+                   glm::vec3& worldMin, glm::vec3& worldMax)
+{
+    glm::vec3 center = (localMax + localMin) * 0.5f;
+    glm::vec3 extents = localMax - center;
+
+    glm::vec4 worldCenter = model * glm::vec4(center, 1.0f);
+    glm::vec3 worldExtents;
+    for (int row = 0; row < 3; row++)
+    {
+        worldExtents[row] = std::abs(model[0][row]) * extents.x
+                          + std::abs(model[1][row]) * extents.y
+                          + std::abs(model[2][row]) * extents.z;
+    }
+
+    worldMin = glm::vec3(worldCenter) - worldExtents;
+    worldMax = glm::vec3(worldCenter) + worldExtents;
+}
+
+// ============================================================================
+// PLANOS DO FRUSTUM DE VISUALIZAÇÃO
+// ============================================================================
+// Com q = M*p e M = projection * view, um ponto p é visível se
+//     -w <= qx <= w,  -w <= qy <= w,  -w <= qz <= w
+// (ver Matrix_Perspective em matrices.h). Cada desigualdade é um plano
+// (linha_w ± linha_i) · p >= 0, lido direto das linhas de M (Gribb e
+// Hartmann). As normais apontam para dentro do frustum e são normalizadas,
+// para que n·p + d seja a distância em unidades do mundo.
+//
+// Ordem: esquerda, direita, baixo, cima, perto, longe.
+// ============================================================================
+void extractFrustumPlanes(const glm::mat4& clip, glm::vec4 planes[6])
+{
+    // glm guarda as matrizes por coluna: a linha i é (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+        rows[i] = glm::vec4(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[3] + rows[2];
+    planes[5] = rows[3] - rows[2];
+
+    for (int i = 0; i < 6; i++)
+    {
+        float length = std::sqrt(planes[i].x * planes[i].x + planes[i].y * planes[i].y + planes[i].z * planes[i].z);
+        if (length > 0.0f)
+            planes[i] /= length;
+    }
+}
+
+// ============================================================================
+// INTERSECÇÃO AABB-FRUSTUM
+// ============================================================================
+// Mesma projeção do teste AABB-plano: a caixa está inteiramente fora se,
+// para algum plano, a distância com sinal do centro for menor que -r.
+// Conservador: caixas perto de uma aresta do frustum podem passar no teste
+// sem aparecer na tela, mas nenhuma caixa visível é descartada.
+// ============================================================================
+bool testAABBFrustum(const glm::vec3& boxMin, const glm::vec3& boxMax, const glm::vec4 planes[6])
+{
+    glm::vec3 center = (boxMax + boxMin) * 0.5f;
+    glm::vec3 extents = boxMax - center;
+
+    for (int i = 0; i < 6; i++)
+    {
+        const glm::vec4& plane = planes[i];
+        float r = extents.x * std::abs(plane.x) +
+                  extents.y * std::abs(plane.y) +
+                  extents.z * std::abs(plane.z);
+        float s = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+
+        if (s < -r)
+            return false;
+    }
+    return true;
+}
+
 // ============================================================================
 // INTERSECÇÃO PONTO-ESFERA (Bounding Sphere)
 // ============================================================================
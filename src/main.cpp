@@ -1,15 +1,151 @@
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <thread>
 #include "Game.h"
+#include "BatchRunner.h"
+#include "ProjectileBench.h"
 
-int main()
+int main(int argc, char* argv[])
 {
     Game game;
 
+    bool headless = false;
+    int matches = 1;
+    long long maxTicks = 120LL * 60 * 10;
+
+    int batchArenas = 0;
+    long long batchTicks = 120LL * 60;
+    int batchThreads = (int)std::thread::hardware_concurrency();
+    int benchProjectiles = 0;
+    int benchRounds = 20;
+    int difficulty = 1;
+    unsigned long long seed = Random::DEFAULT_SEED;
+    const char* recordPath = NULL;
+    const char* replayPath = NULL;
+    bool bakeTextures = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc)
+            game.setTickRate((float)atof(argv[++i]));
+        else if (strcmp(argv[i], "--max-substeps") == 0 && i + 1 < argc)
+            game.setMaxSubSteps(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--projectile-capacity") == 0 && i + 1 < argc)
+        {
+            // strtoul aceita "-1" (vira ULONG_MAX): o sinal é recusado antes
+            const char* text = argv[++i];
+            char* end = NULL;
+            errno = 0;
+            unsigned long capacity = strchr(text, '-') ? 0 : strtoul(text, &end, 10);
+            if (capacity == 0 || errno != 0 || *end != '\0' || capacity > ProjectileManager::MAX_CAPACITY)
+            {
+                fprintf(stderr, "ERROR: --projectile-capacity must be between 1 and %zu (got \"%s\").\n",
+                        ProjectileManager::MAX_CAPACITY, text);
+                return EXIT_FAILURE;
+            }
+            game.setProjectileCapacity((size_t)capacity);
+        }
+        else if (strcmp(argv[i], "--render-stats") == 0)
+            game.setRenderStatsEnabled(true);
+        else if (strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            matches = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc)
+            maxTicks = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+        {
+            difficulty = atoi(argv[++i]);
+            game.setDifficulty(difficulty);
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            batchArenas = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            batchTicks = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            batchThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bench-projectiles") == 0 && i + 1 < argc)
+            benchProjectiles = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bench-rounds") == 0 && i + 1 < argc)
+            benchRounds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+            game.setRandomSeed(seed);
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--bake-textures") == 0)
+            bakeTextures = true;
+    }
+
+    // Gera os .ktx das texturas (mipmaps + BC1) e sai; o jogo também os gera
+    // na primeira execução, mas assim o custo fica fora da partida
+    if (bakeTextures)
+        return Renderer::bakeTextures() ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    // Várias arenas headless em paralelo: imprime ticks/segundo por número de threads
+    if (batchArenas > 0)
+    {
+        BatchRunner runner(batchArenas, batchTicks, difficulty, game.getTickRate(), seed);
+        runner.run(batchThreads);
+        return EXIT_SUCCESS;
+    }
+
+    // Benchmark do tick de projéteis: layout atual contra o anterior
+    if (benchProjectiles > 0)
+    {
+        ProjectileBench bench(benchProjectiles, benchRounds, game.getTickRate(), seed);
+        bench.run();
+        return EXIT_SUCCESS;
+    }
+
+    // Semente, taxa de ticks e dificuldade vêm do arquivo de replay
+    if (replayPath && !game.loadReplay(replayPath))
+        return EXIT_FAILURE;
+
+    // Replay sem janela: reproduz a sessão gravada e imprime os tempos de tick
+    if (headless && replayPath)
+    {
+        if (!game.initHeadless())
+            return EXIT_FAILURE;
+        if (recordPath && !game.startRecording(recordPath))
+            return EXIT_FAILURE;
+
+        game.runReplayHeadless();
+        game.cleanup();
+        return EXIT_SUCCESS;
+    }
+
+    // Simulação sem janela: roda as partidas e imprime ticks/segundo
+    if (headless)
+    {
+        if (recordPath)
+        {
+            fprintf(stderr, "ERROR: --record needs a window or --replay; the headless autopilot is not recorded.\n");
+            return EXIT_FAILURE;
+        }
+
+        if (!game.initHeadless())
+            return EXIT_FAILURE;
+
+        game.runHeadless(matches, maxTicks);
+        game.cleanup();
+        return EXIT_SUCCESS;
+    }
+
     if (!game.init())
     {
         return EXIT_FAILURE;
     }
 
+    if (recordPath && !game.startRecording(recordPath))
+        return EXIT_FAILURE;
+
     game.run();
 
     game.cleanup();
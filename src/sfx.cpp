@@ -1,8 +1,7 @@
 #include "sfx.h"
 #include "miniaudio.h"
 #include <stdio.h>
-//Vriavel global
-Sfx sfx;
+
 bool Sfx::start() {
     if (initialized) {
         printf("[SFX] Engine j estava iniciado!\n");
@@ -34,6 +33,9 @@ void Sfx::stop() {
 }
 
 void Sfx::morte_monstro() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -49,6 +51,9 @@ void Sfx::morte_monstro() {
 }
 
 void Sfx::hit_monstro() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -64,6 +69,9 @@ void Sfx::hit_monstro() {
 }
 
 void Sfx::hit_player() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -80,6 +88,9 @@ void Sfx::hit_player() {
 
 
 void Sfx::tiro_player() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -95,6 +106,9 @@ void Sfx::tiro_player() {
 }
 
 void Sfx::fireball() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -110,6 +124,9 @@ void Sfx::fireball() {
 }
 
 void Sfx::cura() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -125,6 +142,9 @@ void Sfx::cura() {
 }
 
 void Sfx::game_over() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -140,6 +160,9 @@ void Sfx::game_over() {
 }
 
 void Sfx::vitoria() {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado! Use s.start() antes!\n");
         return;
@@ -155,6 +178,9 @@ void Sfx::vitoria() {
 }
 
 void Sfx::musicaPrincipalStart(const char* filename, bool loop) {
+    if (muted)
+        return;
+
     if (!initialized) {
         printf("[ERRO] Engine no inicializado!\n");
         return;
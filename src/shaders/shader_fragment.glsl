@@ -9,6 +9,8 @@
 // 2. Modelo de iluminação de Blinn-Phong (difusa + especular)
 // 3. Múltiplas fontes de luz pontuais (tochas)
 //
+// Um programa por material: ver PERMUTAÇÕES DE MATERIAL abaixo.
+//
 // REQUISITOS IMPLEMENTADOS:
 // - REQUISITO 6: Modelos de iluminação difusa (Lambert) e Blinn-Phong
 // - REQUISITO 7: Modelo de interpolação Phong (iluminação por fragmento)
@@ -45,78 +47,68 @@ in vec4 normal;           // Normal interpolada (para Phong shading)
 in vec4 position_model;   // Posição em coordenadas do modelo
 in vec2 texcoords;        // Coordenadas UV interpoladas
 in vec3 vertex_color;     // Cor calculada no vertex shader (Gouraud)
-// Matrizes computadas no código C++ e enviadas para a GPU
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+flat in float texture_layer;  // Camada da textura do material
+
+// Uniforms por quadro, compartilhados por todos os programas (ver
+// CameraUniforms em Renderer.h). Atualizados uma vez por quadro.
+layout (std140) uniform CameraBlock
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camera_position;
+};
+
+#define MAX_TORCHES 8
+layout (std140) uniform TorchBlock
+{
+    vec4 torch_positions[MAX_TORCHES];  // xyz = posição, w = intensidade
+    vec4 torch_colors[MAX_TORCHES];
+    int num_torches;
+    float torch_flicker;
+};
 const float M_PI = 3.14159265358979323846;
-// Identificador que define qual objeto está sendo desenhado no momento
-#define MONSTRO 0
-#define CUBE  1
-#define PLANE  2
-#define WALL_NORTH 3
-#define WALL_SOUTH 4
-#define WALL_EAST 5
-#define WALL_WEST 6
-#define CEILING 7
-#define DRAGON_BOSS 9
-#define VARINHA 10
-#define PROJECTILE 11
-#define PROJECTILE_TRAIL 12
-#define ENEMY_PROJECTILE 13
-#define ENEMY_PROJECTILE_TRAIL 14
-#define PILLAR 15
-#define HEALTH_PICKUP 16
-#define TORCH 17
-#define DYING_ENEMY 18
-uniform int object_id;
+
+// ============================================================================
+// PERMUTAÇÕES DE MATERIAL
+// ============================================================================
+// Este arquivo não é compilado sozinho: Renderer::loadShadersFromFiles()
+// compila um programa por material, inserindo logo após o #version os
+// #defines que descrevem o material (ver MATERIAL_PERMUTATIONS em
+// Renderer.cpp). Cada programa só contém o código do seu material, sem
+// desvio por object_id. Exatamente uma opção de cada grupo:
+//
+// Coordenadas de textura:
+//   TEXCOORDS_MESH         UVs do modelo .obj
+//   TEXCOORDS_PLANAR_XZ    planar na posição do modelo (chão e teto)
+//   TEXCOORDS_PLANAR_XY    idem, paredes norte e sul
+//   TEXCOORDS_PLANAR_ZY    idem, paredes leste e oeste
+//   TEXCOORDS_SPHERICAL    projeção esférica em torno do centro da bbox
+//   TEXCOORDS_BOX_WORLD    projeção cúbica em coordenadas do mundo (pilares)
+//   TEXCOORDS_BOX_LOCAL    projeção cúbica normalizada pela bbox (tochas)
+//   (nenhuma: material sem textura, só com LIGHTING_UNLIT)
+//
+// Iluminação:
+//   LIGHTING_BLINN_PHONG   ambiente + tochas (Lambert + Blinn-Phong), com
+//                          MATERIAL_KS e MATERIAL_SHININESS
+//   LIGHTING_LAMBERT       ambiente + tochas, só difusa
+//   LIGHTING_GOURAUD       cor calculada por vértice * textura
+//   LIGHTING_FIRE          chama das tochas (fresnel)
+//   LIGHTING_DEATH_FLASH   inimigo morrendo: textura clareada
+//   LIGHTING_UNLIT         cor constante UNLIT_COLOR (rastros)
+// ============================================================================
+
+#if defined(TEXCOORDS_SPHERICAL) || defined(TEXCOORDS_BOX_LOCAL)
 uniform vec4 bbox_min;
 uniform vec4 bbox_max;
-uniform sampler2D TextureImage0;
-uniform sampler2D TextureImage1;
-uniform sampler2D TextureImage2;
-uniform sampler2D TextureImage3;
-uniform sampler2D TextureImage4;
-uniform sampler2D TextureImage5;
-uniform sampler2D TextureImage6;
-uniform sampler2D TextureImage7;
-uniform sampler2D TextureImage8;
-uniform sampler2D TextureImage9;
-uniform sampler2D TextureImage10;
-#define MAX_TORCHES 8
-uniform vec3 torch_positions[MAX_TORCHES];
-uniform vec3 torch_colors[MAX_TORCHES];
-uniform float torch_intensities[MAX_TORCHES];
-uniform int num_torches;
+#endif
+
+// Texturas de todos os materiais, uma por camada (ver Renderer::init); a
+// camada do material chega em texture_layer
+uniform sampler2DArray material_textures;
 
 // O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
 out vec4 color;
 
-//Função dotproduct
-float dotproduct(vec4 u, vec4 v)
-{
-    float u1 = u.x;
-    float u2 = u.y;
-    float u3 = u.z;
-    float u4 = u.w;
-    float v1 = v.x;
-    float v2 = v.y;
-    float v3 = v.z;
-    float v4 = v.w;
-
-    return u1*v1 + u2*v2 + u3*v3;
-}
-
-//Função norm
-float norm(vec4 v)
-{
-    float vx = v.x;
-    float vy = v.y;
-    float vz = v.z;
-
-    return sqrt( vx*vx + vy*vy + vz*vz );
-}
-
 // ============================================================================
 // FUNÇÃO DE ILUMINAÇÃO BLINN-PHONG
 // ============================================================================
@@ -148,9 +140,9 @@ vec3 calculateTorchLighting(vec4 fragPos, vec4 normal, vec4 viewDir,
     // Itera sobre todas as tochas (fontes de luz pontuais)
     for (int i = 0; i < num_torches; i++)
     {
-        vec3 lightPos = torch_positions[i];
-        vec3 lightColor = torch_colors[i];
-        float intensity = torch_intensities[i];
+        vec3 lightPos = torch_positions[i].xyz;
+        vec3 lightColor = torch_colors[i].rgb;
+        float intensity = torch_positions[i].w;
 
         // Vetor do fragmento para a luz
         vec4 lightDir = vec4(lightPos, 1.0) - fragPos;
@@ -191,9 +183,9 @@ vec3 calculateTorchLightingDiffuseOnly(vec4 fragPos, vec4 normal, vec3 Kd)
 
     for (int i = 0; i < num_torches; i++)
     {
-        vec3 lightPos = torch_positions[i];
-        vec3 lightColor = torch_colors[i];
-        float intensity = torch_intensities[i];
+        vec3 lightPos = torch_positions[i].xyz;
+        vec3 lightColor = torch_colors[i].rgb;
+        float intensity = torch_positions[i].w;
 
         vec4 lightDir = vec4(lightPos, 1.0) - fragPos;
         float distance = length(lightDir.xyz);
@@ -214,18 +206,14 @@ vec3 calculateTorchLightingDiffuseOnly(vec4 fragPos, vec4 normal, vec3 Kd)
 // ============================================================================
 // Calcula a cor final de cada fragmento usando:
 // - Amostragem de texturas
-// - Modelo de iluminação apropriado para cada tipo de objeto
+// - Modelo de iluminação do material (escolhido na compilação)
 // - Correção gamma para display sRGB
 // ============================================================================
 void main()
 {
-    // Obtém a posição da câmera invertendo a matriz view
-    // Usado para calcular o vetor de visão v = normalize(camera - fragmento)
-    vec4 origin = vec4(0.0, 0.0, 0.0, 1.0);
-    vec4 camera_position = inverse(view) * origin;
-
-    // Espectro da fonte de iluminação direcional (não usada atualmente)
-    vec3 I = vec3(1.2,1.2,1.2);
+    // A posição da câmera (camera_position, usada no vetor de visão
+    // v = normalize(camera - fragmento)) vem do CameraBlock, calculada na
+    // CPU uma vez por quadro em Renderer::setView
 
     // Luz ambiente global (iluminação base da cena)
     vec3 Ia = vec3(0.10, 0.08, 0.05);
@@ -240,68 +228,100 @@ void main()
     // normais de cada vértice.
     vec4 n = normalize(normal);
 
-    // Vetor que define o sentido da fonte de luz em relação ao ponto atual.
-    vec4 l = normalize(vec4(1.0,1.0,0.5,0.0));
-
     // Vetor que define o sentido da câmera em relação ao ponto atual.
     vec4 v = normalize(camera_position - p);
-    vec4 r = -l+2*n*(dotproduct(n, l));
-    vec4 h = normalize(l + v);
-    // Parâmetros que definem as propriedades espectrais da superfície
-    vec3 Kd; // Refletância difusa
-    vec3 Ks; // Refletância especular
-    vec3 Ka; // Refletância ambiente
-    float q; // Expoente especular para o modelo de iluminação de Phong
+
     float U = 0.0;
     float V = 0.0;
 
-    if ( object_id == MONSTRO )
-    {
-        U = texcoords.x;
-        V = texcoords.y;
-    }
-    else if ( object_id ==  CUBE )
-    {
-        U = texcoords.x;
-        V = texcoords.y;
-    }
-    else if ( object_id == DRAGON_BOSS )
-    {
-        U = texcoords.x;
-        V = texcoords.y;
+    // ─────────────────────────────────────────────────────────────────────────
+    // COORDENADAS DE TEXTURA
+    // ─────────────────────────────────────────────────────────────────────────
+#if defined(TEXCOORDS_MESH)
+    U = texcoords.x;
+    V = texcoords.y;
+#elif defined(TEXCOORDS_PLANAR_XZ)
+    U = position_model.x - floor(position_model.x);
+    V = position_model.z - floor(position_model.z);
+#elif defined(TEXCOORDS_PLANAR_XY)
+    U = position_model.x - floor(position_model.x);
+    V = position_model.y - floor(position_model.y);
+#elif defined(TEXCOORDS_PLANAR_ZY)
+    U = position_model.z - floor(position_model.z);
+    V = position_model.y - floor(position_model.y);
+#elif defined(TEXCOORDS_SPHERICAL)
+    // ─────────────────────────────────────────────────────────────────────
+    // PROJÉTIL - Mapeamento de Textura ESFÉRICO
+    // ─────────────────────────────────────────────────────────────────────
+    // REQUISITO 8: Mapeamento de texturas (projeção esférica)
+    //
+    // Para objetos esféricos como projéteis, usamos coordenadas UV baseadas
+    // em coordenadas esféricas (theta, phi) em vez de coordenadas planares:
+    //
+    //     theta = atan2(x, z)      // ângulo horizontal [-π, π]
+    //     phi = asin(y / raio)     // ângulo vertical [-π/2, π/2]
+    //
+    //     U = (theta + π) / (2π)   // normaliza para [0, 1]
+    //     V = (phi + π/2) / π      // normaliza para [0, 1]
+    //
+    // Isso "envolve" a textura ao redor da esfera de forma natural,
+    // similar ao mapeamento de textura de um globo terrestre.
+    // ─────────────────────────────────────────────────────────────────────
+
+    // Centro da bounding box (centro da esfera)
+    vec4 bbox_center = (bbox_min + bbox_max) / 2.0;
+    // Vetor do centro para o ponto atual na superfície
+    vec4 vetor_centro = position_model-bbox_center;
+    float raio = length(vetor_centro);
+
+    // Converte para coordenadas esféricas
+    float arcotangente = atan(vetor_centro.x,vetor_centro.z);  // theta
+    float arcsen = asin(vetor_centro.y/raio);                   // phi
+
+    // Normaliza para coordenadas UV [0, 1]
+    U = (arcotangente+M_PI)/(2*M_PI);
+    V = (arcsen+M_PI/2)/M_PI;
+#elif defined(TEXCOORDS_BOX_WORLD)
+    vec3 absPos = abs(position_model.xyz);
+    float maxCoord = max(absPos.x, max(absPos.y, absPos.z));
+
+    if (absPos.x >= maxCoord - 0.01) {
+        U = position_world.z - floor(position_world.z);
+        V = position_world.y - floor(position_world.y);
+    } else if (absPos.z >= maxCoord - 0.01) {
+        U = position_world.x - floor(position_world.x);
+        V = position_world.y - floor(position_world.y);
+    } else {
+        U = position_world.x - floor(position_world.x);
+        V = position_world.z - floor(position_world.z);
     }
-    else if ( object_id == VARINHA )
-    {
+#elif defined(TEXCOORDS_BOX_LOCAL)
+    vec4 box = (position_model - bbox_min) / (bbox_max - bbox_min);
+    vec4 absBox = abs(box);
 
-        U = texcoords.x;
-        V = texcoords.y;
+    if(absBox.x >= absBox.y && absBox.x >= absBox.z) {
+        U = box.z;
+        V = box.y;
     }
-    else if(object_id >= 2 && object_id<= 7)
-    {
-        if(object_id == PLANE || object_id == CEILING){
-            U = position_model.x - floor(position_model.x);
-            V = position_model.z - floor(position_model.z);
-        }
-        else if(object_id == WALL_NORTH || object_id == WALL_SOUTH){
-            U = position_model.x - floor(position_model.x);
-            V = position_model.y - floor(position_model.y);
-        }
-        else if(object_id == WALL_EAST || object_id == WALL_WEST){
-            U = position_model.z - floor(position_model.z);
-            V = position_model.y - floor(position_model.y);
-        }
+    else if(absBox.y >= absBox.x && absBox.y >= absBox.z) {
+        U = box.x;
+        V = box.z;
     }
-    else
-    {
-        Kd = vec3(0.0,0.0,0.0);
-        Ks = vec3(0.0,0.0,0.0);
-        Ka = vec3(0.0,0.0,0.0);
-        q = 1.0;
+    else {
+        U = box.x;
+        V = box.y;
     }
+    U = U * 0.5 + 0.5;
+    V = V * 0.5 + 0.5;
+#endif
 
     // ─────────────────────────────────────────────────────────────────────────
-    // MONSTRO - Iluminação Blinn-Phong com Texturas
+    // ILUMINAÇÃO
     // ─────────────────────────────────────────────────────────────────────────
+#if defined(LIGHTING_BLINN_PHONG)
+    // ─────────────────────────────────────────────────────────────────────
+    // MONSTRO, JOGADOR, DRAGÃO, PROJÉTEIS... - Blinn-Phong com Texturas
+    // ─────────────────────────────────────────────────────────────────────
     // REQUISITO 6: Modelo de iluminação difusa (Lambert) + Blinn-Phong
     // REQUISITO 7: Modelo de interpolação PHONG (iluminação por fragmento)
     // REQUISITO 8: Mapeamento de texturas
@@ -311,37 +331,36 @@ void main()
     // o que caracteriza o modelo de interpolação de PHONG.
     //
     // Comparando com o chão/paredes que usam GOURAUD (vertex shader),
-    // os monstros têm highlights especulares mais nítidos e precisos.
-    // ─────────────────────────────────────────────────────────────────────────
-    if (object_id == MONSTRO)
-    {
-        // Amostra a textura da pele do monstro nas coordenadas UV
-        vec3 pele = texture(TextureImage0, vec2(U,V)).rgb;
-
-        // Define coeficientes de material:
-        // Kd = reflexão difusa (usa cor da textura)
-        // Ks = reflexão especular (brilhos)
-        // Ka = reflexão ambiente
-        vec3 Kd_monster = pele;
-        vec3 Ks_monster = vec3(0.2);  // Levemente brilhante
-        vec3 Ka_monster = pele;
-
-        // Calcula iluminação Blinn-Phong (difusa + especular) para cada tocha
-        // shininess = 64 = brilho médio-alto
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_monster, Ks_monster, 64.0);
-
-        // Cor final = ambiente + iluminação das tochas
-        color.rgb = Ka_monster * Ia + pointLighting;
-    }
-    else if (object_id == DYING_ENEMY)
-    {
-        vec3 pele = texture(TextureImage0, vec2(U,V)).rgb;
-        vec3 flashColor = vec3(1.0, 0.9, 0.5);
-        color.rgb = mix(pele, flashColor, 0.7) * 1.5;
-    }
-    // ─────────────────────────────────────────────────────────────────────────
+    // estes objetos têm highlights especulares mais nítidos e precisos.
+    // ─────────────────────────────────────────────────────────────────────
+
+    // Amostra a textura do material nas coordenadas UV
+    vec3 tex = texture(material_textures, vec3(U, V, texture_layer)).rgb;
+
+    // Define coeficientes de material:
+    // Kd = reflexão difusa (usa cor da textura)
+    // Ks = reflexão especular (brilhos), constante do material
+    // Ka = reflexão ambiente
+    vec3 Kd = tex;
+    vec3 Ks = vec3(MATERIAL_KS);
+    vec3 Ka = tex;
+
+    // Calcula iluminação Blinn-Phong (difusa + especular) para cada tocha
+    vec3 pointLighting = calculateTorchLighting(p, n, v, Kd, Ks, MATERIAL_SHININESS);
+
+    // Cor final = ambiente + iluminação das tochas
+    color.rgb = Ka * Ia + pointLighting;
+#elif defined(LIGHTING_LAMBERT)
+    vec3 tex = texture(material_textures, vec3(U, V, texture_layer)).rgb;
+    vec3 Kd = tex;
+    vec3 Ka = tex;
+
+    vec3 pointLighting = calculateTorchLightingDiffuseOnly(p, n, Kd);
+    color.rgb = Ka * Ia + pointLighting;
+#elif defined(LIGHTING_GOURAUD)
+    // ─────────────────────────────────────────────────────────────────────
     // ARENA (Chão, Paredes, Teto) - Iluminação GOURAUD
-    // ─────────────────────────────────────────────────────────────────────────
+    // ─────────────────────────────────────────────────────────────────────
     // REQUISITO 7: Modelo de interpolação GOURAUD
     // REQUISITO 8: Mapeamento de texturas
     //
@@ -356,198 +375,28 @@ void main()
     // Comparando GOURAUD vs PHONG:
     // - Gouraud: iluminação em 3 vértices → interpolada → multiplica textura
     // - Phong: normal interpolada → iluminação por pixel → mais preciso
-    // ─────────────────────────────────────────────────────────────────────────
-    else if(object_id >= 2 && object_id<= 7)
-    {
-        // Seleciona a textura apropriada para cada superfície
-        vec3 tex;
-        if(object_id == PLANE)
-        {
-            tex = texture(TextureImage2, vec2(U,V)).rgb;  // Textura do chão
-        }
-        else if(object_id == CEILING)
-        {
-            tex = texture(TextureImage3, vec2(U,V)).rgb;  // Textura do teto
-        }
-        else
-        {
-            tex = texture(TextureImage1, vec2(U,V)).rgb;  // Textura das paredes
-        }
-        // Combina cor Gouraud (do vertex shader) com textura
-        color.rgb=vertex_color*tex;
-    }
-    else if(object_id == CUBE){
-        vec3 corpo = texture(TextureImage4, vec2(U,V)).rgb;
-        vec3 Kd_player = corpo;
-        vec3 Ks_player = vec3(0.3);
-        vec3 Ka_player = corpo;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_player, Ks_player, 128.0);
-        color.rgb = Ka_player * Ia + pointLighting;
-    }
-    else if(object_id == VARINHA){
-        vec3 varinha = texture(TextureImage5, vec2(U,V)).rgb;
-        vec3 Kd_wand = varinha;
-        vec3 Ks_wand = vec3(0.4);
-        vec3 Ka_wand = varinha;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_wand, Ks_wand, 32.0);
-        color.rgb = Ka_wand * Ia + pointLighting;
-    }
-    else if(object_id == DRAGON_BOSS){
-        vec3 dragon_tex = texture(TextureImage9, vec2(U,V)).rgb;
-        vec3 Kd_dragon = dragon_tex;
-        vec3 Ks_dragon = vec3(0.4);  // Shiny scales
-        vec3 Ka_dragon = dragon_tex;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_dragon, Ks_dragon, 64.0);
-        color.rgb = Ka_dragon * Ia + pointLighting;
-    }
-    // ─────────────────────────────────────────────────────────────────────────
-    // PROJÉTIL - Mapeamento de Textura ESFÉRICO
-    // ─────────────────────────────────────────────────────────────────────────
-    // REQUISITO 8: Mapeamento de texturas (projeção esférica)
-    //
-    // Para objetos esféricos como projéteis, usamos coordenadas UV baseadas
-    // em coordenadas esféricas (theta, phi) em vez de coordenadas planares:
-    //
-    //     theta = atan2(x, z)      // ângulo horizontal [-π, π]
-    //     phi = asin(y / raio)     // ângulo vertical [-π/2, π/2]
-    //
-    //     U = (theta + π) / (2π)   // normaliza para [0, 1]
-    //     V = (phi + π/2) / π      // normaliza para [0, 1]
-    //
-    // Isso "envolve" a textura ao redor da esfera de forma natural,
-    // similar ao mapeamento de textura de um globo terrestre.
-    // ─────────────────────────────────────────────────────────────────────────
-    else if(object_id == PROJECTILE)
-    {
-        // Centro da bounding box (centro da esfera)
-        vec4 bbox_center = (bbox_min + bbox_max) / 2.0;
-        // Vetor do centro para o ponto atual na superfície
-        vec4 vetor_centro = position_model-bbox_center;
-        float raio = length(vetor_centro);
-
-        // Converte para coordenadas esféricas
-        float arcotangente = atan(vetor_centro.x,vetor_centro.z);  // theta
-        float arcsen = asin(vetor_centro.y/raio);                   // phi
-
-        // Normaliza para coordenadas UV [0, 1]
-        U = (arcotangente+M_PI)/(2*M_PI);
-        V = (arcsen+M_PI/2)/M_PI;
-
-        vec3 magic = texture(TextureImage7, vec2(U,V)).rgb;
-        vec3 Kd_proj = magic;
-        vec3 Ks_proj = vec3(0.3);
-        vec3 Ka_proj = magic;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_proj, Ks_proj, 64.0);
-        color.rgb = Ka_proj * Ia + pointLighting;
-    }
-    else if(object_id == PROJECTILE_TRAIL)
-    {
-        color.rgb = vec3(0.7, 0.1, 0.7) * 2.5;
-    }
-    else if(object_id == ENEMY_PROJECTILE)
-    {
-        vec4 bbox_center = (bbox_min + bbox_max) / 2.0;
-        vec4 vetor_centro = position_model-bbox_center;
-        float raio = length(vetor_centro);
-        float arcotangente = atan(vetor_centro.x,vetor_centro.z);
-        float arcsen = asin(vetor_centro.y/raio);
-        U = (arcotangente+M_PI)/(2*M_PI);
-        V = (arcsen+M_PI/2)/M_PI;
-
-        vec3 fire = texture(TextureImage8, vec2(U,V)).rgb;
-        vec3 Kd_enemy_proj = fire;
-        vec3 Ks_enemy_proj = vec3(0.3);
-        vec3 Ka_enemy_proj = fire;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_enemy_proj, Ks_enemy_proj, 64.0);
-        color.rgb = Ka_enemy_proj * Ia + pointLighting;
-    }
-    else if(object_id == ENEMY_PROJECTILE_TRAIL)
-    {
-        color.rgb = vec3(1.0, 0.2, 0.0) * 1.8;
-    }
-    else if(object_id == PILLAR)
-    {
-        vec3 absPos = abs(position_model.xyz);
-        float maxCoord = max(absPos.x, max(absPos.y, absPos.z));
-        float pillarU, pillarV;
-
-        if (absPos.x >= maxCoord - 0.01) {
-            pillarU = position_world.z - floor(position_world.z);
-            pillarV = position_world.y - floor(position_world.y);
-        } else if (absPos.z >= maxCoord - 0.01) {
-            pillarU = position_world.x - floor(position_world.x);
-            pillarV = position_world.y - floor(position_world.y);
-        } else {
-            pillarU = position_world.x - floor(position_world.x);
-            pillarV = position_world.z - floor(position_world.z);
-        }
-
-        vec3 tex = texture(TextureImage1, vec2(pillarU, pillarV)).rgb;
-        vec3 Kd_pillar = tex;
-        vec3 Ka_pillar = tex;
-
-        vec3 pointLighting = calculateTorchLightingDiffuseOnly(p, n, Kd_pillar);
-        color.rgb = Ka_pillar * Ia + pointLighting;
-    }
-    else if(object_id == HEALTH_PICKUP)
-    {
-        U = texcoords.x;
-        V = texcoords.y;
-        vec3 health_tex = texture(TextureImage6, vec2(U,V)).rgb;
-        vec3 Kd_health = health_tex;
-        vec3 Ks_health = vec3(0.2);
-        vec3 Ka_health = health_tex;
-
-        vec3 pointLighting = calculateTorchLighting(p, n, v, Kd_health, Ks_health, 4.0);
-        color.rgb = Ka_health * Ia + pointLighting;
-    }
-    else if(object_id == TORCH)
-    {
-        vec4 p = (position_model - bbox_min) / (bbox_max - bbox_min);
-        vec4 absP = abs(p);
-
-        if(absP.x >= absP.y && absP.x >= absP.z) {
-            U = p.z;
-            V = p.y;
-        }
-        else if(absP.y >= absP.x && absP.y >= absP.z) {
-            U = p.x;
-            V = p.z;
-        }
-        else {
-            U = p.x;
-            V = p.y;
-        }
-        U = U * 0.5 + 0.5;
-        V = V * 0.5 + 0.5;
-        vec3 fireCore = vec3(1.0, 0.5, 0.1);
-        vec3 fireGlow = vec3(1.0, 0.8, 0.2);
-        float fresnel = 1.0 - max(dot(n, v), 0.0);
-        fresnel = pow(fresnel, 2.0);
-        vec3 luz_fogo = mix(fireCore, fireGlow, fresnel) * 2.5;
-        vec3 fogo_tex = texture(TextureImage10, vec2(U,V)).rgb;
-        color.rgb=luz_fogo*fogo_tex;
-    }
-    else
-    {
-
-        // Termo difuso utilizando a lei dos cossenos de Lambert
-        vec3 lambert_diffuse_term = Kd*I*max(dotproduct(n, l), 0.0);
-
-        // Termo ambiente
-        vec3 ambient_term = Ka*Ia; // PREENCHA AQUI o termo ambiente
-
-        // Termo especular utilizando o modelo de iluminação de Phong
-        vec3 phong_specular_term  = Ks*I*pow(max(dotproduct(r,v),0.0),q);
-
-        // Cor final do fragmento calculada com uma combinação dos termos difuso, especular, e ambiente.
-        color.rgb = lambert_diffuse_term + ambient_term + phong_specular_term;
-    }
+    // ─────────────────────────────────────────────────────────────────────
+    vec3 tex = texture(material_textures, vec3(U, V, texture_layer)).rgb;
+
+    // Combina cor Gouraud (do vertex shader) com textura
+    color.rgb = vertex_color*tex;
+#elif defined(LIGHTING_FIRE)
+    vec3 fireCore = vec3(1.0, 0.5, 0.1);
+    vec3 fireGlow = vec3(1.0, 0.8, 0.2);
+    float fresnel = 1.0 - max(dot(n, v), 0.0);
+    fresnel = pow(fresnel, 2.0);
+    vec3 luz_fogo = mix(fireCore, fireGlow, fresnel) * 2.5;
+    vec3 fogo_tex = texture(material_textures, vec3(U, V, texture_layer)).rgb;
+    color.rgb = luz_fogo*fogo_tex;
+#elif defined(LIGHTING_DEATH_FLASH)
+    vec3 pele = texture(material_textures, vec3(U, V, texture_layer)).rgb;
+    vec3 flashColor = vec3(1.0, 0.9, 0.5);
+    color.rgb = mix(pele, flashColor, 0.7) * 1.5;
+#elif defined(LIGHTING_UNLIT)
+    color.rgb = UNLIT_COLOR;
+#else
+#error "Permutação sem modelo de iluminação (LIGHTING_*)"
+#endif
     // Canal alpha = 1 (totalmente opaco)
     color.a=1;
 
@@ -21,6 +21,12 @@
 // A diferença para Phong shading é que em Phong a iluminação é calculada
 // no FRAGMENT SHADER (por fragmento), resultando em highlights mais nítidos.
 //
+// Como o fragment shader, é compilado uma vez por material com os #defines
+// do material (ver "shader_fragment.glsl" e Renderer::loadShadersFromFiles):
+//   STATIC_BATCH   vértices do lote estático da arena
+//   TORCH_FLAME    (com STATIC_BATCH) escala a chama das tochas
+//   GOURAUD        iluminação por vértice, com GOURAUD_KD e GOURAUD_KA
+//
 // ============================================================================
 
 // Atributos de vértice recebidos como entrada ("in") pelo Vertex Shader.
@@ -29,17 +35,52 @@ layout (location = 0) in vec4 model_coefficients;
 layout (location = 1) in vec4 normal_coefficients;
 layout (location = 2) in vec2 texture_coefficients;
 
+#ifdef STATIC_BATCH
+// Atributos do lote estático da arena: os vértices já chegam em coordenadas
+// do mundo, com a posição no espaço do objeto (para as texturas). As tochas
+// chegam com o centro em model_coefficients e a chama é escalada aqui.
+// Veja Renderer::buildStaticBatch().
+layout (location = 8) in vec4 static_local;
+layout (location = 9) in float static_flame_phase;
+// Camada da textura do material no array de texturas, por vértice
+layout (location = 7) in float static_texture_layer;
+#else
+// Atributos por instância (glVertexAttribDivisor = 1), usados quando
+// use_instancing != 0: pacotes vizinhos do mesmo modelo e material na fila
+// de renderização (a horda de inimigos, os projéteis, os rastros) saem numa
+// única chamada glDrawElementsInstanced, e cada instância traz a sua matriz
+// modelo, a matriz das normais e a camada da textura do seu material (a
+// corrida pode misturar materiais). Veja Renderer::flushRenderQueue().
+layout (location = 3) in mat4 instance_model;            // ocupa as locations 3..6
+layout (location = 7) in float instance_texture_layer;
+layout (location = 10) in mat3 instance_normal_matrix;   // ocupa as locations 10..12
+
 // Matrizes computadas no código C++ e enviadas para a GPU
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform int object_id;
+// inverse(transpose(model)), calculada na CPU uma vez por desenho
+uniform mat3 normal_matrix;
+// Camada da textura do material, nos desenhos não instanciados
+uniform float material_layer;
+uniform int use_instancing;
+#endif
+
+// Uniforms por quadro, compartilhados por todos os programas (ver
+// CameraUniforms em Renderer.h). Atualizados uma vez por quadro.
+layout (std140) uniform CameraBlock
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camera_position;
+};
 
 #define MAX_TORCHES 8
-uniform vec3 torch_positions[MAX_TORCHES];
-uniform vec3 torch_colors[MAX_TORCHES];
-uniform float torch_intensities[MAX_TORCHES];
-uniform int num_torches;
+layout (std140) uniform TorchBlock
+{
+    vec4 torch_positions[MAX_TORCHES];  // xyz = posição, w = intensidade
+    vec4 torch_colors[MAX_TORCHES];
+    int num_torches;
+    float torch_flicker;
+};
 // Atributos de vértice que serão gerados como saída ("out") pelo Vertex Shader.
 // ** Estes serão interpolados pelo rasterizador! ** gerando, assim, valores
 // para cada fragmento, os quais serão recebidos como entrada pelo Fragment
@@ -49,12 +90,8 @@ out vec4 position_model;
 out vec4 normal;
 out vec2 texcoords;
 out vec3 vertex_color;
-#define PLANE  2
-#define WALL_NORTH 3
-#define WALL_SOUTH 4
-#define WALL_EAST 5
-#define WALL_WEST 6
-#define CEILING 7
+// Camada do array de texturas: a mesma nos três vértices do triângulo
+flat out float texture_layer;
 
 void main()
 {
@@ -69,7 +106,40 @@ void main()
     // as coordenadas finais em NDC (variável gl_Position). Após a execução
     // deste Vertex Shader, a placa de vídeo (GPU) fará a divisão por W.
 
-    gl_Position = projection * view * model * model_coefficients;
+    vec4 vertex_position = model_coefficients;
+    vec4 vertex_normal = normal_coefficients;
+    vec4 vertex_local = model_coefficients;
+#ifdef STATIC_BATCH
+    // Vértices e normais já em coordenadas do mundo
+    mat4 model_matrix = mat4(1.0);
+    mat3 normal_model_matrix = mat3(1.0);
+    vertex_local = static_local;
+    texture_layer = static_texture_layer;
+#ifdef TORCH_FLAME
+    // Chama pulsante: escala (s, 1.5s, s) em torno do centro
+    float s = 0.12 + 0.03 * sin(torch_flicker + static_flame_phase);
+    vec3 flame_scale = vec3(s, 1.5 * s, s);
+    vertex_position = vec4(model_coefficients.xyz + static_local.xyz * flame_scale, 1.0);
+    vertex_normal = vec4(normal_coefficients.xyz / flame_scale, 0.0);
+#endif
+#else
+    mat4 model_matrix = model;
+    mat3 normal_model_matrix = normal_matrix;
+    texture_layer = material_layer;
+    if (use_instancing != 0)
+    {
+        model_matrix = instance_model;
+        normal_model_matrix = instance_normal_matrix;
+        texture_layer = instance_texture_layer;
+    }
+#endif
+
+    // Posição do vértice atual no sistema de coordenadas global (World).
+    position_world = model_matrix * vertex_position;
+
+    // Matriz * vetor, da direita para a esquerda: evita os produtos
+    // matriz * matriz de "projection * view * model" em cada vértice
+    gl_Position = projection * (view * position_world);
 
     // Como as variáveis acima  (tipo vec4) são vetores com 4 coeficientes,
     // também é possível acessar e modificar cada coeficiente de maneira
@@ -85,13 +155,11 @@ void main()
     // Agora definimos outros atributos dos vértices que serão interpolados pelo
     // rasterizador para gerar atributos únicos para cada fragmento gerado.
 
-    // Posição do vértice atual no sistema de coordenadas global (World).
-    position_world = model * model_coefficients;
-    position_model = model_coefficients;
+    position_model = vertex_local;
     // Normal do vértice atual no sistema de coordenadas global (World).
     // Veja slides 123-151 do documento Aula_07_Transformacoes_Geometricas_3D.pdf.
-    normal = inverse(transpose(model)) * normal_coefficients;
-    normal.w = 0.0;
+    // A inversa transposta vem pronta da CPU (normal_matrix ou por instância).
+    normal = vec4(normal_model_matrix * vertex_normal.xyz, 0.0);
     texcoords = texture_coefficients;
     // ─────────────────────────────────────────────────────────────────────────
     // ILUMINAÇÃO GOURAUD (Por Vértice)
@@ -112,32 +180,25 @@ void main()
     //     l = vetor direção para a luz (normalizado)
     //     atenuação = 1 / (1 + 0.7*d + 1.8*d²) para simular queda com distância
     // ─────────────────────────────────────────────────────────────────────────
-    vec3 Kd;
-    vec3 Ka;
-    if(object_id >= 2 && object_id<= 7){
+#ifdef GOURAUD
+    {
         // Normal em coordenadas do mundo (para cálculo de iluminação)
         vec4 n = normalize(normal);
-        vec4 world_pos = model * model_coefficients;
+        vec4 world_pos = position_world;
 
         // Luz ambiente (iluminação base mesmo sem luz direta)
         vec3 Ia = vec3(0.10, 0.08, 0.05);
 
-        // Define coeficientes de material baseado no tipo de superfície
-        if(object_id == PLANE){
-            Kd = vec3(0.2,0.2,0.2);  // Chão mais escuro
-            Ka = vec3(0.1,0.1,0.1);
-        }
-        else{
-            Kd = vec3(0.3,0.3,0.3);  // Paredes mais claras
-            Ka = vec3(0.15,0.15,0.15);
-        }
+        // Coeficientes do material: o chão é mais escuro que paredes e teto
+        vec3 Kd = vec3(GOURAUD_KD);
+        vec3 Ka = vec3(GOURAUD_KA);
 
         // Acumula contribuição de todas as tochas (fontes de luz pontuais)
         vec3 diffuse = vec3(0.0);
         for(int i = 0; i < num_torches; i++)
         {
             // Vetor do vértice para a luz
-            vec3 to_light = torch_positions[i] - world_pos.xyz;
+            vec3 to_light = torch_positions[i].xyz - world_pos.xyz;
             float dist = length(to_light);
             vec3 l = to_light / dist;  // Direção normalizada
 
@@ -147,16 +208,15 @@ void main()
             // GOURAUD: Lambert diffuse calculado POR VÉRTICE
             // O resultado será interpolado pelo rasterizador
             float NdotL = max(dot(n.xyz, l), 0.0);
-            diffuse += torch_colors[i] * NdotL * torch_intensities[i] * attenuation;
+            diffuse += torch_colors[i].rgb * NdotL * torch_positions[i].w * attenuation;
         }
 
         // Cor final do vértice = ambiente + difusa (será interpolada)
         vertex_color = Ka * Ia + Kd * diffuse;
     }
-    else
-    {
-        vertex_color = vec3(1.0,1.0,1.0);
-    }
+#else
+    vertex_color = vec3(1.0,1.0,1.0);
+#endif
 
 }
 
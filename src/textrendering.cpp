@@ -1,6 +1,7 @@
 // Based on http://hamelot.io/visualization/opengl-text-without-any-external-libraries/
 //   and on https://github.com/rougier/freetype-gl
 #include <string>
+#include <vector>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -87,6 +88,19 @@ GLuint textVBO;
 GLuint textprogram_id;
 GLuint texttexture_id;
 
+// Glifo de cada codepoint, montado em TextRendering_Init. A fonte só tem os
+// caracteres ASCII imprimíveis: 256 entradas bastam
+texture_glyph_t* textglyphs[256];
+
+// Vértices (x, y, s, t) de todas as strings do quadro. PrintString só
+// acrescenta aqui; TextRendering_Flush envia tudo e desenha numa chamada
+std::vector<float> textvertices;
+size_t textVBOcapacity = 0;  // em floats
+
+// Tamanho da janela, lido na primeira string de cada quadro
+int textwindow_width = 1;
+int textwindow_height = 1;
+
 void TextRendering_Init()
 {
     GLuint sampler;
@@ -126,8 +140,10 @@ void TextRendering_Init()
 
     glBindVertexArray(textVAO);
 
+    // Cresce em TextRendering_Flush se o texto do quadro não couber
+    textVBOcapacity = 24 * 256;
     glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-    glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, textVBOcapacity * sizeof(float), NULL, GL_STREAM_DRAW);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
     glCheckError();
@@ -140,30 +156,32 @@ void TextRendering_Init()
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
     glCheckError();
+
+    for (size_t i = 0; i < 256; ++i)
+        textglyphs[i] = NULL;
+    for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
+    {
+        if (dejavufont.glyphs[j].codepoint < 256)
+            textglyphs[dejavufont.glyphs[j].codepoint] = &dejavufont.glyphs[j];
+    }
 }
 
 float textscale = 1.5f;
 
+// Não desenha: acrescenta os glifos ao texto do quadro (ver TextRendering_Flush)
 void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float x, float y, float scale = 1.0f)
 {
+    if (textvertices.empty())
+        glfwGetWindowSize(window, &textwindow_width, &textwindow_height);
+
     scale *= textscale;
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
-    float sx = scale / width;
-    float sy = scale / height;
+    float sx = scale / textwindow_width;
+    float sy = scale / textwindow_height;
 
     for (size_t i = 0; i < str.size(); i++)
     {
         // Find the glyph for the character we are looking for
-        texture_glyph_t *glyph = 0;
-        for (size_t j = 0; j < dejavufont.glyphs_count; ++j)
-        {
-            if (dejavufont.glyphs[j].codepoint == (uint32_t)str[i])
-            {
-                glyph = &dejavufont.glyphs[j];
-                break;
-            }
-        }
+        texture_glyph_t *glyph = textglyphs[(unsigned char)str[i]];
         if (!glyph) {
             continue;
         }
@@ -178,37 +196,53 @@ void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float
         float s1 = glyph->s1 - 0.5f/dejavufont.tex_width;
         float t1 = glyph->t1 - 0.5f/dejavufont.tex_height;
 
-        struct {float x, y, s, t;} data[6] = {
-            { x0, y0, s0, t0 },
-            { x0, y1, s0, t1 },
-            { x1, y1, s1, t1 },
-            { x0, y0, s0, t0 },
-            { x1, y1, s1, t1 },
-            { x1, y0, s1, t0 }
+        const float data[24] = {
+            x0, y0, s0, t0,
+            x0, y1, s0, t1,
+            x1, y1, s1, t1,
+            x0, y0, s0, t0,
+            x1, y1, s1, t1,
+            x1, y0, s1, t0
         };
+        textvertices.insert(textvertices.end(), data, data + 24);
+
+        x += (glyph->advance_x * sx);
+    }
+}
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+// Desenha todo o texto acumulado no quadro, por cima da cena, com um upload
+// e um glDrawArrays. Os glifos saem na ordem em que foram impressos
+void TextRendering_Flush()
+{
+    if (textvertices.empty())
+        return;
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDepthFunc(GL_ALWAYS);
-        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, 24 * sizeof(float), data);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+    while (textVBOcapacity < textvertices.size())
+        textVBOcapacity *= 2;
+    // "Orphaning": o driver não espera a GPU terminar o quadro anterior
+    glBufferData(GL_ARRAY_BUFFER, textVBOcapacity * sizeof(float), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, textvertices.size() * sizeof(float), textvertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        glUseProgram(textprogram_id);
-        glBindVertexArray(textVAO);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDepthFunc(GL_ALWAYS);
 
-        glBindVertexArray(0);
-        glUseProgram(0);
-        glDepthFunc(GL_LESS);
+    glUseProgram(textprogram_id);
+    glBindVertexArray(textVAO);
 
-        glDisable(GL_BLEND);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(textvertices.size() / 4));
 
-        x += (glyph->advance_x * sx);
-    }
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDepthFunc(GL_LESS);
+
+    glDisable(GL_BLEND);
+
+    textvertices.clear();
 }
 
 float TextRendering_LineHeight(GLFWwindow* window)